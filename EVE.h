@@ -43,6 +43,8 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 - removed macro RESTORE_CONTEXT() - use define DL_RESTORE_CONTEXT
 - removed macro RETURN() - use define DL_RETURN
 - removed macro SAVE_CONTEXT() - use define DL_SAVE_CONTEXT
+- added EVE_LIST_xxx() macros to build co-processor lists at compile time
+- added EVE_ANIM_ONCE, EVE_ANIM_LOOP and EVE_ANIM_HOLD
 
 */
 
@@ -604,6 +606,57 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 #define VERTEX_TRANSLATE_Y(y) ((44UL<<24U)|(((y)&131071UL)<<0U))
 
 
+/* Macros for static co-processor list generation */
+/* These fill a "const uint32_t list[]" at compile time that is sent with EVE_write_cmd_list(), for example:
+const uint32_t screen[] PROGMEM =
+{
+    CMD_DLSTART,
+    DL_CLEAR | CLR_COL | CLR_STN | CLR_TAG,
+    EVE_LIST_TEXT(10, 10, 28, 0), EVE_LIST_STRING_16("Hello there!"),
+    DL_DISPLAY,
+    CMD_SWAP
+};
+EVE_write_cmd_list(screen, sizeof(screen) / sizeof(screen[0]));
+*/
+#define EVE_LIST_PAIR(low,high) ((((uint32_t)(low))&65535UL)|((((uint32_t)(high))&65535UL)<<16U))
+
+/* four characters of a zero-padded string literal as one little-endian word */
+#define EVE_LIST_STRING_WORD(s,w) (((uint32_t)(uint8_t)(s)[((w)*4U)])|(((uint32_t)(uint8_t)(s)[((w)*4U)+1U])<<8U)|(((uint32_t)(uint8_t)(s)[((w)*4U)+2U])<<16U)|(((uint32_t)(uint8_t)(s)[((w)*4U)+3U])<<24U))
+
+/* fails to compile with a negative array size if the string plus its terminating zero does not need exactly "size" bytes */
+#define EVE_LIST_STRING_CHECK(s,size) (0UL*sizeof(char[((sizeof(s) > ((size)-4U)) && (sizeof(s) <= (size))) ? 1 : -1]))
+#define EVE_LIST_STRING_PAD "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"
+
+/* the parameter has to be a string literal, the number is the amount of bytes it uses in the list, including the */
+/* terminating zero and the padding, any other size than the one matching the string will not compile as EVE would */
+/* interpret surplus zero words as DL_DISPLAY, e.g. use EVE_LIST_STRING_8() for strings with 4 to 7 characters */
+#define EVE_LIST_STRING_4(s) (EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,0U)+EVE_LIST_STRING_CHECK(s,4U))
+#define EVE_LIST_STRING_8(s) (EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,0U)+EVE_LIST_STRING_CHECK(s,8U)), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,1U)
+#define EVE_LIST_STRING_12(s) (EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,0U)+EVE_LIST_STRING_CHECK(s,12U)), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,1U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,2U)
+#define EVE_LIST_STRING_16(s) (EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,0U)+EVE_LIST_STRING_CHECK(s,16U)), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,1U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,2U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,3U)
+#define EVE_LIST_STRING_20(s) (EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,0U)+EVE_LIST_STRING_CHECK(s,20U)), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,1U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,2U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,3U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,4U)
+#define EVE_LIST_STRING_24(s) (EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,0U)+EVE_LIST_STRING_CHECK(s,24U)), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,1U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,2U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,3U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,4U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,5U)
+#define EVE_LIST_STRING_28(s) (EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,0U)+EVE_LIST_STRING_CHECK(s,28U)), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,1U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,2U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,3U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,4U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,5U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,6U)
+#define EVE_LIST_STRING_32(s) (EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,0U)+EVE_LIST_STRING_CHECK(s,32U)), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,1U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,2U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,3U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,4U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,5U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,6U), EVE_LIST_STRING_WORD(s EVE_LIST_STRING_PAD,7U)
+
+/* co-processor commands, the ones with text need to be followed by one of the EVE_LIST_STRING_xx() macros */
+#define EVE_LIST_APPEND(ptr,num) CMD_APPEND, (uint32_t)(ptr), (uint32_t)(num)
+#define EVE_LIST_BGCOLOR(color) CMD_BGCOLOR, (uint32_t)(color)
+#define EVE_LIST_BUTTON(x,y,w,h,font,options) CMD_BUTTON, EVE_LIST_PAIR(x,y), EVE_LIST_PAIR(w,h), EVE_LIST_PAIR(font,options)
+#define EVE_LIST_FGCOLOR(color) CMD_FGCOLOR, (uint32_t)(color)
+#define EVE_LIST_GRADCOLOR(color) CMD_GRADCOLOR, (uint32_t)(color)
+#define EVE_LIST_GRADIENT(x0,y0,rgb0,x1,y1,rgb1) CMD_GRADIENT, EVE_LIST_PAIR(x0,y0), (uint32_t)(rgb0), EVE_LIST_PAIR(x1,y1), (uint32_t)(rgb1)
+#define EVE_LIST_NUMBER(x,y,font,options,number) CMD_NUMBER, EVE_LIST_PAIR(x,y), EVE_LIST_PAIR(font,options), (uint32_t)(number)
+#define EVE_LIST_ROMFONT(font,romslot) CMD_ROMFONT, (uint32_t)(font), (uint32_t)(romslot)
+#define EVE_LIST_ROTATE(angle) CMD_ROTATE, (uint32_t)(angle)
+#define EVE_LIST_SCALE(sx,sy) CMD_SCALE, (uint32_t)(sx), (uint32_t)(sy)
+#define EVE_LIST_SETBITMAP(addr,fmt,width,height) CMD_SETBITMAP, (uint32_t)(addr), EVE_LIST_PAIR(fmt,width), (uint32_t)(height)
+#define EVE_LIST_SETFONT2(font,ptr,firstchar) CMD_SETFONT2, (uint32_t)(font), (uint32_t)(ptr), (uint32_t)(firstchar)
+#define EVE_LIST_TEXT(x,y,font,options) CMD_TEXT, EVE_LIST_PAIR(x,y), EVE_LIST_PAIR(font,options)
+#define EVE_LIST_TOGGLE(x,y,w,font,options,state) CMD_TOGGLE, EVE_LIST_PAIR(x,y), EVE_LIST_PAIR(w,font), EVE_LIST_PAIR(options,state)
+#define EVE_LIST_TRANSLATE(tx,ty) CMD_TRANSLATE, (uint32_t)(tx), (uint32_t)(ty)
+
+
 /* EVE Generation 3: BT815 / BT816 definitions -----------------*/
 #if EVE_GEN > 2
 
@@ -637,6 +690,11 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 #define EVE_OPT_FORMAT 4096U
 #define EVE_OPT_FILL   8192U
 
+/* loop options for CMD_ANIMSTART */
+#define EVE_ANIM_ONCE 0UL
+#define EVE_ANIM_LOOP 1UL
+#define EVE_ANIM_HOLD 2UL
+
 
 /* Commands for BT815 / BT816 */
 #define CMD_BITMAP_TRANSFORM 0xFFFFFF21UL
@@ -0,0 +1,336 @@
+/*
+@file    EVE_anim.c
+@brief   animation channel manager for BT817 / BT818
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#include "EVE_anim.h"
+
+#if EVE_GEN > 3
+
+/* The manager keeps track of the 32 animation channels, EVE_anim_play() allocates a channel or puts the animation */
+/* into a queue sorted by priority. All co-processor commands are collected and sent once per frame by */
+/* EVE_anim_frame_burst() which also draws all active channels with a single CMD_ANIMDRAW(-1). */
+/* EVE_anim_update() reads REG_ANIM_ACTIVE once per frame to free the channels of animations that finished. */
+
+/* Sets up the manager, available is a mask of the channels it may use, 0xffffffff for all. */
+void EVE_anim_init(EVE_anim_manager_t *manager, uint32_t available)
+{
+    manager->queued = 0U;
+    manager->next_id = 1U;
+    manager->available = available;
+    manager->used = 0UL;
+    manager->start = 0UL;
+    manager->started = 0UL;
+    manager->stop = 0UL;
+    manager->move = 0UL;
+}
+
+static uint8_t eve_anim_free_channel(const EVE_anim_manager_t *manager)
+{
+    uint32_t free = manager->available & ~(manager->used | manager->stop);
+    uint8_t channel = 0U;
+
+    if (0UL == free)
+    {
+        return EVE_ANIM_CHANNELS;
+    }
+    while (0UL == (free & 1UL))
+    {
+        free >>= 1U;
+        channel++;
+    }
+    return channel;
+}
+
+static void eve_anim_assign(EVE_anim_manager_t *manager, uint8_t channel, const EVE_anim_slot_t *slot)
+{
+    uint32_t mask = 1UL << channel;
+
+    manager->channel[channel] = *slot;
+    manager->used |= mask;
+    manager->start |= mask;
+    manager->move &= ~mask;
+}
+
+/* insert into the queue behind the entries with the same or a higher priority */
+static uint8_t eve_anim_enqueue(EVE_anim_manager_t *manager, const EVE_anim_slot_t *slot)
+{
+    uint8_t index = manager->queued;
+
+    if (manager->queued >= EVE_ANIM_QUEUE_SIZE)
+    {
+        return E_NOT_OK;
+    }
+    while ((index > 0U) && (manager->queue[index - 1U].anim.priority < slot->anim.priority))
+    {
+        manager->queue[index] = manager->queue[index - 1U];
+        index--;
+    }
+    manager->queue[index] = *slot;
+    manager->queued++;
+    return E_OK;
+}
+
+static void eve_anim_dequeue(EVE_anim_manager_t *manager, uint8_t index)
+{
+    manager->queued--;
+    for (; index < manager->queued; index++)
+    {
+        manager->queue[index] = manager->queue[index + 1U];
+    }
+}
+
+/* the channel with the lowest priority, EVE_ANIM_CHANNELS if there is none */
+static uint8_t eve_anim_lowest(const EVE_anim_manager_t *manager)
+{
+    uint8_t lowest = EVE_ANIM_CHANNELS;
+
+    for (uint8_t channel = 0U; channel < EVE_ANIM_CHANNELS; channel++)
+    {
+        if (((manager->used & ~manager->stop) & (1UL << channel)) != 0UL)
+        {
+            if ((EVE_ANIM_CHANNELS == lowest) ||
+                (manager->channel[channel].anim.priority < manager->channel[lowest].anim.priority))
+            {
+                lowest = channel;
+            }
+        }
+    }
+    return lowest;
+}
+
+/* Starts an animation with the next frame, when all channels are in use an animation with a lower priority is */
+/* stopped and put back into the queue, otherwise the new animation waits in the queue. */
+/* Returns an id for EVE_anim_stop() and EVE_anim_move() or EVE_ANIM_INVALID if the queue is full. */
+uint16_t EVE_anim_play(EVE_anim_manager_t *manager, const EVE_anim_t *anim)
+{
+    EVE_anim_slot_t slot;
+    uint8_t channel = eve_anim_free_channel(manager);
+
+    slot.anim = *anim;
+    slot.id = manager->next_id;
+
+    if (EVE_ANIM_CHANNELS == channel)
+    {
+        uint8_t lowest = eve_anim_lowest(manager);
+
+        if ((lowest < EVE_ANIM_CHANNELS) && (manager->channel[lowest].anim.priority < anim->priority) &&
+            (E_OK == eve_anim_enqueue(manager, &manager->channel[lowest])))
+        {
+            manager->stop |= 1UL << lowest;
+            manager->start &= ~(1UL << lowest);
+            manager->used &= ~(1UL << lowest);
+            channel = lowest;
+        }
+        else if (eve_anim_enqueue(manager, &slot) != E_OK)
+        {
+            return EVE_ANIM_INVALID;
+        }
+        else
+        {
+            /* waits for a free channel */
+        }
+    }
+    if (channel < EVE_ANIM_CHANNELS)
+    {
+        eve_anim_assign(manager, channel, &slot);
+    }
+
+    manager->next_id++;
+    if (EVE_ANIM_INVALID == manager->next_id)
+    {
+        manager->next_id = 1U;
+    }
+    return slot.id;
+}
+
+static uint8_t eve_anim_find(const EVE_anim_manager_t *manager, uint16_t id)
+{
+    uint8_t channel;
+
+    for (channel = 0U; channel < EVE_ANIM_CHANNELS; channel++)
+    {
+        if (((manager->used & (1UL << channel)) != 0UL) && (manager->channel[channel].id == id))
+        {
+            break;
+        }
+    }
+    return channel;
+}
+
+/* Stops an animation with the next frame or removes it from the queue. */
+void EVE_anim_stop(EVE_anim_manager_t *manager, uint16_t id)
+{
+    uint8_t channel = eve_anim_find(manager, id);
+
+    if (channel < EVE_ANIM_CHANNELS)
+    {
+        uint32_t mask = 1UL << channel;
+
+        if ((manager->start & mask) != 0UL)
+        {
+            manager->start &= ~mask; /* it was never started */
+        }
+        else
+        {
+            manager->stop |= mask;
+        }
+        manager->used &= ~mask;
+        manager->move &= ~mask;
+        return;
+    }
+    for (uint8_t index = 0U; index < manager->queued; index++)
+    {
+        if (manager->queue[index].id == id)
+        {
+            eve_anim_dequeue(manager, index);
+            break;
+        }
+    }
+}
+
+/* Moves an animation with CMD_ANIMXY in the next frame. */
+void EVE_anim_move(EVE_anim_manager_t *manager, uint16_t id, int16_t x, int16_t y)
+{
+    uint8_t channel = eve_anim_find(manager, id);
+
+    if (channel < EVE_ANIM_CHANNELS)
+    {
+        manager->channel[channel].anim.x = x;
+        manager->channel[channel].anim.y = y;
+        if (0UL == (manager->start & (1UL << channel)))
+        {
+            manager->move |= 1UL << channel;
+        }
+        return;
+    }
+    for (uint8_t index = 0U; index < manager->queued; index++)
+    {
+        if (manager->queue[index].id == id)
+        {
+            manager->queue[index].anim.x = x;
+            manager->queue[index].anim.y = y;
+            break;
+        }
+    }
+}
+
+/* Returns 1 while the animation is queued or playing. */
+uint8_t EVE_anim_is_playing(const EVE_anim_manager_t *manager, uint16_t id)
+{
+    if (eve_anim_find(manager, id) < EVE_ANIM_CHANNELS)
+    {
+        return 1U;
+    }
+    for (uint8_t index = 0U; index < manager->queued; index++)
+    {
+        if (manager->queue[index].id == id)
+        {
+            return 1U;
+        }
+    }
+    return 0U;
+}
+
+/* This is meant to be called outside display-list building, once per frame before the display list is built. */
+/* Frees the channels of finished animations with a single read of REG_ANIM_ACTIVE and starts queued animations. */
+void EVE_anim_update(EVE_anim_manager_t *manager)
+{
+    uint32_t candidates = manager->used & ~(manager->start | manager->started | manager->stop);
+
+    if (candidates != 0UL)
+    {
+        uint32_t finished = candidates & ~EVE_memRead32(REG_ANIM_ACTIVE);
+
+        manager->used &= ~finished;
+        manager->move &= ~finished;
+    }
+    manager->started = 0UL;
+
+    while (manager->queued > 0U)
+    {
+        uint8_t channel = eve_anim_free_channel(manager);
+
+        if (EVE_ANIM_CHANNELS == channel)
+        {
+            break;
+        }
+        eve_anim_assign(manager, channel, &manager->queue[0U]);
+        eve_anim_dequeue(manager, 0U);
+    }
+}
+
+/* To be used between EVE_start_cmd_burst() and EVE_end_cmd_burst(), at the place in the display list the */
+/* animations are to be drawn. Sends the collected stop, start and move commands and draws all channels at once. */
+void EVE_anim_frame_burst(EVE_anim_manager_t *manager)
+{
+    for (uint8_t channel = 0U; channel < EVE_ANIM_CHANNELS; channel++)
+    {
+        uint32_t mask = 1UL << channel;
+        const EVE_anim_t *anim = &manager->channel[channel].anim;
+
+        if (0UL == ((manager->stop | manager->start | manager->move) & mask))
+        {
+            continue;
+        }
+        if ((manager->stop & mask) != 0UL)
+        {
+            EVE_cmd_animstop_burst((int32_t) channel);
+        }
+        if ((manager->start & mask) != 0UL)
+        {
+            if (anim->ram != 0U)
+            {
+                EVE_cmd_animstartram_burst((int32_t) channel, anim->aoptr, anim->loop);
+            }
+            else
+            {
+                EVE_cmd_animstart_burst((int32_t) channel, anim->aoptr, anim->loop);
+            }
+        }
+        if (((manager->start | manager->move) & mask) != 0UL)
+        {
+            EVE_cmd_animxy_burst((int32_t) channel, anim->x, anim->y);
+        }
+    }
+    manager->started |= manager->start;
+    manager->start = 0UL;
+    manager->stop = 0UL;
+    manager->move = 0UL;
+
+    if (manager->used != 0UL)
+    {
+        EVE_cmd_animdraw_burst(-1L);
+    }
+}
+
+#endif /* EVE_GEN > 3 */
@@ -0,0 +1,92 @@
+/*
+@file    EVE_anim.h
+@brief   contains the prototypes for the animation channel manager for BT817 / BT818
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#ifndef EVE_ANIM_H
+#define EVE_ANIM_H
+
+#pragma once
+
+#include "EVE.h"
+
+#if EVE_GEN > 3
+
+#define EVE_ANIM_CHANNELS 32U
+
+/* number of animations that can wait for a free channel */
+#if !defined (EVE_ANIM_QUEUE_SIZE)
+#define EVE_ANIM_QUEUE_SIZE 16U
+#endif
+
+#define EVE_ANIM_INVALID 0U /* returned by EVE_anim_play() if the animation was not accepted */
+
+typedef struct
+{
+    uint32_t aoptr;   /* address of the animation object in the flash, or in RAM_G with ram = 1 */
+    uint32_t loop;    /* EVE_ANIM_ONCE, EVE_ANIM_LOOP or EVE_ANIM_HOLD */
+    int16_t x;
+    int16_t y;
+    uint8_t priority; /* higher values replace lower values when all channels are in use */
+    uint8_t ram;      /* 1 for CMD_ANIMSTARTRAM */
+} EVE_anim_t;
+
+typedef struct
+{
+    EVE_anim_t anim;
+    uint16_t id;
+} EVE_anim_slot_t;
+
+typedef struct
+{
+    EVE_anim_slot_t channel[EVE_ANIM_CHANNELS];
+    EVE_anim_slot_t queue[EVE_ANIM_QUEUE_SIZE]; /* sorted by priority, highest first */
+    uint8_t queued;
+    uint16_t next_id;
+    uint32_t available; /* channels the manager may use */
+    uint32_t used;      /* channels with an animation */
+    uint32_t start;     /* channels that need CMD_ANIMSTART with the next frame */
+    uint32_t started;   /* channels that were started with the last frame and may not show in REG_ANIM_ACTIVE yet */
+    uint32_t stop;      /* channels that need CMD_ANIMSTOP with the next frame */
+    uint32_t move;      /* channels that need CMD_ANIMXY with the next frame */
+} EVE_anim_manager_t;
+
+void EVE_anim_init(EVE_anim_manager_t *manager, uint32_t available);
+uint16_t EVE_anim_play(EVE_anim_manager_t *manager, const EVE_anim_t *anim);
+void EVE_anim_stop(EVE_anim_manager_t *manager, uint16_t id);
+void EVE_anim_move(EVE_anim_manager_t *manager, uint16_t id, int16_t x, int16_t y);
+uint8_t EVE_anim_is_playing(const EVE_anim_manager_t *manager, uint16_t id);
+void EVE_anim_update(EVE_anim_manager_t *manager);
+void EVE_anim_frame_burst(EVE_anim_manager_t *manager);
+
+#endif /* EVE_GEN > 3 */
+
+#endif /* EVE_ANIM_H */
@@ -116,11 +116,94 @@ without the traling _burst in the name when exceution speed is not an issue - e.
 - modified EVE_calibrate_manual() to work better with bar type displays
 - fixed a large number of MISRA-C issues - mostly more casts for explicit type conversion and more brackets
 - changed the varargs versions of cmd_button, cmd_text and cmd_toggle to use an array of uint32_t values to comply with MISRA-C
+- added EVE_write_cmd_list() and EVE_write_cmd_list_burst() to send co-processor lists that were built at compile time
+- the safeguard in EVE_start_cmd_burst() is skipped for targets that queue DMA transfers with EVE_DMA_QUEUE defined
+- EVE_memWrite_flash_buffer(), EVE_memWrite_sram_buffer() and private_block_write() use spi_transmit_bulk() for targets
+that define EVE_SPI_BULK
+- added EVE_set_font_maps(), private_string_write() translates UTF-8 strings for fonts with a font map
+- added the optional SPI transaction recorder of EVE_trace.c, enabled with EVE_TRACE
+- added the optional counters of EVE_stats, enabled with EVE_STATS
+- EVE_busy() captures EVE_RAM_ERR_REPORT, the co-processor pointers and the last commands for a hook set with
+EVE_set_fault_hook() before the recovery and sends a list set with EVE_set_fault_restore() after it
+- added the optional timeline events of EVE_events.c for bursts, DMA, waits, block transfers and swaps, enabled with
+EVE_EVENTS
 
 */
 
 #include "EVE.h"
 
+#if defined (EVE_TRACE)
+/* route all SPI transactions of this file thru the recorder in EVE_trace.c */
+#include "EVE_trace.h"
+#define EVE_cs_set() EVE_trace_cs_set()
+#define EVE_cs_clear() EVE_trace_cs_clear()
+#define spi_transmit(data) EVE_trace_spi_transmit(data)
+#define spi_transmit_32(data) EVE_trace_spi_transmit_32(data)
+#define spi_transmit_burst(data) EVE_trace_spi_transmit_burst(data)
+#define spi_receive(data) EVE_trace_spi_receive(data)
+#if defined (EVE_SPI_BULK)
+#define spi_transmit_bulk(data, length) EVE_trace_spi_transmit_bulk((data), (length))
+#endif
+#endif
+
+#if defined (EVE_STATS)
+volatile EVE_stats_t EVE_stats;
+
+static inline void eve_stats_cs_set(void)
+{
+    EVE_stats.transactions++;
+    EVE_cs_set();
+}
+
+/* spi_transmit_burst() is called once for every 32 bit word of a cmd-burst, with and without DMA */
+static inline void eve_stats_transmit_burst(uint32_t data)
+{
+    EVE_stats.bytes_burst += 4UL;
+    spi_transmit_burst(data);
+}
+
+#undef EVE_cs_set
+#define EVE_cs_set() eve_stats_cs_set()
+#undef spi_transmit_burst
+#define spi_transmit_burst(data) eve_stats_transmit_burst(data)
+#define EVE_STATS_ADD(counter, value) (EVE_stats.counter += (value))
+
+/* Copies the counters, lock-free: the library is the only writer so the copy is repeated until two copies match, */
+/* this also works on 8 bit targets that can not read 32 bits at once. */
+void EVE_stats_read(EVE_stats_t *copy)
+{
+    const volatile uint32_t *source = (const volatile uint32_t *) &EVE_stats;
+    uint32_t *target = (uint32_t *) copy;
+    uint8_t stable;
+
+    do
+    {
+        stable = 1U;
+        for (uint8_t index = 0U; index < (sizeof(EVE_stats_t) / 4U); index++)
+        {
+            target[index] = source[index];
+        }
+        for (uint8_t index = 0U; index < (sizeof(EVE_stats_t) / 4U); index++)
+        {
+            if (target[index] != source[index])
+            {
+                stable = 0U;
+            }
+        }
+    } while (0U == stable);
+}
+#else
+#define EVE_STATS_ADD(counter, value)
+#endif
+
+#if defined (EVE_EVENTS)
+/* the timeline of the bus and the co-processor in EVE_events.c */
+#include "EVE_events.h"
+#define EVE_EVENT(type, argument) EVE_event((type), (argument))
+#else
+#define EVE_EVENT(type, argument)
+#endif
+
 /* EVE Memory Commands - used with EVE_memWritexx and EVE_memReadxx */
 #define MEM_WRITE 0x80U /* EVE Host Memory Write */
 #define MEM_READ 0x00U  /* EVE Host Memory Read */
@@ -132,6 +215,12 @@ without the traling _burst in the name when exceution speed is not an issue - e.
 
 static volatile uint8_t cmd_burst = 0U; /* flag to indicate cmd-burst is active */
 
+static EVE_fault_hook_t eve_fault_hook = NULL;
+static EVE_fault_t *eve_fault_buffer = NULL;
+static const uint32_t *eve_fault_list = NULL;
+static uint32_t eve_fault_list_num = 0U;
+static uint8_t eve_fault_restoring = 0U;
+
 /*----------------------------------------------------------------------------------------------------------------------------*/
 /*---- helper functions
  * ------------------------------------------------------------------------------------------------------*/
@@ -188,6 +277,7 @@ void EVE_memWrite8(uint32_t ftAddress, uint8_t ftData8)
     spi_transmit((uint8_t)(ftAddress & 0x000000ffUL));
     spi_transmit(ftData8);
     EVE_cs_clear();
+    EVE_STATS_ADD(bytes_write, 4UL);
 }
 
 void EVE_memWrite16(uint32_t ftAddress, uint16_t ftData16)
@@ -199,6 +289,7 @@ void EVE_memWrite16(uint32_t ftAddress, uint16_t ftData16)
     spi_transmit((uint8_t)(ftData16 & 0x00ffU));           /* send data low byte */
     spi_transmit((uint8_t)(ftData16 >> 8U));               /* send data high byte */
     EVE_cs_clear();
+    EVE_STATS_ADD(bytes_write, 5UL);
 }
 
 void EVE_memWrite32(uint32_t ftAddress, uint32_t ftData32)
@@ -209,6 +300,7 @@ void EVE_memWrite32(uint32_t ftAddress, uint32_t ftData32)
     spi_transmit((uint8_t)(ftAddress & 0x000000ffUL));     /* send low address byte */
     spi_transmit_32(ftData32);
     EVE_cs_clear();
+    EVE_STATS_ADD(bytes_write, 7UL);
 }
 
 /* Helper function, write a block of memory from the FLASH of the host controller to EVE. */
@@ -221,12 +313,17 @@ void EVE_memWrite_flash_buffer(uint32_t ftAddress, const uint8_t *data, uint32_t
 
     uint32_t length = (len + 3U) & (~3U);
 
+#if defined (EVE_SPI_BULK)
+    spi_transmit_bulk(data, length);
+#else
     for (uint32_t count = 0U; count < length; count++)
     {
         spi_transmit(fetch_flash_byte(&data[count]));
     }
+#endif
 
     EVE_cs_clear();
+    EVE_STATS_ADD(bytes_write, length + 3UL);
 }
 
 /* Helper function, write a block of memory from the SRAM of the host controller to EVE. */
@@ -239,12 +336,71 @@ void EVE_memWrite_sram_buffer(uint32_t ftAddress, const uint8_t *data, uint32_t
 
     uint32_t length = (len + 3U) & (~3U);
 
+#if defined (EVE_SPI_BULK)
+    spi_transmit_bulk(data, length);
+#else
     for (uint32_t count = 0U; count < length; count++)
     {
         spi_transmit(data[count]);
     }
+#endif
 
     EVE_cs_clear();
+    EVE_STATS_ADD(bytes_write, length + 3UL);
+}
+
+/* Sets a function that EVE_busy() calls with what it found when the co-processor had a fault, before the recovery. */
+/* The buffer needs to stay valid, the hook can read more from EVE but must not send commands. NULL disables it. */
+void EVE_set_fault_hook(EVE_fault_hook_t hook, EVE_fault_t *buffer)
+{
+    eve_fault_hook = (NULL == buffer) ? NULL : hook;
+    eve_fault_buffer = buffer;
+}
+
+/* Sets a list of co-processor commands that EVE_busy() sends after the recovery from a fault, */
+/* for example CMD_SETFONT2, CMD_ROMFONT or CMD_SETROTATE, the state of the co-processor that the reset cleared. */
+/* The list needs to stay valid, it is sent with EVE_write_cmd_list(). NULL disables it. */
+void EVE_set_fault_restore(const uint32_t *list, uint32_t num)
+{
+    eve_fault_list = list;
+    eve_fault_list_num = (NULL == list) ? 0U : num;
+}
+
+static void eve_fault_capture(EVE_fault_t *fault)
+{
+    uint16_t offset;
+
+#if EVE_GEN > 2
+    for (uint8_t index = 0U; index < (sizeof(fault->report) - 1U); index += 4U)
+    {
+        uint32_t data = EVE_memRead32(EVE_RAM_ERR_REPORT + index);
+
+        fault->report[index] = (char) data;
+        fault->report[index + 1U] = (char) (data >> 8U);
+        fault->report[index + 2U] = (char) (data >> 16U);
+        fault->report[index + 3U] = (char) (data >> 24U);
+    }
+#else
+    fault->report[0] = '\0';
+#endif
+    fault->report[sizeof(fault->report) - 1U] = '\0';
+
+    fault->cmd_read = EVE_memRead16(REG_CMD_READ);
+    fault->cmd_write = EVE_memRead16(REG_CMD_WRITE);
+    fault->cmd_dl = EVE_memRead16(REG_CMD_DL);
+    fault->window_start = (fault->cmd_write - EVE_FAULT_WINDOW) & 0xffcU;
+
+    offset = fault->window_start;
+    for (uint16_t index = 0U; index < EVE_FAULT_WINDOW; index += 4U)
+    {
+        uint32_t data = EVE_memRead32(EVE_RAM_CMD + offset);
+
+        fault->window[index] = (uint8_t) data;
+        fault->window[index + 1U] = (uint8_t) (data >> 8U);
+        fault->window[index + 2U] = (uint8_t) (data >> 16U);
+        fault->window[index + 3U] = (uint8_t) (data >> 24U);
+        offset = (offset + 4U) & 0xfffU;
+    }
 }
 
 /* Check if the co-processor completed executing the current command list. */
@@ -274,12 +430,24 @@ uint8_t EVE_busy(void)
         copro_patch_pointer = EVE_memRead16(REG_COPRO_PATCH_DTR);
 #endif
 
+        EVE_EVENT(EVE_EVENT_FAULT, space);
+        if (eve_fault_hook != NULL)
+        {
+            eve_fault_capture(eve_fault_buffer);
+            eve_fault_hook(eve_fault_buffer);
+        }
+
         EVE_memWrite8(REG_CPURESET, 1U);   /* hold co-processor engine in the reset condition */
         EVE_memWrite16(REG_CMD_READ, 0U);  /* set REG_CMD_READ to 0 */
         EVE_memWrite16(REG_CMD_WRITE, 0U); /* set REG_CMD_WRITE to 0 */
         EVE_memWrite32(REG_CMD_DL, 0U); /* reset REG_CMD_DL to 0 as required by the BT81x programming guide, should not hurt FT8xx */
         EVE_memWrite8(REG_CPURESET, 0U); /* set REG_CMD_WRITE to 0 to restart the co-processor engine*/
 
+#if defined (EVE_STATS)
+        EVE_stats.fault_resets++;
+        EVE_stats.fault_swaps = EVE_stats.swaps;
+#endif
+
 #if EVE_GEN > 2
 
         EVE_memWrite16(REG_COPRO_PATCH_DTR, copro_patch_pointer);
@@ -298,10 +466,19 @@ uint8_t EVE_busy(void)
         DELAY_MS(5U);                      /* just to be safe */
 
 #endif
+
+        /* not again if the list itself fails */
+        if ((eve_fault_list != NULL) && (0U == eve_fault_restoring))
+        {
+            eve_fault_restoring = 1U;
+            EVE_write_cmd_list(eve_fault_list, eve_fault_list_num);
+            eve_fault_restoring = 0U;
+        }
     }
 
     if (0xffcU == space)
     {
+        EVE_EVENT(EVE_EVENT_IDLE, 0UL);
         return E_OK;
     }
     if (space > 0x800U)
@@ -314,9 +491,28 @@ uint8_t EVE_busy(void)
 /* Wait for the co-processor to complete the FIFO queue.*/
 void EVE_execute_cmd(void)
 {
+#if defined (EVE_STATS)
+    uint32_t polls = 1UL;
+
+    EVE_EVENT(EVE_EVENT_WAIT_BEGIN, 0UL);
+    while (EVE_busy() != E_OK)
+    {
+        polls++;
+    }
+    EVE_stats.executes++;
+    EVE_stats.busy_polls += polls;
+    if (polls > EVE_stats.busy_polls_max)
+    {
+        EVE_stats.busy_polls_max = polls;
+    }
+    EVE_EVENT(EVE_EVENT_WAIT_END, polls);
+#else
+    EVE_EVENT(EVE_EVENT_WAIT_BEGIN, 0UL);
     while (EVE_busy() != E_OK)
     {
     }
+    EVE_EVENT(EVE_EVENT_WAIT_END, 0UL);
+#endif
 }
 
 /* Begin a co-processor command, this is used for non-display-list and non-burst-mode commands.*/
@@ -339,10 +535,14 @@ void private_block_write(const uint8_t *data, uint16_t len)
     padding = 4U - padding;         /* 4, 3, 2 or 1 */
     padding &= 3U;                  /* 3, 2 or 1 */
 
+#if defined (EVE_SPI_BULK)
+    spi_transmit_bulk(data, len);
+#else
     for (uint16_t count = 0U; count < len; count++)
     {
         spi_transmit(fetch_flash_byte(&data[count]));
     }
+#endif
 
     while (padding > 0U)
     {
@@ -364,12 +564,15 @@ void block_transfer(const uint8_t *data, uint32_t len)
 
         block_len = (bytes_left > 3840UL) ? 3840UL : bytes_left;
 
+        EVE_EVENT(EVE_EVENT_BLOCK_BEGIN, block_len);
         EVE_cs_set();
         spi_transmit((uint8_t) 0xB0U); /* high-byte of REG_CMDB_WRITE + MEM_WRITE */
         spi_transmit((uint8_t) 0x25U); /* middle-byte of REG_CMDB_WRITE */
         spi_transmit((uint8_t) 0x78U); /* low-byte of REG_CMDB_WRITE */
         private_block_write(data, (uint16_t) block_len);
         EVE_cs_clear();
+        EVE_STATS_ADD(bytes_block, ((block_len + 3UL) & (~3UL)) + 3UL);
+        EVE_EVENT(EVE_EVENT_BLOCK_END, block_len);
         data = &data[block_len];
         bytes_left -= block_len;
         EVE_execute_cmd();
@@ -1330,7 +1533,7 @@ uint8_t EVE_init(void)
 /* Be careful to not use any functions in the sequence that do not address the command-fifo as for example any of EVE_mem...() functions. */
 void EVE_start_cmd_burst(void)
 {
-#if defined(EVE_DMA)
+#if defined(EVE_DMA) && !defined(EVE_DMA_QUEUE)
     if (EVE_dma_busy)
     {
         EVE_execute_cmd(); /* this is a safe-guard to protect segmented display-list building with DMA from overlapping */
@@ -1338,12 +1541,20 @@ void EVE_start_cmd_burst(void)
 #endif
 
     cmd_burst = 42U;
+    EVE_STATS_ADD(bytes_burst, 3UL); /* the address of REG_CMDB_WRITE */
+    EVE_EVENT(EVE_EVENT_BURST_BEGIN, 0UL);
 
 #if defined(EVE_DMA)
     EVE_dma_buffer[0U] = 0x7825B000UL; /* REG_CMDB_WRITE + MEM_WRITE low mid hi 00 */
 //    ((uint8_t)(ftAddress >> 16U) | MEM_WRITE) | (ftAddress & 0x0000ff00UL) | ((uint8_t)(ftAddress) << 16U);
 //    EVE_dma_buffer[0U] = EVE_dma_buffer[0U] << 8U;
     EVE_dma_buffer_index = 1U;
+#if defined (EVE_TRACE)
+    EVE_trace_begin();
+    EVE_trace_byte(0xB0U);
+    EVE_trace_byte(0x25U);
+    EVE_trace_byte(0x78U);
+#endif
 #else
     EVE_cs_set();
     spi_transmit((uint8_t) 0xB0U); /* high-byte of REG_CMDB_WRITE + MEM_WRITE */
@@ -1359,12 +1570,104 @@ void EVE_end_cmd_burst(void)
     cmd_burst = 0U;
 
 #if defined(EVE_DMA)
+#if defined (EVE_TRACE)
+    EVE_trace_end();
+#endif
+    EVE_STATS_ADD(dma_transfers, 1UL);
+    EVE_EVENT(EVE_EVENT_BURST_END, 0UL);
+    EVE_EVENT(EVE_EVENT_DMA_START, ((uint32_t) EVE_dma_buffer_index * 4UL) - 1UL);
     EVE_start_dma_transfer(); /* begin DMA transfer */
 #else
     EVE_cs_clear();
+    EVE_EVENT(EVE_EVENT_BURST_END, 0UL);
 #endif
 }
 
+/* private function, read one word of a static co-processor list, byte-wise to also work for lists in AVR PROGMEM */
+static uint32_t private_list_word(const uint32_t *list, uint32_t index)
+{
+    const uint8_t *bytes = (const uint8_t *) &list[index];
+    uint32_t word;
+
+    word = (uint32_t) fetch_flash_byte(&bytes[0U]);
+    word |= ((uint32_t) fetch_flash_byte(&bytes[1U])) << 8U;
+    word |= ((uint32_t) fetch_flash_byte(&bytes[2U])) << 16U;
+    word |= ((uint32_t) fetch_flash_byte(&bytes[3U])) << 24U;
+    return word;
+}
+
+/* Send a co-processor list that was built at compile time with the EVE_LIST_xxx() macros from EVE.h. */
+/* "num" is the number of 32 bit words in the list, for example: sizeof(list) / sizeof(list[0]) */
+/* Outside of a burst the list is written in chunks as large as REG_CMDB_SPACE allows, so it can be longer than 4k. */
+/* With DMA a list that fits into the command-FIFO is sent with a single DMA transfer. */
+void EVE_write_cmd_list(const uint32_t *list, uint32_t num)
+{
+    if (list != NULL)
+    {
+        if (0U == cmd_burst)
+        {
+#if defined(EVE_DMA)
+            if (num < (EVE_CMDFIFO_SIZE / 4U))
+            {
+                EVE_execute_cmd(); /* make sure the FIFO is empty and no DMA is still running */
+                EVE_start_cmd_burst();
+                EVE_write_cmd_list_burst(list, num);
+                EVE_end_cmd_burst();
+                return;
+            }
+#endif
+            uint32_t index = 0U;
+
+            while (index < num)
+            {
+                uint16_t space = EVE_memRead16(REG_CMDB_SPACE);
+
+                if ((space & 3U) != 0U)
+                {
+                    (void) EVE_busy(); /* we have a co-processor fault, let EVE_busy() do the recovery */
+                }
+                else
+                {
+                    uint32_t words = ((uint32_t) space) >> 2U;
+
+                    if (words > (num - index))
+                    {
+                        words = num - index;
+                    }
+
+                    if (words > 0U)
+                    {
+                        EVE_cs_set();
+                        spi_transmit((uint8_t) 0xB0U); /* high-byte of REG_CMDB_WRITE + MEM_WRITE */
+                        spi_transmit((uint8_t) 0x25U); /* middle-byte of REG_CMDB_WRITE */
+                        spi_transmit((uint8_t) 0x78U); /* low-byte of REG_CMDB_WRITE */
+                        for (uint32_t count = 0U; count < words; count++)
+                        {
+                            spi_transmit_32(private_list_word(list, index));
+                            index++;
+                        }
+                        EVE_cs_clear();
+                    }
+                }
+            }
+        }
+        else
+        {
+            EVE_write_cmd_list_burst(list, num);
+        }
+    }
+}
+
+/* Burst version of EVE_write_cmd_list(), the list is appended to the current burst and to the DMA buffer if applicable. */
+/* Beware, there is no check for the 4k limit of the command-FIFO or the size of the DMA buffer. */
+void EVE_write_cmd_list_burst(const uint32_t *list, uint32_t num)
+{
+    for (uint32_t index = 0U; index < num; index++)
+    {
+        spi_transmit_burst(private_list_word(list, index));
+    }
+}
+
 #if 0
 /* private function, begin a co-processor command, only used for non-burst commands */
 static void EVE_start_command(uint32_t command)
@@ -1377,28 +1680,123 @@ static void EVE_start_command(uint32_t command)
 }
 #endif
 
+static const EVE_font_map_t *eve_font_maps = NULL;
+static uint8_t eve_font_map_count = 0U;
+
+/* Sets the font maps for subsetted fonts, these are generated by tools/eve_asset. */
+/* Strings for a font with a map are translated from UTF-8 to the glyphs of the font by private_string_write(). */
+/* The array needs to stay valid, NULL or a count of 0 disables the translation. */
+void EVE_set_font_maps(const EVE_font_map_t *maps, uint8_t count)
+{
+    eve_font_maps = maps;
+    eve_font_map_count = (NULL == maps) ? 0U : count;
+}
+
+static const EVE_font_map_t *eve_find_font_map(int16_t font)
+{
+    const EVE_font_map_t *map = NULL;
+
+    for (uint8_t index = 0U; index < eve_font_map_count; index++)
+    {
+        if (font == (int16_t) eve_font_maps[index].font)
+        {
+            map = &eve_font_maps[index];
+            break;
+        }
+    }
+    return map;
+}
+
+/* returns the next byte to send for a string and advances textindex past the UTF-8 sequence */
+/* ASCII is sent as is, other code points are looked up in the sorted table of the font map */
+static uint8_t eve_string_byte(const uint8_t *bytes, uint8_t *textindex, const EVE_font_map_t *map)
+{
+    uint8_t data = bytes[*textindex];
+    uint32_t codepoint;
+    uint8_t length;
+    uint16_t low = 0U;
+    uint16_t high;
+
+    (*textindex)++;
+    if ((NULL == map) || (data < 0x80U))
+    {
+        return data;
+    }
+
+    if ((data & 0xe0U) == 0xc0U)
+    {
+        codepoint = (uint32_t) data & 0x1fUL;
+        length = 1U;
+    }
+    else if ((data & 0xf0U) == 0xe0U)
+    {
+        codepoint = (uint32_t) data & 0x0fUL;
+        length = 2U;
+    }
+    else if ((data & 0xf8U) == 0xf0U)
+    {
+        codepoint = (uint32_t) data & 0x07UL;
+        length = 3U;
+    }
+    else
+    {
+        return map->fallback;
+    }
+
+    while (length > 0U)
+    {
+        data = bytes[*textindex];
+        if ((data & 0xc0U) != 0x80U)
+        {
+            return map->fallback; /* broken sequence, this also stops at the terminating zero */
+        }
+        codepoint = (codepoint << 6U) | ((uint32_t) data & 0x3fUL);
+        (*textindex)++;
+        length--;
+    }
+
+    high = map->count;
+    while (low < high)
+    {
+        uint16_t middle = low + ((high - low) / 2U);
+
+        if (map->codepoints[middle] < codepoint)
+        {
+            low = middle + 1U;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return ((low < map->count) && (map->codepoints[low] == codepoint)) ? map->glyphs[low] : map->fallback;
+}
+
 /* write a string to co-processor memory in context of a command: */
 /* no chip-select, just plain SPI-transfers */
-static void private_string_write(const char *text)
+/* the string is translated with the font map for the font if there is one, see EVE_set_font_maps() */
+static void private_string_write(int16_t font, const char *text)
 {
     /* treat the array as bunch of bytes */
     const uint8_t *bytes = (const uint8_t *)text;
+    const EVE_font_map_t *map = eve_find_font_map(font);
 
     if (0U == cmd_burst)
     {
         uint8_t textindex = 0U;
+        uint8_t length = 0U;
         uint8_t padding = 0U;
 
         /* either leave on Zero or when the string is too long */
         while ((textindex < 249U) && (bytes[textindex] != 0U))
         {
-            spi_transmit(bytes[textindex]);
-            textindex++;
+            spi_transmit(eve_string_byte(bytes, &textindex, map));
+            length++;
         }
 
         /* transmit at least one 0x00 byte */
         /* and up to four if the string happens to be 4-byte aligned already */
-        padding = textindex & 3U; /* 0, 1, 2 or 3 */
+        padding = length & 3U; /* 0, 1, 2 or 3 */
         padding = 4U - padding;   /* 4, 3, 2 or 1 */
 
         while (padding > 0U)
@@ -1412,13 +1810,11 @@ static void private_string_write(const char *text)
         uint8_t textindex = 0U;
         uint32_t calc = 0U;
         uint8_t byteindex = 0U;
-        uint8_t data;
 
-        do
+        /* either leave on Zero or when the string is too long */
+        while ((textindex < 249U) && (bytes[textindex] != 0U))
         {
-            data = bytes[textindex];
-            textindex++;
-            calc += (uint32_t)(data) << (8U * byteindex);
+            calc += (uint32_t) eve_string_byte(bytes, &textindex, map) << (8U * byteindex);
             byteindex++;
             if (byteindex > 3U)
             {
@@ -1427,12 +1823,9 @@ static void private_string_write(const char *text)
                 byteindex = 0U;
             }
         }
-        while ((textindex < 249U) && (data != 0U));
 
-        if (byteindex > 0U)
-        {
-            spi_transmit_burst(calc);
-        }
+        /* the last word has the rest of the string and at least one 0x00 byte */
+        spi_transmit_burst(calc);
     }
 }
 
@@ -1993,7 +2386,7 @@ void EVE_cmd_button_var(int16_t x0, int16_t y0, int16_t w0, int16_t h0,
         spi_transmit((uint8_t)(options));
         spi_transmit((uint8_t)(options >> 8U));
 
-        private_string_write(text);
+        private_string_write(font, text);
 
         if ((options & EVE_OPT_FORMAT) != 0U)
         {
@@ -2013,7 +2406,7 @@ void EVE_cmd_button_var(int16_t x0, int16_t y0, int16_t w0, int16_t h0,
         spi_transmit_burst((uint32_t) x + ((uint32_t)y << 16U));
         spi_transmit_burst((uint32_t) w + ((uint32_t)h << 16U));
         spi_transmit_burst((uint32_t) f + ((uint32_t)options << 16U));
-        private_string_write(text);
+        private_string_write(font, text);
 
         if ((options & EVE_OPT_FORMAT) != 0U)
         {
@@ -2043,7 +2436,7 @@ void EVE_cmd_button_var_burst(int16_t x0, int16_t y0, int16_t w0, int16_t h0,
     spi_transmit_burst((uint32_t) x + ((uint32_t) y << 16));
     spi_transmit_burst((uint32_t) w + ((uint32_t) h << 16));
     spi_transmit_burst((uint32_t) f + ((uint32_t) options << 16));
-    private_string_write(text);
+    private_string_write(font, text);
 
     if ((options & EVE_OPT_FORMAT) != 0U)
     {
@@ -2080,7 +2473,7 @@ void EVE_cmd_text_var(int16_t x0, int16_t y0, int16_t font,
         spi_transmit((uint8_t)(options));
         spi_transmit((uint8_t)(options >> 8U));
 
-        private_string_write(text);
+        private_string_write(font, text);
 
         if ((options & EVE_OPT_FORMAT) != 0U)
         {
@@ -2099,7 +2492,7 @@ void EVE_cmd_text_var(int16_t x0, int16_t y0, int16_t font,
         spi_transmit_burst(CMD_TEXT);
         spi_transmit_burst((uint32_t) x + (((uint32_t) y) << 16U));
         spi_transmit_burst((uint32_t) f + (((uint32_t) options) << 16U));
-        private_string_write(text);
+        private_string_write(font, text);
 
         if ((options & EVE_OPT_FORMAT) != 0U)
         {
@@ -2126,7 +2519,7 @@ void EVE_cmd_text_var_burst(int16_t x0, int16_t y0, int16_t font,
     spi_transmit_burst(CMD_TEXT);
     spi_transmit_burst((uint32_t) x + (((uint32_t) y) << 16U));
     spi_transmit_burst((uint32_t) f + (((uint32_t) options) << 16U));
-    private_string_write(text);
+    private_string_write(font, text);
 
     if ((options & EVE_OPT_FORMAT) != 0U)
     {
@@ -2169,7 +2562,7 @@ void EVE_cmd_toggle_var(int16_t x0, int16_t y0, int16_t w0, int16_t font,
         spi_transmit((uint8_t)(state));
         spi_transmit((uint8_t)(state >> 8U));
 
-        private_string_write(text);
+        private_string_write(font, text);
 
         if ((options & EVE_OPT_FORMAT) != 0U)
         {
@@ -2189,7 +2582,7 @@ void EVE_cmd_toggle_var(int16_t x0, int16_t y0, int16_t w0, int16_t font,
         spi_transmit_burst((uint32_t) x + (((uint32_t) y) << 16U));
         spi_transmit_burst((uint32_t) w + (((uint32_t) f) << 16U));
         spi_transmit_burst((uint32_t) options + (((uint32_t) state) << 16U));
-        private_string_write(text);
+        private_string_write(font, text);
 
         if ((options & EVE_OPT_FORMAT) != 0U)
         {
@@ -2218,7 +2611,7 @@ void EVE_cmd_toggle_var_burst(int16_t x0, int16_t y0, int16_t w0, int16_t font,
     spi_transmit_burst((uint32_t) x + (((uint32_t) y) << 16U));
     spi_transmit_burst((uint32_t) w + (((uint32_t) f) << 16U));
     spi_transmit_burst((uint32_t) options + (((uint32_t) state) << 16U));
-    private_string_write(text);
+    private_string_write(font, text);
 
     if ((options & EVE_OPT_FORMAT) != 0U)
     {
@@ -2248,6 +2641,15 @@ void EVE_cmd_toggle_var_burst(int16_t x0, int16_t y0, int16_t w0, int16_t font,
 */
 void EVE_cmd_dl(uint32_t command)
 {
+#if defined (EVE_STATS)
+    EVE_stats.swaps += (CMD_SWAP == command) ? 1UL : 0UL;
+#endif
+#if defined (EVE_EVENTS)
+    if (CMD_SWAP == command)
+    {
+        EVE_event(EVE_EVENT_SWAP, 0UL);
+    }
+#endif
     if (0U == cmd_burst)
     {
         eve_begin_cmd(command);
@@ -2261,6 +2663,15 @@ void EVE_cmd_dl(uint32_t command)
 
 void EVE_cmd_dl_burst(uint32_t command)
 {
+#if defined (EVE_STATS)
+    EVE_stats.swaps += (CMD_SWAP == command) ? 1UL : 0UL;
+#endif
+#if defined (EVE_EVENTS)
+    if (CMD_SWAP == command)
+    {
+        EVE_event(EVE_EVENT_SWAP, 0UL);
+    }
+#endif
     spi_transmit_burst(command);
 }
 
@@ -2343,7 +2754,7 @@ void EVE_cmd_button(int16_t x0, int16_t y0, int16_t w0, int16_t h0,
         spi_transmit((uint8_t)(options));
         spi_transmit((uint8_t)(options >> 8U));
 
-        private_string_write(text);
+        private_string_write(font, text);
         EVE_cs_clear();
     }
     else
@@ -2352,7 +2763,7 @@ void EVE_cmd_button(int16_t x0, int16_t y0, int16_t w0, int16_t h0,
         spi_transmit_burst((uint32_t) x + (((uint32_t) y) << 16U));
         spi_transmit_burst((uint32_t) w + (((uint32_t) h) << 16U));
         spi_transmit_burst((uint32_t) f + (((uint32_t) options) << 16U));
-        private_string_write(text);
+        private_string_write(font, text);
     }
 }
 
@@ -2369,7 +2780,7 @@ void EVE_cmd_button_burst(int16_t x0, int16_t y0, int16_t w0, int16_t h0,
     spi_transmit_burst((uint32_t) x + (((uint32_t) y) << 16U));
     spi_transmit_burst((uint32_t) w + (((uint32_t) h) << 16U));
     spi_transmit_burst((uint32_t) f + (((uint32_t) options) << 16U));
-    private_string_write(text);
+    private_string_write(font, text);
 }
 
 void EVE_cmd_calibrate(void)
@@ -2741,7 +3152,7 @@ void EVE_cmd_keys(int16_t x0, int16_t y0, int16_t w0, int16_t h0,
         spi_transmit((uint8_t)(options));
         spi_transmit((uint8_t)(options >> 8U));
 
-        private_string_write(text);
+        private_string_write(font, text);
         EVE_cs_clear();
     }
     else
@@ -2751,7 +3162,7 @@ void EVE_cmd_keys(int16_t x0, int16_t y0, int16_t w0, int16_t h0,
         spi_transmit_burst((uint32_t) w + (((uint32_t) h) << 16U));
         spi_transmit_burst((uint32_t) f + (((uint32_t) options) << 16U));
 
-        private_string_write(text);
+        private_string_write(font, text);
     }
 }
 
@@ -2769,7 +3180,7 @@ void EVE_cmd_keys_burst(int16_t x0, int16_t y0, int16_t w0, int16_t h0,
     spi_transmit_burst((uint32_t) w + (((uint32_t) h) << 16U));
     spi_transmit_burst((uint32_t) f + (((uint32_t) options) << 16U));
 
-    private_string_write(text);
+    private_string_write(font, text);
 }
 
 void EVE_cmd_number(int16_t x0, int16_t y0, int16_t font, uint16_t options,
@@ -3296,7 +3707,7 @@ void EVE_cmd_text(int16_t x0, int16_t y0, int16_t font, uint16_t options,
         spi_transmit((uint8_t)(f >> 8U));
         spi_transmit((uint8_t)(options));
         spi_transmit((uint8_t)(options >> 8U));
-        private_string_write(text);
+        private_string_write(font, text);
         EVE_cs_clear();
     }
     else
@@ -3304,7 +3715,7 @@ void EVE_cmd_text(int16_t x0, int16_t y0, int16_t font, uint16_t options,
         spi_transmit_burst(CMD_TEXT);
         spi_transmit_burst((uint32_t) x + (((uint32_t) y) << 16U));
         spi_transmit_burst((uint32_t) f + (((uint32_t) options) << 16U));
-        private_string_write(text);
+        private_string_write(font, text);
     }
 }
 
@@ -3318,7 +3729,7 @@ void EVE_cmd_text_burst(int16_t x0, int16_t y0, int16_t font,
     spi_transmit_burst(CMD_TEXT);
     spi_transmit_burst((uint32_t) x + (((uint32_t) y) << 16U));
     spi_transmit_burst((uint32_t) f + (((uint32_t) options) << 16U));
-    private_string_write(text);
+    private_string_write(font, text);
 }
 
 void EVE_cmd_toggle(int16_t x0, int16_t y0, int16_t w0, int16_t font,
@@ -3344,7 +3755,7 @@ void EVE_cmd_toggle(int16_t x0, int16_t y0, int16_t w0, int16_t font,
         spi_transmit((uint8_t)(options >> 8U));
         spi_transmit((uint8_t)(state));
         spi_transmit((uint8_t)(state >> 8U));
-        private_string_write(text);
+        private_string_write(font, text);
         EVE_cs_clear();
     }
     else
@@ -3353,7 +3764,7 @@ void EVE_cmd_toggle(int16_t x0, int16_t y0, int16_t w0, int16_t font,
         spi_transmit_burst((uint32_t) x + (((uint32_t) y) << 16U));
         spi_transmit_burst((uint32_t) w + (((uint32_t) f) << 16U));
         spi_transmit_burst((uint32_t) options + (((uint32_t) state) << 16U));
-        private_string_write(text);
+        private_string_write(font, text);
     }
 }
 
@@ -3369,7 +3780,7 @@ void EVE_cmd_toggle_burst(int16_t x0, int16_t y0, int16_t w0, int16_t font,
     spi_transmit_burst((uint32_t) x + (((uint32_t) y) << 16U));
     spi_transmit_burst((uint32_t) w + (((uint32_t) f) << 16U));
     spi_transmit_burst((uint32_t) options + (((uint32_t) state) << 16U));
-    private_string_write(text);
+    private_string_write(font, text);
 }
 
 void EVE_cmd_translate(int32_t tx, int32_t ty)
@@ -64,6 +64,11 @@ EVE_cmd_animstartram_burst()
 - added parameter width to EVE_calibrate_manual()
 - changed the varargs versions of cmd_button, cmd_text and cmd_toggle to use an array of uint32_t values to comply with MISRA-C
 - fixed some MISRA-C issues
+- added prototypes for EVE_write_cmd_list() and EVE_write_cmd_list_burst()
+- added EVE_FAIL_FLASH_VERIFY for EVE_flash_update_image() in EVE_flash.c
+- added EVE_font_map_t and EVE_set_font_maps()
+- added EVE_stats_t, EVE_stats and EVE_stats_read() for the optional counters enabled with EVE_STATS
+- added EVE_fault_t, EVE_set_fault_hook() and EVE_set_fault_restore() for the diagnostics of co-processor faults
 
 */
 
@@ -88,6 +93,7 @@ EVE_cmd_animstartram_burst()
 #define EVE_FAIL_FLASHFAST_SPEED_TEST 11U
 #define EVE_IS_BUSY 12U
 #define EVE_FIFO_HALF_EMPTY 13U
+#define EVE_FAIL_FLASH_VERIFY 14U
 
 #if 0
 enum
@@ -109,6 +115,29 @@ enum
 };
 #endif
 
+#if defined (EVE_STATS)
+/* Counters maintained by EVE_commands.c when EVE_STATS is defined, these only count up and wrap around, */
+/* use the difference of two copies from EVE_stats_read() to get the rates. */
+typedef struct
+{
+    uint32_t bytes_write;    /* EVE_memWrite8/16/32() and EVE_memWrite_*_buffer(), including the address */
+    uint32_t bytes_burst;    /* co-processor commands from EVE_start_cmd_burst() to EVE_end_cmd_burst() */
+    uint32_t bytes_block;    /* block_transfer(), the data of EVE_cmd_inflate(), EVE_cmd_loadimage() and others */
+    uint32_t transactions;   /* chip-select cycles, reads and writes */
+    uint32_t executes;       /* calls of EVE_execute_cmd() */
+    uint32_t busy_polls;     /* calls of EVE_busy() from EVE_execute_cmd() */
+    uint32_t busy_polls_max; /* the most calls of EVE_busy() for one EVE_execute_cmd() */
+    uint32_t fault_resets;   /* co-processor faults that EVE_busy() recovered from */
+    uint32_t fault_swaps;    /* the value of swaps at the last fault, the frame the fault happened in */
+    uint32_t dma_transfers;  /* DMA transfers started by EVE_end_cmd_burst() */
+    uint32_t swaps;          /* CMD_SWAP sent with EVE_cmd_dl() or EVE_cmd_dl_burst() */
+} EVE_stats_t;
+
+extern volatile EVE_stats_t EVE_stats;
+
+void EVE_stats_read(EVE_stats_t *copy);
+#endif
+
 /*----------------------------------------------------------------------------------------------------------------------------*/
 /*---- helper functions
  * ------------------------------------------------------------------------------------------------------*/
@@ -203,6 +232,8 @@ uint8_t EVE_init(void);
 
 void EVE_start_cmd_burst(void);
 void EVE_end_cmd_burst(void);
+void EVE_write_cmd_list(const uint32_t *list, uint32_t num);
+void EVE_write_cmd_list_burst(const uint32_t *list, uint32_t num);
 
 /* EVE4: BT817 / BT818 */
 #if EVE_GEN > 3
@@ -344,4 +375,37 @@ void EVE_color_rgb_burst(uint32_t color);
 
 void EVE_calibrate_manual(uint16_t width, uint16_t height);
 
+/* font map for a subsetted font from tools/eve_asset, UTF-8 code points are translated to the glyphs of the font */
+typedef struct
+{
+    const uint32_t *codepoints; /* sorted, only the code points above 127 */
+    const uint8_t *glyphs;      /* the character in the font for each code point */
+    uint16_t count;
+    uint8_t font;               /* font handle */
+    uint8_t fallback;           /* character for code points that are not in the font */
+} EVE_font_map_t;
+
+void EVE_set_font_maps(const EVE_font_map_t *maps, uint8_t count);
+
+/* the bytes of RAM_CMD before REG_CMD_WRITE that EVE_busy() captures on a co-processor fault, multiple of 4 */
+#if !defined (EVE_FAULT_WINDOW)
+#define EVE_FAULT_WINDOW 64U
+#endif
+
+/* what EVE_busy() found on a co-processor fault before it reset the co-processor */
+typedef struct
+{
+    char report[128];      /* EVE_RAM_ERR_REPORT of BT81x, the message of the co-processor, empty for FT81x */
+    uint16_t cmd_read;     /* REG_CMD_READ, 0xfff after a fault */
+    uint16_t cmd_write;    /* REG_CMD_WRITE, the end of the commands the co-processor was working on */
+    uint16_t cmd_dl;       /* REG_CMD_DL, the display-list words the co-processor wrote so far */
+    uint16_t window_start; /* offset of window[0] in RAM_CMD */
+    uint8_t window[EVE_FAULT_WINDOW]; /* the last commands before REG_CMD_WRITE, one of these failed */
+} EVE_fault_t;
+
+typedef void (*EVE_fault_hook_t)(const EVE_fault_t *fault);
+
+void EVE_set_fault_hook(EVE_fault_hook_t hook, EVE_fault_t *buffer);
+void EVE_set_fault_restore(const uint32_t *list, uint32_t num);
+
 #endif /* EVE_COMMANDS_H */
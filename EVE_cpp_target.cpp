@@ -40,11 +40,19 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 - copied over the SPI and DMA support functions for the RP2040 baremetall target to be used under Arduino
 - modified the WIZIOPICO target for Arduino RP2040 to also work with ArduinoCore-mbed
 - fixed the ESP32 target to work with the ESP32-S3 as well
+- the DMA callbacks record EVE_EVENT_DMA_DONE with EVE_event_irq() when EVE_EVENTS is defined
 
  */
 
 #if defined (ARDUINO)
 
+    #if defined (EVE_EVENTS)
+        #include "EVE_target.h"
+        extern "C" {
+        #include "EVE_events.h"
+        }
+    #endif
+
     #if defined (ARDUINO_METRO_M4)
         #include "EVE_target.h"
         #include "EVE_commands.h"
@@ -65,6 +73,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
                 while(SERCOM2->SPI.INTFLAG.bit.TXC == 0);
                 SERCOM2->SPI.CTRLB.bit.RXEN = 1; /* switch receiver on by setting RXEN to 1 which is not enable protected */
                 EVE_dma_busy = 0;
+                #if defined (EVE_EVENTS)
+                EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+                #endif
                 EVE_cs_clear();
             }
 
@@ -150,6 +161,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
             void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
             {
                 EVE_dma_busy = 0;
+                #if defined (EVE_EVENTS)
+                EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+                #endif
                 EVE_cs_clear();
             }
 
@@ -198,6 +212,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
             digitalWrite(EVE_CS, HIGH); /* tell EVE to stop listen */
             #if defined (EVE_DMA)
                 EVE_dma_busy = 0;
+                #if defined (EVE_EVENTS)
+                EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+                #endif
             #endif
             }
 
@@ -270,6 +287,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
         void dma_callback(EventResponderRef event_responder)
         {
             EVE_dma_busy = 0;
+            #if defined (EVE_EVENTS)
+            EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+            #endif
             EVE_cs_clear();
         }
 
@@ -329,6 +349,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
             dma_hw->ints0 = 1u << dma_tx; /* ack irq */
             while((spi_get_hw(EVE_SPI)->sr & SPI_SSPSR_BSY_BITS) != 0); /* wait for the SPI to be done transmitting */
             EVE_dma_busy = 0;
+            #if defined (EVE_EVENTS)
+            EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+            #endif
             EVE_cs_clear();
         }
 
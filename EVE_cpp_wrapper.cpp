@@ -27,6 +27,7 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
 5.0
 - Bugfix: broke ESP8266 when I implemented this by using "__builtin_bswap32" a second time
+- added wrapper_spi_flush() to send the SPI buffer with a single SPI.transfer(buf, len) or SPI.writeBytes() for ESP8266
 
 */
 
@@ -35,11 +36,32 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 #include <Arduino.h>
 //#include <stdio.h>
 #include <SPI.h>
+#include "EVE_target.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if defined (EVE_SPI_BUFFER)
+
+    uint8_t EVE_spi_buffer[EVE_SPI_BUFFER_SIZE];
+    uint16_t EVE_spi_buffer_index = 0U;
+
+    void wrapper_spi_flush(void)
+    {
+        if (EVE_spi_buffer_index > 0U)
+        {
+        #if defined (ESP8266)
+            SPI.writeBytes(EVE_spi_buffer, EVE_spi_buffer_index);
+        #else
+            SPI.transfer(EVE_spi_buffer, EVE_spi_buffer_index); /* overwrites the buffer with the received bytes */
+        #endif
+            EVE_spi_buffer_index = 0U;
+        }
+    }
+
+#endif
+
 #if defined (ESP8266)
 
     void wrapper_spi_transmit(uint8_t data)
@@ -25,6 +25,7 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 @section History
 
 5.0
+- added an SPI buffer with wrapper_spi_flush() to send the bytes of a transfer as a block instead of one by one
 
 
 */
@@ -51,6 +52,31 @@ extern "C" {
 
 #endif
 
+#if defined (EVE_SPI_BUFFER)
+
+    #if !defined (EVE_SPI_BUFFER_SIZE)
+        #define EVE_SPI_BUFFER_SIZE 64U
+    #endif
+
+    extern uint8_t EVE_spi_buffer[EVE_SPI_BUFFER_SIZE];
+    extern uint16_t EVE_spi_buffer_index;
+
+    void wrapper_spi_flush(void);
+
+    /* collect the bytes of a transfer in EVE_spi_buffer, these are sent as a block by wrapper_spi_flush() */
+    /* which needs to be called before chip-select goes high and before anything is read */
+    static inline void wrapper_spi_buffer_transmit(uint8_t data)
+    {
+        EVE_spi_buffer[EVE_spi_buffer_index] = data;
+        EVE_spi_buffer_index++;
+        if (EVE_spi_buffer_index >= EVE_SPI_BUFFER_SIZE)
+        {
+            wrapper_spi_flush();
+        }
+    }
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
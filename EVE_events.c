@@ -0,0 +1,172 @@
+/*
+@file    EVE_events.c
+@brief   optional recorder for a timeline of the bus and co-processor activity of EVE_commands.c
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#include "EVE_events.h"
+
+#if defined (EVE_EVENTS)
+
+/* One ring buffer for the application and the library and one for interrupts, each has only one writer so
+ * neither needs a lock. An interrupt that records an event while the other ring is written does not disturb it. */
+typedef struct
+{
+    uint32_t time[EVE_EVENTS_SIZE];
+    uint32_t event[EVE_EVENTS_SIZE];
+    volatile uint32_t head; /* number of events written, the next slot is head % EVE_EVENTS_SIZE */
+} eve_events_ring_t;
+
+static eve_events_ring_t events_main;
+static eve_events_ring_t events_irq;
+static volatile uint8_t events_enabled = 1U;
+static uint8_t events_submitted; /* a burst or a chunk went to the cmd-FIFO and EVE_EVENT_IDLE is due */
+
+static void eve_events_put(eve_events_ring_t *ring, uint8_t type, uint32_t argument)
+{
+    uint32_t head = ring->head;
+    uint32_t slot = head & (EVE_EVENTS_SIZE - 1U);
+
+    ring->time[slot] = EVE_EVENTS_TIME();
+    ring->event[slot] = ((uint32_t) type << 24U) | (argument & 0x00ffffffUL);
+    ring->head = head + 1UL; /* the slot is complete before it is counted */
+}
+
+static void eve_events_put_32(uint8_t *buffer, uint32_t data)
+{
+    buffer[0U] = (uint8_t) data;
+    buffer[1U] = (uint8_t) (data >> 8U);
+    buffer[2U] = (uint8_t) (data >> 16U);
+    buffer[3U] = (uint8_t) (data >> 24U);
+}
+
+/* Writes the events of a ring oldest first, in blocks of 16 events. */
+/* Events that the writer overwrote while they were copied are left out. */
+static void eve_events_dump_ring(const eve_events_ring_t *ring, uint8_t flag,
+                                    void (*write)(const uint8_t *data, uint32_t length))
+{
+    uint8_t block[16U * 8U];
+    uint32_t used = 0U;
+    uint32_t head = ring->head;
+    uint32_t index = (head > EVE_EVENTS_SIZE) ? (head - EVE_EVENTS_SIZE) : 0UL;
+
+    while (index != head)
+    {
+        uint32_t slot = index & (EVE_EVENTS_SIZE - 1U);
+        uint32_t time = ring->time[slot];
+        uint32_t event = ring->event[slot];
+
+        if ((ring->head - index) <= EVE_EVENTS_SIZE)
+        {
+            eve_events_put_32(&block[used], time);
+            eve_events_put_32(&block[used + 4U], event | ((uint32_t) flag << 24U));
+            used += 8U;
+            if (used == sizeof(block))
+            {
+                write(block, used);
+                used = 0U;
+            }
+        }
+        index++;
+    }
+    if (used != 0U)
+    {
+        write(block, used);
+    }
+}
+
+/* Records an event of the application or the library, EVE_EVENT_IDLE is only kept after a burst or a chunk. */
+/* Not to be called from interrupts, these use EVE_event_irq(). */
+void EVE_event(uint8_t type, uint32_t argument)
+{
+    if (events_enabled != 0U)
+    {
+        uint8_t keep = 1U;
+
+        if (EVE_EVENT_IDLE == type)
+        {
+            keep = events_submitted;
+            events_submitted = 0U;
+        }
+        else if ((EVE_EVENT_BURST_END == type) || (EVE_EVENT_BLOCK_END == type))
+        {
+            events_submitted = 1U;
+        }
+        else
+        {
+            /* nothing to follow */
+        }
+        if (keep != 0U)
+        {
+            eve_events_put(&events_main, type, argument);
+        }
+    }
+}
+
+/* Records an event from an interrupt, e.g. EVE_EVENT_DMA_DONE from the DMA interrupt of the target. */
+void EVE_event_irq(uint8_t type, uint32_t argument)
+{
+    if (events_enabled != 0U)
+    {
+        eve_events_put(&events_irq, type, argument);
+    }
+}
+
+/* Stops or resumes recording, stopping right after a stall keeps the events that led to it. */
+void EVE_events_enable(uint8_t enable)
+{
+    events_enabled = enable;
+}
+
+/* This is meant to be called while no interrupt records events, e.g. with the DMA idle. */
+void EVE_events_clear(void)
+{
+    events_main.head = 0UL;
+    events_irq.head = 0UL;
+    events_submitted = 0U;
+}
+
+/* Hands the header and the events to a write function, e.g. for an UART or a file, see EVE_events.h for the format. */
+/* Recording is paused meanwhile so the dump itself does not add events when the function uses EVE. */
+void EVE_events_dump(void (*write)(const uint8_t *data, uint32_t length))
+{
+    uint8_t header[8U] = {(uint8_t) 'E', (uint8_t) 'V', (uint8_t) 'E', (uint8_t) 'V'};
+    uint8_t enabled = events_enabled;
+
+    events_enabled = 0U;
+    eve_events_put_32(&header[4U], EVE_EVENTS_CLOCK_HZ);
+    write(header, sizeof(header));
+    eve_events_dump_ring(&events_main, 0U, write);
+    eve_events_dump_ring(&events_irq, EVE_EVENTS_IRQ, write);
+    events_enabled = enabled;
+}
+
+#endif /* EVE_EVENTS */
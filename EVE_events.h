@@ -0,0 +1,91 @@
+/*
+@file    EVE_events.h
+@brief   contains the event types, the prototypes and the dump format of the optional timeline recorder
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#ifndef EVE_EVENTS_H
+#define EVE_EVENTS_H
+
+#pragma once
+
+#include "EVE.h"
+
+/* Set with "-D EVE_EVENTS" to record what EVE_commands.c does on the bus and when the co-processor is busy as events
+ * with a timestamp, without it EVE_commands.c does not call this module and nothing of it is used.
+ * tools/eve_timeline converts a dump to the Chrome trace format that chrome://tracing and ui.perfetto.dev show. */
+
+/* Events per ring buffer, a power of 2, the oldest events are overwritten. */
+#if !defined (EVE_EVENTS_SIZE)
+#define EVE_EVENTS_SIZE 256U
+#endif
+
+#if (EVE_EVENTS_SIZE < 2U) || ((EVE_EVENTS_SIZE & (EVE_EVENTS_SIZE - 1U)) != 0U)
+#error "EVE_EVENTS_SIZE needs to be a power of 2"
+#endif
+
+/* The timestamp of an event from a free running counter, e.g. "-D EVE_EVENTS_TIME()=micros()" for Arduino,
+ * the function needs to be declared thru EVE_target.h. EVE_EVENTS_CLOCK_HZ is the frequency of the counter. */
+#if !defined (EVE_EVENTS_TIME)
+#define EVE_EVENTS_TIME() 0UL
+#endif
+
+#if !defined (EVE_EVENTS_CLOCK_HZ)
+#define EVE_EVENTS_CLOCK_HZ 1000000UL
+#endif
+
+/* The events, the argument of an event has 24 bits. */
+#define EVE_EVENT_BURST_BEGIN 0x01U /* EVE_start_cmd_burst() */
+#define EVE_EVENT_BURST_END 0x02U   /* EVE_end_cmd_burst() */
+#define EVE_EVENT_DMA_START 0x03U   /* EVE_end_cmd_burst() starts the DMA, argument: bytes of the transfer */
+#define EVE_EVENT_DMA_DONE 0x04U    /* the DMA interrupt of the target, recorded with EVE_event_irq() */
+#define EVE_EVENT_WAIT_BEGIN 0x05U  /* EVE_execute_cmd() waits for the co-processor */
+#define EVE_EVENT_WAIT_END 0x06U    /* argument: EVE_busy() polls, only with EVE_STATS */
+#define EVE_EVENT_BLOCK_BEGIN 0x07U /* block_transfer() sends a chunk, argument: bytes of the chunk */
+#define EVE_EVENT_BLOCK_END 0x08U
+#define EVE_EVENT_IDLE 0x09U        /* EVE_busy() found the cmd-FIFO empty for the first time after a burst or a chunk */
+#define EVE_EVENT_SWAP 0x0aU        /* CMD_SWAP was added to the cmd-FIFO */
+#define EVE_EVENT_FAULT 0x0bU       /* EVE_busy() recovers from a co-processor fault, argument: REG_CMDB_SPACE */
+#define EVE_EVENT_USER_BEGIN 0x40U  /* a section of the application begins, argument: an id for the section */
+#define EVE_EVENT_USER_END 0x41U    /* the section with the id in the argument ends */
+
+/* The dump format:
+ * header: "EVEV", EVE_EVENTS_CLOCK_HZ (4 bytes, little endian)
+ * then 8 bytes per event: timestamp (4 bytes, little endian), type << 24 | argument (4 bytes, little endian)
+ * Bit 7 of the type is set for the events of interrupts, these are in the dump after the other events. */
+#define EVE_EVENTS_IRQ 0x80U
+
+void EVE_event(uint8_t type, uint32_t argument);
+void EVE_event_irq(uint8_t type, uint32_t argument);
+void EVE_events_enable(uint8_t enable);
+void EVE_events_clear(void);
+void EVE_events_dump(void (*write)(const uint8_t *data, uint32_t length));
+
+#endif /* EVE_EVENTS_H */
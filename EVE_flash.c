@@ -0,0 +1,425 @@
+/*
+@file    EVE_flash.c
+@brief   helper functions for the external flash of BT81x
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+@section History
+
+5.0
+- initial version with EVE_flash_update_image()
+- added the flash asset directory: EVE_flash_dir_find(), EVE_flash_dir_get() and EVE_flash_dir_reset()
+- added EVE_flash_bitmap() and EVE_flash_bitmap_burst() to display ASTC bitmaps directly from the flash
+- added a font cache manager for BT817/BT818: EVE_fontcache_init(), EVE_fontcache_select(), EVE_fontcache_update() and EVE_fontcache_warmup_burst()
+- EVE_flash_update_image() reads the image one sector at a time thru a callback instead of from one array,
+EVE_flash_crc32() reads from RAM
+
+*/
+
+#include <string.h>
+
+#include "EVE_flash.h"
+
+#if EVE_GEN > 2
+
+/* CRC-32 as used by CMD_MEMCRC, this is the same CRC-32 as in zlib, with a 16 entry table to not waste memory */
+/* note: data is read from RAM */
+uint32_t EVE_flash_crc32(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+    static const uint32_t crc_table[16] =
+    {
+        0x00000000UL, 0x1db71064UL, 0x3b6e20c8UL, 0x26d930acUL, 0x76dc4190UL, 0x6b6b51f4UL, 0x4db26158UL, 0x5005713cUL,
+        0xedb88320UL, 0xf00f9344UL, 0xd6d6a3e8UL, 0xcb61b38cUL, 0x9b64c2b0UL, 0x86d3d2d4UL, 0xa00ae278UL, 0xbdbdf21cUL
+    };
+
+    crc = ~crc;
+    for (uint32_t count = 0U; count < len; count++)
+    {
+        crc ^= (uint32_t) data[count];
+        crc = (crc >> 4U) ^ crc_table[crc & 0x0fU];
+        crc = (crc >> 4U) ^ crc_table[crc & 0x0fU];
+    }
+    return ~crc;
+}
+
+/* CRC-32 of a 4 kB sector of the external flash, "scratch" is a 4 kB area in RAM_G that the sector is copied to */
+/* note: address must be 64 byte aligned, scratch must be 4 byte aligned */
+uint32_t EVE_flash_sector_crc(uint32_t address, uint32_t scratch)
+{
+    EVE_cmd_flashread(scratch, address, EVE_FLASH_SECTOR_SIZE);
+    return EVE_cmd_memcrc(scratch, EVE_FLASH_SECTOR_SIZE);
+}
+
+/* program the collected sectors with CMD_FLASHUPDATE and read these back to verify the CRC */
+static uint8_t eve_flash_program_run(uint32_t dest, uint32_t window, uint32_t count, const uint32_t *crc, uint32_t scratch)
+{
+    uint8_t ret_val = E_OK;
+
+    EVE_cmd_flashupdate(dest, window, count * EVE_FLASH_SECTOR_SIZE);
+
+    for (uint32_t sector = 0U; sector < count; sector++)
+    {
+        if (EVE_flash_sector_crc(dest + (sector * EVE_FLASH_SECTOR_SIZE), scratch) != crc[sector])
+        {
+            ret_val = EVE_FAIL_FLASH_VERIFY;
+        }
+    }
+    return ret_val;
+}
+
+/* Update an image in the external flash and only transfer and program the sectors that changed. */
+/* The image is read one 4 kB sector at a time with the source callback into buffer, so it can come from an SD card, */
+/* a serial line or the flash of the host controller and does not need to fit into the memory of the host controller. */
+/* For every sector the CRC-32 of the flash content is calculated by EVE with CMD_FLASHREAD and CMD_MEMCRC and */
+/* compared to the CRC-32 of the new data. Sectors that differ are uploaded to a window in RAM_G, consecutive sectors */
+/* are collected and programmed together with CMD_FLASHUPDATE and verified afterwards. */
+/* dest: address in the flash, must be 4 kB aligned */
+/* len: size of the image, not compressed */
+/* source, context: callback that reads the image, see EVE_flash_source_t */
+/* buffer: EVE_FLASH_SECTOR_SIZE bytes in the RAM of the host controller */
+/* window, window_size: area in RAM_G to use, window must be 4 byte aligned and window_size at least 8 kB, */
+/* the last 4 kB of the window are used to read back sectors, up to EVE_FLASH_UPDATE_SLOTS sectors are collected */
+/* note: the flash must be in full speed mode, see EVE_init_flash() */
+/* note: there is no state to keep, a power loss in the middle of an update is resumed by calling this function */
+/* with the same image again as the sectors that already were written match now and are skipped */
+/* Returns E_OK, EVE_FAIL_FLASH_VERIFY if a sector did not read back with the expected CRC or E_NOT_OK for */
+/* invalid parameters or when the source returned less than requested, the sectors collected so far are programmed */
+uint8_t EVE_flash_update_image(uint32_t dest, uint32_t len, EVE_flash_source_t source, void *context, uint8_t *buffer,
+    uint32_t window, uint32_t window_size)
+{
+    uint32_t crc[EVE_FLASH_UPDATE_SLOTS];
+    uint32_t sectors = (len + EVE_FLASH_SECTOR_SIZE - 1UL) / EVE_FLASH_SECTOR_SIZE;
+    uint32_t slots = (window_size / EVE_FLASH_SECTOR_SIZE) - 1UL;
+    uint32_t scratch;
+    uint32_t run_start = 0U;
+    uint32_t run_count = 0U;
+    uint8_t ret_val = E_OK;
+
+    if ((0U == slots) || (window_size < (2UL * EVE_FLASH_SECTOR_SIZE)) || (NULL == source) || (NULL == buffer))
+    {
+        return E_NOT_OK;
+    }
+    slots = (slots > EVE_FLASH_UPDATE_SLOTS) ? EVE_FLASH_UPDATE_SLOTS : slots;
+    scratch = window + (slots * EVE_FLASH_SECTOR_SIZE);
+
+    for (uint32_t sector = 0U; sector < sectors; sector++)
+    {
+        uint32_t offset = sector * EVE_FLASH_SECTOR_SIZE;
+        uint32_t length = len - offset;
+        uint32_t expected;
+
+        length = (length > EVE_FLASH_SECTOR_SIZE) ? EVE_FLASH_SECTOR_SIZE : length;
+        if (source(context, offset, buffer, length) != length)
+        {
+            ret_val = E_NOT_OK;
+            break;
+        }
+        /* a short last sector is padded with 0xff like erased flash */
+        (void) memset(&buffer[length], 0xff, EVE_FLASH_SECTOR_SIZE - length);
+        expected = EVE_flash_crc32(0UL, buffer, EVE_FLASH_SECTOR_SIZE);
+
+        if (EVE_flash_sector_crc(dest + offset, scratch) == expected)
+        {
+            continue;
+        }
+
+        /* the sector is not next to the ones collected so far or the window is full */
+        if ((run_count > 0U) && (((run_start + run_count) != sector) || (run_count == slots)))
+        {
+            if (eve_flash_program_run(dest + (run_start * EVE_FLASH_SECTOR_SIZE), window, run_count, crc, scratch) != E_OK)
+            {
+                ret_val = EVE_FAIL_FLASH_VERIFY;
+            }
+            run_count = 0U;
+        }
+        if (0U == run_count)
+        {
+            run_start = sector;
+        }
+
+        EVE_memWrite_sram_buffer(window + (run_count * EVE_FLASH_SECTOR_SIZE), buffer, EVE_FLASH_SECTOR_SIZE);
+        crc[run_count] = expected;
+        run_count++;
+    }
+
+    if (run_count > 0U)
+    {
+        if ((eve_flash_program_run(dest + (run_start * EVE_FLASH_SECTOR_SIZE), window, run_count, crc, scratch) != E_OK) &&
+            (E_OK == ret_val))
+        {
+            ret_val = EVE_FAIL_FLASH_VERIFY;
+        }
+    }
+    return ret_val;
+}
+
+/* Look up an asset by name, returns NULL if there is no asset with that name. */
+const EVE_flash_asset_t *EVE_flash_dir_find(const EVE_flash_dir_t *dir, const char *name)
+{
+    uint32_t hash = EVE_flash_hash(name);
+    uint32_t mask = dir->table_size - 1UL;
+
+    for (uint32_t probe = 0U; probe < dir->table_size; probe++)
+    {
+        const EVE_flash_asset_t *asset = &dir->table[(hash + probe) & mask];
+
+        if (NULL == asset->name)
+        {
+            break;
+        }
+        if ((asset->hash == hash) && (0 == strcmp(asset->name, name)))
+        {
+            return asset;
+        }
+    }
+    return NULL;
+}
+
+/* Returns the address of an asset for use in the display list. */
+/* Assets of type EVE_FLASH_ASSET_LOAD are copied to RAM_G with CMD_FLASHREAD on first use and the RAM_G address is */
+/* returned, for EVE_FLASH_ASSET_DIRECT the return value is EVE_RAM_FLASH + offset. */
+/* Returns EVE_FLASH_DIR_NOT_FOUND if there is no asset with that name or it does not fit into RAM_G anymore. */
+/* note: the flash must be in full speed mode, see EVE_init_flash() */
+uint32_t EVE_flash_dir_get(EVE_flash_dir_t *dir, const char *name)
+{
+    const EVE_flash_asset_t *asset = EVE_flash_dir_find(dir, name);
+    uint32_t slot;
+    uint32_t size;
+
+    if (NULL == asset)
+    {
+        return EVE_FLASH_DIR_NOT_FOUND;
+    }
+    if (EVE_FLASH_ASSET_DIRECT == asset->type)
+    {
+        return EVE_RAM_FLASH + asset->offset;
+    }
+
+    slot = (uint32_t) (asset - dir->table);
+    if (dir->loaded[slot] != 0UL)
+    {
+        return dir->loaded[slot] - 1UL;
+    }
+
+    size = (asset->size + 3UL) & ~3UL;
+    if ((dir->ram_g_next + size) > dir->ram_g_end)
+    {
+        return EVE_FLASH_DIR_NOT_FOUND;
+    }
+    EVE_cmd_flashread(dir->ram_g_next, asset->offset, size); /* offset is 64 byte aligned by EVE Asset Builder */
+    dir->loaded[slot] = dir->ram_g_next + 1UL;
+    dir->ram_g_next += size;
+    return dir->loaded[slot] - 1UL;
+}
+
+/* Forget which assets are loaded and set the area in RAM_G to load assets to, ram_g_start must be 4 byte aligned. */
+void EVE_flash_dir_reset(EVE_flash_dir_t *dir, uint32_t ram_g_start, uint32_t ram_g_end)
+{
+    for (uint32_t slot = 0U; slot < dir->table_size; slot++)
+    {
+        dir->loaded[slot] = 0UL;
+    }
+    dir->ram_g_next = ram_g_start;
+    dir->ram_g_end = ram_g_end;
+}
+
+/* block footprint of EVE_COMPRESSED_RGBA_ASTC_4x4_KHR to EVE_COMPRESSED_RGBA_ASTC_12x12_KHR */
+static const uint8_t eve_astc_block_width[14U] = {4U, 5U, 5U, 6U, 6U, 8U, 8U, 8U, 10U, 10U, 10U, 10U, 12U, 12U};
+static const uint8_t eve_astc_block_height[14U] = {4U, 4U, 5U, 5U, 6U, 5U, 6U, 8U, 5U, 6U, 8U, 10U, 10U, 12U};
+
+/* Calculates the display list commands for an ASTC bitmap, every block has 16 bytes and the layout */
+/* is given in rows of blocks. Returns 0 for formats that are not ASTC. */
+static uint8_t eve_flash_bitmap_dl(uint32_t *dl, uint8_t handle, uint32_t address, uint16_t format, uint16_t width,
+    uint16_t height)
+{
+    uint32_t index = (uint32_t) format - EVE_COMPRESSED_RGBA_ASTC_4x4_KHR;
+    uint32_t linestride;
+    uint32_t rows;
+
+    if (index >= 14UL)
+    {
+        return 0U;
+    }
+    linestride = (((uint32_t) width + eve_astc_block_width[index] - 1UL) / eve_astc_block_width[index]) * 16UL;
+    rows = ((uint32_t) height + eve_astc_block_height[index] - 1UL) / eve_astc_block_height[index];
+
+    if (address >= EVE_RAM_FLASH)
+    {
+        address -= EVE_RAM_FLASH; /* as returned by EVE_flash_dir_get() */
+    }
+
+    dl[0U] = BITMAP_HANDLE(handle);
+    dl[1U] = BITMAP_SOURCE2(1UL, address >> 5U);
+    dl[2U] = BITMAP_LAYOUT(EVE_GLFORMAT, linestride, rows);
+    dl[3U] = BITMAP_LAYOUT_H(linestride, rows);
+    dl[4U] = BITMAP_EXT_FORMAT(format);
+    dl[5U] = BITMAP_SIZE(EVE_NEAREST, EVE_BORDER, EVE_BORDER, width, height);
+    dl[6U] = BITMAP_SIZE_H(width, height);
+    return 7U;
+}
+
+/* Sets up a bitmap handle for an ASTC bitmap that is used directly from the flash without copying it to RAM_G. */
+/* The address is either the offset in the flash or EVE_RAM_FLASH + offset as returned by EVE_flash_dir_get(), */
+/* it must be 32 byte aligned which it is for assets placed by EVE Asset Builder. */
+/* note: the flash must be in full speed mode, see EVE_init_flash() */
+/* note: formats other than ASTC are ignored, only ASTC bitmaps can be displayed from the flash */
+void EVE_flash_bitmap(uint8_t handle, uint32_t address, uint16_t format, uint16_t width, uint16_t height)
+{
+    uint32_t dl[7U];
+    uint8_t count = eve_flash_bitmap_dl(dl, handle, address, format, width, height);
+
+    for (uint8_t index = 0U; index < count; index++)
+    {
+        EVE_cmd_dl(dl[index]);
+    }
+}
+
+/* EVE_flash_bitmap() for use between EVE_start_cmd_burst() and EVE_end_cmd_burst() */
+void EVE_flash_bitmap_burst(uint8_t handle, uint32_t address, uint16_t format, uint16_t width, uint16_t height)
+{
+    uint32_t dl[7U];
+    uint8_t count = eve_flash_bitmap_dl(dl, handle, address, format, width, height);
+
+    for (uint8_t index = 0U; index < count; index++)
+    {
+        EVE_cmd_dl_burst(dl[index]);
+    }
+}
+
+#if EVE_GEN > 3
+
+/* The glyphs of a font in the flash are fetched while the display is rendered, the first appearance of a text with */
+/* glyphs that are not in the cache costs a lot of render time. CMD_FONTCACHE only caches one font at a time, */
+/* so the cache is moved to the font that is selected and the size for each font is learned from CMD_FONTCACHEQUERY. */
+
+static uint32_t eve_fontcache_size(const EVE_fontcache_t *cache, uint32_t size)
+{
+    size = (size + EVE_FONTCACHE_STEP - 1UL) & ~(EVE_FONTCACHE_STEP - 1UL);
+    if (size < EVE_FONTCACHE_MIN_SIZE)
+    {
+        size = EVE_FONTCACHE_MIN_SIZE;
+    }
+    if (size > cache->max_size)
+    {
+        size = cache->max_size;
+    }
+    return size;
+}
+
+/* This is meant to be called outside display-list building. */
+/* Sets up the area in RAM_G for the cache, fonts[] has one entry for each font in the flash, the entries can be */
+/* kept from a previous run to start with the learned sizes. */
+/* note: ptr must be 64 byte aligned and max_size at least EVE_FONTCACHE_MIN_SIZE */
+void EVE_fontcache_init(EVE_fontcache_t *cache, EVE_fontcache_font_t *fonts, uint8_t count, uint32_t ptr, uint32_t max_size)
+{
+    cache->fonts = fonts;
+    cache->count = count;
+    cache->active = EVE_FONTCACHE_NONE;
+    cache->ptr = ptr;
+    cache->max_size = max_size & ~3UL;
+    EVE_cmd_fontcache(0UL, 0L, 0UL); /* disable the cache */
+}
+
+/* This is meant to be called outside display-list building. */
+/* Moves the cache to the font, this flushes the cache so only call it when a screen mainly uses a different font. */
+void EVE_fontcache_select(EVE_fontcache_t *cache, uint8_t font)
+{
+    for (uint8_t index = 0U; index < cache->count; index++)
+    {
+        EVE_fontcache_font_t *entry = &cache->fonts[index];
+
+        if (entry->font == font)
+        {
+            if (index != cache->active)
+            {
+                if (0UL == entry->size)
+                {
+                    entry->size = entry->peak + (entry->peak / 4UL); /* 25% headroom for glyphs that were not seen yet */
+                }
+                entry->size = eve_fontcache_size(cache, entry->size);
+                EVE_cmd_fontcache(font, (int32_t) cache->ptr, entry->size);
+                cache->active = index;
+            }
+            break;
+        }
+    }
+}
+
+/* This is meant to be called outside display-list building, e.g. once per frame after the display list was swapped. */
+/* Reads the telemetry with CMD_FONTCACHEQUERY and grows the cache of the active font when it ran full. */
+void EVE_fontcache_update(EVE_fontcache_t *cache)
+{
+    EVE_fontcache_font_t *entry;
+    uint32_t total;
+    int32_t used;
+
+    if (cache->active >= cache->count)
+    {
+        return;
+    }
+    entry = &cache->fonts[cache->active];
+
+    EVE_cmd_fontcachequery(&total, &used);
+    if (used < 0L)
+    {
+        return;
+    }
+    if ((uint32_t) used > entry->peak)
+    {
+        entry->peak = (uint32_t) used;
+    }
+
+    /* less than one step left, the glyphs are evicted again before the next page uses them */
+    if (((uint32_t) used + EVE_FONTCACHE_STEP) > total)
+    {
+        entry->overflow++;
+        if (entry->size < cache->max_size)
+        {
+            entry->size = eve_fontcache_size(cache, entry->size * 2UL);
+            EVE_cmd_fontcache(entry->font, (int32_t) cache->ptr, entry->size);
+        }
+    }
+}
+
+/* To be used between EVE_start_cmd_burst() and EVE_end_cmd_burst(). */
+/* Draws the texts of upcoming screens with all colour channels masked so that the glyphs are fetched from the flash */
+/* into the cache without anything becoming visible. The tag buffer and the stencil buffer are left alone as well. */
+/* The texts are drawn at (0,0), glyphs beyond the screen width are not rendered and therefore not fetched either. */
+/* Only add a few texts per frame as these still cost render time. */
+void EVE_fontcache_warmup_burst(uint8_t font, const char *const texts[], uint8_t count)
+{
+    EVE_cmd_dl_burst(DL_SAVE_CONTEXT);
+    EVE_cmd_dl_burst(COLOR_MASK(0U, 0U, 0U, 0U));
+    EVE_cmd_dl_burst(TAG_MASK(0U));
+    EVE_cmd_dl_burst(STENCIL_OP(EVE_KEEP, EVE_KEEP));
+    for (uint8_t index = 0U; index < count; index++)
+    {
+        EVE_cmd_text_burst(0, 0, (int16_t) font, 0U, texts[index]);
+    }
+    EVE_cmd_dl_burst(DL_RESTORE_CONTEXT);
+}
+
+#endif /* EVE_GEN > 3 */
+
+#endif /* EVE_GEN > 2 */
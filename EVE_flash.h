@@ -0,0 +1,148 @@
+/*
+@file    EVE_flash.h
+@brief   contains the prototypes for the BT81x external flash helpers
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version with EVE_flash_update_image()
+- added the flash asset directory: EVE_flash_dir_find(), EVE_flash_dir_get() and EVE_flash_dir_reset()
+- added EVE_flash_bitmap() and EVE_flash_bitmap_burst() to display ASTC bitmaps directly from the flash
+- added a font cache manager for BT817/BT818: EVE_fontcache_init(), EVE_fontcache_select(), EVE_fontcache_update() and EVE_fontcache_warmup_burst()
+- EVE_flash_update_image() reads the image one sector at a time thru a callback instead of from one array,
+EVE_flash_crc32() reads from RAM
+
+*/
+
+#ifndef EVE_FLASH_H
+#define EVE_FLASH_H
+
+#pragma once
+
+#include "EVE.h"
+
+#if EVE_GEN > 2
+
+#define EVE_FLASH_SECTOR_SIZE 4096UL
+
+/* maximum number of sectors EVE_flash_update_image() collects in RAM_G before programming these */
+#if !defined (EVE_FLASH_UPDATE_SLOTS)
+#define EVE_FLASH_UPDATE_SLOTS 16U
+#endif
+
+/* Reads len bytes of the image for EVE_flash_update_image() from offset into buffer, len is at most */
+/* EVE_FLASH_SECTOR_SIZE and only less for the last sector. Returns the number of bytes read, less than len aborts */
+/* the update. */
+typedef uint32_t (*EVE_flash_source_t)(void *context, uint32_t offset, uint8_t *buffer, uint32_t len);
+
+/* flash asset directory, the tables are generated from the .map file of EVE Asset Builder with tools/eve_flashmap */
+
+#define EVE_FLASH_ASSET_LOAD 0U   /* copied to RAM_G with CMD_FLASHREAD on first use, e.g. .xfont */
+#define EVE_FLASH_ASSET_DIRECT 1U /* used directly from the flash, ASTC bitmaps and .glyph data */
+
+#define EVE_FLASH_DIR_NOT_FOUND 0xffffffffUL
+
+/* BITMAP_SOURCE value for a bitmap in the flash, the offset needs to be 32 byte aligned, */
+/* this can also be used as address parameter for EVE_cmd_setbitmap() */
+#define EVE_FLASH_BITMAP_SOURCE(offset) (0x800000UL | (((offset) & 0x7fffffUL) >> 5U))
+
+typedef struct
+{
+    const char *name; /* NULL for an empty slot */
+    uint32_t hash;
+    uint32_t offset; /* address in the flash */
+    uint32_t size;
+    uint8_t type;
+} EVE_flash_asset_t;
+
+typedef struct
+{
+    const EVE_flash_asset_t *table; /* open addressing hash table */
+    uint32_t table_size; /* power of two */
+    uint32_t *loaded; /* table_size entries, RAM_G address + 1 of the loaded assets, 0 when not loaded */
+    uint32_t ram_g_next; /* next free address in the RAM_G area for the assets */
+    uint32_t ram_g_end;
+} EVE_flash_dir_t;
+
+/* FNV-1a, this is also used by tools/eve_flashmap to build the tables */
+static inline uint32_t EVE_flash_hash(const char *name)
+{
+    uint32_t hash = 2166136261UL;
+
+    while (*name != '\0')
+    {
+        hash ^= (uint8_t) *name;
+        hash *= 16777619UL;
+        name++;
+    }
+    return hash;
+}
+
+uint32_t EVE_flash_crc32(uint32_t crc, const uint8_t *data, uint32_t len);
+uint32_t EVE_flash_sector_crc(uint32_t address, uint32_t scratch);
+uint8_t EVE_flash_update_image(uint32_t dest, uint32_t len, EVE_flash_source_t source, void *context, uint8_t *buffer,
+    uint32_t window, uint32_t window_size);
+
+const EVE_flash_asset_t *EVE_flash_dir_find(const EVE_flash_dir_t *dir, const char *name);
+uint32_t EVE_flash_dir_get(EVE_flash_dir_t *dir, const char *name);
+void EVE_flash_dir_reset(EVE_flash_dir_t *dir, uint32_t ram_g_start, uint32_t ram_g_end);
+
+void EVE_flash_bitmap(uint8_t handle, uint32_t address, uint16_t format, uint16_t width, uint16_t height);
+void EVE_flash_bitmap_burst(uint8_t handle, uint32_t address, uint16_t format, uint16_t width, uint16_t height);
+
+/* font cache manager for fonts with the glyphs in the flash, BT817 / BT818 only */
+#if EVE_GEN > 3
+
+#define EVE_FONTCACHE_MIN_SIZE 16384UL /* CMD_FONTCACHE needs at least 16 kB */
+#define EVE_FONTCACHE_STEP 4096UL
+#define EVE_FONTCACHE_NONE 0xffU
+
+typedef struct
+{
+    uint8_t font;    /* font handle as used with EVE_cmd_setfont2() */
+    uint32_t size;   /* size of the cache for this font, 0 to start with EVE_FONTCACHE_MIN_SIZE */
+    uint32_t peak;   /* highest "used" value from CMD_FONTCACHEQUERY */
+    uint8_t overflow; /* number of times the cache ran full */
+} EVE_fontcache_font_t;
+
+typedef struct
+{
+    EVE_fontcache_font_t *fonts;
+    uint8_t count;
+    uint8_t active;  /* index of the font the cache is set up for, EVE_FONTCACHE_NONE for none */
+    uint32_t ptr;    /* start of the area in RAM_G, 64 byte aligned */
+    uint32_t max_size;
+} EVE_fontcache_t;
+
+void EVE_fontcache_init(EVE_fontcache_t *cache, EVE_fontcache_font_t *fonts, uint8_t count, uint32_t ptr, uint32_t max_size);
+void EVE_fontcache_select(EVE_fontcache_t *cache, uint8_t font);
+void EVE_fontcache_update(EVE_fontcache_t *cache);
+void EVE_fontcache_warmup_burst(uint8_t font, const char *const texts[], uint8_t count);
+
+#endif /* EVE_GEN > 3 */
+
+#endif /* EVE_GEN > 2 */
+
+#endif /* EVE_FLASH_H */
@@ -0,0 +1,146 @@
+/*
+@file    EVE_linetime.c
+@brief   measures the render time of each line of the current display-list with CMD_LINETIME and reports the headroom
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#include "EVE_linetime.h"
+
+#if EVE_GEN > 3
+
+/* CMD_LINETIME renders the current display-list once more and writes the time it took for each line to RAM_G, */
+/* as one 32 bit value in system clocks per line. A line has to be rendered in the time the display needs to */
+/* scan out a line, otherwise the line is not complete in time and the display shows what was left in the line-buffer. */
+
+/* The budget of a line in system clocks, from the clocks per line and the pixel clock, either from the divider */
+/* REG_PCLK or from the second PLL of BT817 / BT818 that EVE_init() sets up when EVE_PCLK_FREQ is defined. */
+uint32_t EVE_linetime_budget(void)
+{
+    uint32_t hcycle = EVE_memRead16(REG_HCYCLE);
+    uint32_t divider = EVE_memRead8(REG_PCLK);
+    uint32_t budget = hcycle * divider;
+
+#if defined (EVE_PCLK_FREQ)
+    if (1U == divider)
+    {
+        budget = (uint32_t) (((uint64_t) hcycle * EVE_memRead32(REG_FREQUENCY)) / EVE_PCLK_FREQ);
+    }
+#endif
+    if (EVE_memRead8(REG_PCLK_2X) != 0U)
+    {
+        budget /= 2U; /* two pixels per clock */
+    }
+    return budget;
+}
+
+static void eve_linetime_rank(EVE_linetime_t *result, uint16_t line, uint32_t clocks)
+{
+    uint8_t slot = EVE_LINETIME_WORST;
+
+    while ((slot > 0U) && (clocks > result->worst[slot - 1U].clocks))
+    {
+        if (slot < EVE_LINETIME_WORST)
+        {
+            result->worst[slot] = result->worst[slot - 1U];
+        }
+        slot--;
+    }
+    if (slot < EVE_LINETIME_WORST)
+    {
+        result->worst[slot].line = line;
+        result->worst[slot].clocks = clocks;
+    }
+}
+
+/* This is meant to be called outside display-list building, it measures the display-list that is currently shown. */
+/* dest needs REG_VSIZE * 4 bytes of RAM_G, margin is the percentage below the budget from which on a line counts as at risk. */
+void EVE_linetime_measure(EVE_linetime_t *result, uint32_t dest, uint8_t margin)
+{
+    uint32_t risk;
+    uint32_t sum = 0UL;
+
+    result->budget = EVE_linetime_budget();
+    result->lines = EVE_memRead16(REG_VSIZE);
+    result->max = 0UL;
+    result->over_budget = 0U;
+    result->at_risk = 0U;
+    for (uint8_t slot = 0U; slot < EVE_LINETIME_WORST; slot++)
+    {
+        result->worst[slot].line = 0U;
+        result->worst[slot].clocks = 0UL;
+    }
+    risk = result->budget - ((result->budget * margin) / 100UL);
+
+    EVE_cmd_linetime(dest);
+
+    for (uint16_t line = 0U; line < result->lines; line++)
+    {
+        uint32_t clocks = EVE_memRead32(dest + ((uint32_t) line * 4UL));
+
+        sum += clocks;
+        if (clocks > result->max)
+        {
+            result->max = clocks;
+        }
+        if (clocks > result->budget)
+        {
+            result->over_budget++;
+        }
+        else if (clocks > risk)
+        {
+            result->at_risk++;
+        }
+        eve_linetime_rank(result, line, clocks);
+    }
+
+    result->average = (result->lines != 0U) ? (sum / result->lines) : 0UL;
+    if (result->budget != 0UL)
+    {
+        result->headroom = (int32_t) ((((int64_t) result->budget - (int64_t) result->max) * 100) / (int64_t) result->budget);
+    }
+    else
+    {
+        result->headroom = 0;
+    }
+}
+
+/* REG_UNDERRUN counts the lines that were not rendered in time, this returns the lines since the last call. */
+/* Call it once before measuring to start counting. */
+uint32_t EVE_linetime_underruns(EVE_linetime_t *result)
+{
+    uint32_t count = EVE_memRead32(REG_UNDERRUN);
+
+    result->underruns = count - result->underrun_count;
+    result->underrun_count = count;
+    return result->underruns;
+}
+
+#endif /* EVE_GEN > 3 */
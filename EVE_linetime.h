@@ -0,0 +1,74 @@
+/*
+@file    EVE_linetime.h
+@brief   contains the prototypes for the render-load monitor of BT817 / BT818 that uses CMD_LINETIME
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#ifndef EVE_LINETIME_H
+#define EVE_LINETIME_H
+
+#pragma once
+
+#include "EVE.h"
+
+#if EVE_GEN > 3
+
+/* the number of the slowest lines that EVE_linetime_measure() reports */
+#if !defined (EVE_LINETIME_WORST)
+#define EVE_LINETIME_WORST 8U
+#endif
+
+typedef struct
+{
+    uint16_t line;
+    uint32_t clocks;
+} EVE_linetime_line_t;
+
+typedef struct
+{
+    uint32_t budget;         /* system clocks to render one line, the time the display needs for one line */
+    uint32_t max;            /* system clocks of the slowest line */
+    uint32_t average;        /* system clocks over all lines */
+    int32_t headroom;        /* percent of the budget left on the slowest line, negative when the frame underruns */
+    uint16_t lines;          /* the number of lines measured, REG_VSIZE */
+    uint16_t over_budget;    /* lines that take longer than the budget, these show up as missing or torn lines */
+    uint16_t at_risk;        /* lines within the margin given to EVE_linetime_measure() of the budget */
+    uint32_t underruns;      /* change of REG_UNDERRUN since the last EVE_linetime_underruns() */
+    uint32_t underrun_count; /* REG_UNDERRUN at the last EVE_linetime_underruns() */
+    EVE_linetime_line_t worst[EVE_LINETIME_WORST]; /* the slowest lines, slowest first */
+} EVE_linetime_t;
+
+uint32_t EVE_linetime_budget(void);
+void EVE_linetime_measure(EVE_linetime_t *result, uint32_t dest, uint8_t margin);
+uint32_t EVE_linetime_underruns(EVE_linetime_t *result);
+
+#endif /* EVE_GEN > 3 */
+
+#endif /* EVE_LINETIME_H */
@@ -0,0 +1,421 @@
+/*
+@file    EVE_media.c
+@brief   streaming of images and videos thru the media-FIFO
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+@section History
+
+5.0
+- initial version with the media-FIFO streaming loader
+- added the non-blocking video player EVE_video_xxx()
+
+*/
+
+#include "EVE_media.h"
+
+/* Prepares a media-FIFO in RAM_G and the buffer in the RAM of the host controller. */
+/* The buffer does not need to be large, a couple hundred bytes work, larger buffers have less overhead per transfer. */
+void EVE_media_init(EVE_media_t *media, uint32_t fifo_ptr, uint32_t fifo_size, uint8_t *buffer, uint32_t buffer_size)
+{
+    media->fifo_ptr = fifo_ptr;
+    media->fifo_size = fifo_size & ~3UL;
+    media->write = 0UL;
+    media->producer = NULL;
+    media->context = NULL;
+    media->buffer = buffer;
+    media->buffer_size = buffer_size & ~3UL;
+    media->offset = 0UL;
+    media->pending = 0UL;
+    media->end = 1U;
+}
+
+/* This is meant to be called outside display-list building, it includes executing the command and waiting for completion. */
+/* Sets up the media-FIFO with CMD_MEDIAFIFO and resets the read and write pointers for a new stream. */
+void EVE_media_start(EVE_media_t *media, EVE_media_producer_t producer, void *context)
+{
+    EVE_cmd_mediafifo(media->fifo_ptr, media->fifo_size);
+    EVE_execute_cmd();
+    EVE_memWrite32(REG_MEDIAFIFO_WRITE, 0UL);
+    media->write = 0UL;
+    media->producer = producer;
+    media->context = context;
+    media->offset = 0UL;
+    media->pending = 0UL;
+    media->end = 0U;
+}
+
+/* Returns the number of bytes that can be written to the media-FIFO, read from REG_MEDIAFIFO_READ. */
+/* Four bytes are kept free as the FIFO would look empty with the write pointer reaching the read pointer. */
+uint32_t EVE_media_space(const EVE_media_t *media)
+{
+    uint32_t read = EVE_memRead32(REG_MEDIAFIFO_READ);
+    uint32_t used = (media->write + media->fifo_size - read) % media->fifo_size;
+
+    return media->fifo_size - used - 4UL;
+}
+
+/* write to the ring in RAM_G, split in two transfers when wrapping around */
+static void eve_media_write(EVE_media_t *media, const uint8_t *data, uint32_t len)
+{
+    uint32_t first = media->fifo_size - media->write;
+
+    if (first > len)
+    {
+        first = len;
+    }
+    EVE_memWrite_sram_buffer(media->fifo_ptr + media->write, data, first);
+    if (len > first)
+    {
+        EVE_memWrite_sram_buffer(media->fifo_ptr, &data[first], len - first);
+    }
+    media->write = (media->write + len) % media->fifo_size;
+}
+
+/* the producer may return any number of bytes but the media-FIFO is written in multiples of 4 bytes, */
+/* 1 to 3 bytes left over are moved to the start of the buffer and the producer is asked for more */
+static void eve_media_fill(EVE_media_t *media)
+{
+    uint32_t len;
+
+    for (uint32_t index = 0UL; index < media->pending; index++)
+    {
+        media->buffer[index] = media->buffer[media->offset + index];
+    }
+    media->offset = 0UL;
+
+    len = media->producer(media->context, &media->buffer[media->pending], media->buffer_size - media->pending);
+    if (len > (media->buffer_size - media->pending))
+    {
+        len = media->buffer_size - media->pending;
+    }
+    media->pending += len;
+
+    if (0UL == len)
+    {
+        media->end = 1U;
+        while ((media->pending & 3UL) != 0UL)
+        {
+            media->buffer[media->pending] = 0U; /* pad the end of the stream */
+            media->pending++;
+        }
+    }
+}
+
+/* Moves as much data from the producer to the media-FIFO as fits without waiting for EVE. */
+/* This is meant to be called outside display-list building, e.g. from the main loop while the co-processor */
+/* executes CMD_LOADIMAGE or CMD_PLAYVIDEO with EVE_OPT_MEDIAFIFO. */
+/* Returns EVE_IS_BUSY while there is data left and E_OK when the whole stream was written to the media-FIFO. */
+uint8_t EVE_media_service(EVE_media_t *media)
+{
+    uint32_t space = EVE_media_space(media);
+
+    for ( ; ; )
+    {
+        uint32_t len;
+
+        if ((media->pending < 4UL) && (0U == media->end))
+        {
+            eve_media_fill(media);
+        }
+        if (0UL == media->pending)
+        {
+            return E_OK;
+        }
+
+        len = (media->pending < space) ? media->pending : space;
+        len &= ~3UL;
+        if (0UL == len)
+        {
+            return EVE_IS_BUSY; /* the media-FIFO is full, EVE needs to consume data first */
+        }
+
+        eve_media_write(media, &media->buffer[media->offset], len);
+        EVE_memWrite32(REG_MEDIAFIFO_WRITE, media->write); /* let EVE start on the data right away */
+        media->offset += len;
+        media->pending -= len;
+        space -= len;
+    }
+}
+
+/* feed the media-FIFO until the co-processor completed the command */
+static uint8_t eve_media_run(EVE_media_t *media)
+{
+    uint16_t timeout = 0U;
+
+    while (EVE_busy() != E_OK)
+    {
+        if (E_OK == EVE_media_service(media))
+        {
+            /* all data is in the media-FIFO, incomplete data would leave the co-processor waiting for more */
+            if (EVE_memRead32(REG_MEDIAFIFO_READ) == media->write)
+            {
+                if (timeout >= EVE_MEDIA_TIMEOUT_MS)
+                {
+                    return E_NOT_OK;
+                }
+                DELAY_MS(1U);
+                timeout++;
+            }
+        }
+    }
+    return E_OK;
+}
+
+/* This is meant to be called outside display-list building, it includes executing the command and waiting for completion. */
+/* Decodes a JPEG or PNG to ptr with CMD_LOADIMAGE while the data is streamed in from the producer, the image */
+/* does not need to be in the memory of the host controller. */
+/* Returns E_OK or E_NOT_OK if the co-processor did not finish after the end of the data. */
+uint8_t EVE_media_loadimage(EVE_media_t *media, uint32_t ptr, uint32_t options, EVE_media_producer_t producer, void *context)
+{
+    EVE_media_start(media, producer, context);
+    EVE_cmd_loadimage(ptr, options | EVE_OPT_MEDIAFIFO, NULL, 0UL);
+    return eve_media_run(media);
+}
+
+/* This is meant to be called outside display-list building, it includes executing the command and waiting for completion. */
+/* Plays an AVI video with CMD_PLAYVIDEO while the data is streamed in from the producer. */
+/* Returns E_OK or E_NOT_OK if the co-processor did not finish after the end of the data. */
+uint8_t EVE_media_playvideo(EVE_media_t *media, uint32_t options, EVE_media_producer_t producer, void *context)
+{
+    EVE_media_start(media, producer, context);
+    EVE_cmd_playvideo(options | EVE_OPT_MEDIAFIFO, NULL, 0UL);
+    return eve_media_run(media);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------------*/
+/*---- video player
+ * ---------------------------------------------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------------------------------------------------------*/
+
+/* The player decodes one frame at a time with CMD_VIDEOFRAME and only puts the next one into the command FIFO */
+/* when the previous one is complete and REG_FRAMES says it is due, the display lists of the UI are executed by the */
+/* co-processor in between and show the last complete frame with EVE_video_bitmap() as address. */
+
+/* Prepares the player, dest0 and dest1 need width * height * 2 bytes each in RAM_G for RGB565, */
+/* with dest0 == dest1 the frame is decoded to the bitmap that is displayed which may tear. */
+void EVE_video_init(EVE_video_t *video, EVE_media_t *media, uint32_t dest0, uint32_t dest1, uint32_t result, uint16_t interval)
+{
+    video->media = media;
+    video->producer = NULL;
+    video->rewind = NULL;
+    video->context = NULL;
+    video->dest[0] = dest0;
+    video->dest[1] = dest1;
+    video->result = result;
+    video->frame = 0UL;
+    video->target = 0UL;
+    video->due = 0UL;
+    video->interval = (0U == interval) ? 1U : interval;
+    video->state = EVE_VIDEO_STOPPED;
+    video->decoding = 0U;
+}
+
+static void eve_video_restart(EVE_video_t *video)
+{
+    EVE_media_start(video->media, video->producer, video->context);
+    EVE_cmd_dl(CMD_VIDEOSTART);
+    video->frame = 0UL;
+    video->due = EVE_memRead32(REG_FRAMES);
+}
+
+/* This is meant to be called outside display-list building. */
+/* Starts to play an AVI video with MJPEG frames from the producer, rewind is optional and only needed for seeking backwards. */
+void EVE_video_open(EVE_video_t *video, EVE_media_producer_t producer, EVE_media_rewind_t rewind, void *context)
+{
+    video->producer = producer;
+    video->rewind = rewind;
+    video->context = context;
+    video->target = 0UL;
+    video->decoding = 0U;
+    eve_video_restart(video);
+    video->state = EVE_VIDEO_PLAYING;
+}
+
+/* This is meant to be called outside display-list building, e.g. once per pass of the main loop. */
+/* Feeds the media-FIFO, collects a decoded frame and queues the next frame when it is due. */
+/* Returns the state of the player. */
+uint8_t EVE_video_service(EVE_video_t *video)
+{
+    if ((EVE_VIDEO_STOPPED == video->state) || (EVE_VIDEO_ENDED == video->state))
+    {
+        return video->state;
+    }
+
+    (void) EVE_media_service(video->media);
+
+    if (EVE_VIDEO_FULLSCREEN == video->state)
+    {
+        if (E_OK == EVE_busy())
+        {
+            video->state = EVE_VIDEO_ENDED;
+        }
+        return video->state;
+    }
+
+    if (video->decoding != 0U)
+    {
+        if (EVE_busy() != E_OK)
+        {
+            return video->state; /* the co-processor still decodes the frame or waits for data */
+        }
+        video->decoding = 0U;
+        video->frame++;
+        if (0UL == EVE_memRead32(video->result)) /* CMD_VIDEOFRAME writes 0 after the last frame */
+        {
+            video->state = EVE_VIDEO_ENDED;
+            return video->state;
+        }
+    }
+
+    if (EVE_VIDEO_PLAYING == video->state)
+    {
+        uint32_t frames = EVE_memRead32(REG_FRAMES);
+
+        if ((video->frame < video->target) || ((int32_t) (frames - video->due) >= 0L))
+        {
+            if ((int32_t) (frames - video->due) > (int32_t) video->interval)
+            {
+                video->due = frames; /* too far behind, do not try to catch up */
+            }
+            video->due += video->interval;
+            EVE_cmd_dl(CMD_VIDEOFRAME);
+            EVE_cmd_dl(video->dest[(video->frame + 1UL) & 1UL]);
+            EVE_cmd_dl(video->result);
+            video->decoding = 1U;
+        }
+    }
+    return video->state;
+}
+
+/* Returns the RAM_G address of the last complete frame for EVE_cmd_setbitmap(). */
+uint32_t EVE_video_bitmap(const EVE_video_t *video)
+{
+    return video->dest[video->frame & 1UL];
+}
+
+/* Stops queueing frames, the last frame stays visible and the data stays in the media-FIFO. */
+void EVE_video_pause(EVE_video_t *video)
+{
+#if EVE_GEN > 2
+    if (EVE_VIDEO_FULLSCREEN == video->state)
+    {
+        EVE_memWrite8(REG_PLAY_CONTROL, 0U);
+        return;
+    }
+#endif
+    if (EVE_VIDEO_PLAYING == video->state)
+    {
+        video->state = EVE_VIDEO_PAUSED;
+    }
+}
+
+void EVE_video_resume(EVE_video_t *video)
+{
+#if EVE_GEN > 2
+    if (EVE_VIDEO_FULLSCREEN == video->state)
+    {
+        EVE_memWrite8(REG_PLAY_CONTROL, 1U);
+        return;
+    }
+#endif
+    if (EVE_VIDEO_PAUSED == video->state)
+    {
+        video->state = EVE_VIDEO_PLAYING;
+        video->due = EVE_memRead32(REG_FRAMES);
+    }
+}
+
+/* This is meant to be called outside display-list building, it waits for a frame that is being decoded. */
+void EVE_video_stop(EVE_video_t *video)
+{
+#if EVE_GEN > 2
+    if (EVE_VIDEO_FULLSCREEN == video->state)
+    {
+        EVE_memWrite8(REG_PLAY_CONTROL, 0xffU); /* -1 exits CMD_PLAYVIDEO */
+    }
+#endif
+    if (EVE_VIDEO_PLAYING == video->state)
+    {
+        video->state = EVE_VIDEO_PAUSED; /* do not queue any more frames */
+    }
+    while ((video->state != EVE_VIDEO_STOPPED) && (video->state != EVE_VIDEO_ENDED) &&
+           ((video->decoding != 0U) || (EVE_VIDEO_FULLSCREEN == video->state)))
+    {
+        (void) EVE_video_service(video);
+    }
+    video->state = EVE_VIDEO_STOPPED;
+}
+
+/* This is meant to be called outside display-list building. */
+/* Seeks to a frame, a stream can not be positioned inside an AVI without the index so the frames up to the target */
+/* are decoded without pacing, seeking backwards restarts the stream with the rewind function. */
+/* Returns E_NOT_OK if seeking backwards is not possible. */
+uint8_t EVE_video_seek(EVE_video_t *video, uint32_t frame)
+{
+    if ((EVE_VIDEO_STOPPED == video->state) || (EVE_VIDEO_FULLSCREEN == video->state))
+    {
+        return E_NOT_OK;
+    }
+    if (frame < video->frame)
+    {
+        uint8_t state = (EVE_VIDEO_ENDED == video->state) ? EVE_VIDEO_PLAYING : video->state;
+
+        if (NULL == video->rewind)
+        {
+            return E_NOT_OK;
+        }
+        video->state = EVE_VIDEO_PAUSED;
+        while (video->decoding != 0U) /* the frame in the command FIFO needs to complete first */
+        {
+            (void) EVE_video_service(video);
+        }
+        if (video->rewind(video->context) != E_OK)
+        {
+            video->state = EVE_VIDEO_ENDED;
+            return E_NOT_OK;
+        }
+        eve_video_restart(video);
+        video->state = state;
+    }
+    video->target = frame;
+    return E_OK;
+}
+
+#if EVE_GEN > 2
+/* This is meant to be called outside display-list building. */
+/* Plays a video with CMD_PLAYVIDEO that takes over the display, EVE_video_service() needs to be called until it */
+/* returns EVE_VIDEO_ENDED, this can be paused and stopped with REG_PLAY_CONTROL by EVE_video_pause() and EVE_video_stop(). */
+void EVE_video_fullscreen(EVE_video_t *video, uint32_t options, EVE_media_producer_t producer, void *context)
+{
+    video->producer = producer;
+    video->rewind = NULL;
+    video->context = context;
+    video->decoding = 0U;
+    EVE_memWrite8(REG_PLAY_CONTROL, 1U);
+    EVE_media_start(video->media, producer, context);
+    EVE_cmd_playvideo(options | EVE_OPT_MEDIAFIFO, NULL, 0UL);
+    video->state = EVE_VIDEO_FULLSCREEN;
+}
+#endif
@@ -0,0 +1,111 @@
+/*
+@file    EVE_media.h
+@brief   contains the prototypes for streaming data thru the media-FIFO
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version with the media-FIFO streaming loader
+- added the non-blocking video player EVE_video_xxx()
+
+*/
+
+#ifndef EVE_MEDIA_H
+#define EVE_MEDIA_H
+
+#pragma once
+
+#include "EVE.h"
+
+/* maximum time to wait for the co-processor to finish after all data was written to the media-FIFO */
+#if !defined (EVE_MEDIA_TIMEOUT_MS)
+#define EVE_MEDIA_TIMEOUT_MS 100U
+#endif
+
+/* Fills buffer with up to size bytes of the stream and returns the number of bytes, 0 for the end of the stream. */
+/* This can read from a file, an UART or whatever else provides the data. */
+typedef uint32_t (*EVE_media_producer_t)(void *context, uint8_t *buffer, uint32_t size);
+
+typedef struct
+{
+    uint32_t fifo_ptr;    /* start of the media-FIFO in RAM_G, 4 byte aligned */
+    uint32_t fifo_size;   /* size of the media-FIFO, a multiple of 4 */
+    uint32_t write;       /* offset in the media-FIFO, the same value as in REG_MEDIAFIFO_WRITE */
+    EVE_media_producer_t producer;
+    void *context;
+    uint8_t *buffer;      /* buffer in the RAM of the host controller the producer writes to */
+    uint32_t buffer_size; /* a multiple of 4 */
+    uint32_t offset;      /* first byte in the buffer that was not written to the media-FIFO yet */
+    uint32_t pending;     /* number of bytes in the buffer that were not written to the media-FIFO yet */
+    uint8_t end;          /* the producer reported the end of the stream */
+} EVE_media_t;
+
+void EVE_media_init(EVE_media_t *media, uint32_t fifo_ptr, uint32_t fifo_size, uint8_t *buffer, uint32_t buffer_size);
+void EVE_media_start(EVE_media_t *media, EVE_media_producer_t producer, void *context);
+uint32_t EVE_media_space(const EVE_media_t *media);
+uint8_t EVE_media_service(EVE_media_t *media);
+uint8_t EVE_media_loadimage(EVE_media_t *media, uint32_t ptr, uint32_t options, EVE_media_producer_t producer, void *context);
+uint8_t EVE_media_playvideo(EVE_media_t *media, uint32_t options, EVE_media_producer_t producer, void *context);
+
+/* video player, the frames are decoded with CMD_VIDEOFRAME to RAM_G while the UI keeps rendering */
+
+#define EVE_VIDEO_STOPPED 0U
+#define EVE_VIDEO_PLAYING 1U
+#define EVE_VIDEO_PAUSED 2U
+#define EVE_VIDEO_ENDED 3U
+#define EVE_VIDEO_FULLSCREEN 4U /* CMD_PLAYVIDEO owns the co-processor and the display */
+
+/* Restarts the stream of the producer at the beginning, returns E_OK or E_NOT_OK if it can not do that. */
+typedef uint8_t (*EVE_media_rewind_t)(void *context);
+
+typedef struct
+{
+    EVE_media_t *media;
+    EVE_media_producer_t producer;
+    EVE_media_rewind_t rewind;  /* optional, needed to seek backwards */
+    void *context;
+    uint32_t dest[2];           /* the frames are decoded alternating to these for RGB565 bitmaps, can be the same address */
+    uint32_t result;            /* 4 bytes in RAM_G for CMD_VIDEOFRAME, 1 while more frames follow, 0 after the last */
+    uint32_t frame;             /* number of frames decoded */
+    uint32_t target;            /* frames are decoded without pacing until this frame, for seeking */
+    uint32_t due;               /* value of REG_FRAMES the next frame is due at */
+    uint16_t interval;          /* display frames per video frame, e.g. 2 for a 30 fps video on a 60 Hz display */
+    uint8_t state;
+    uint8_t decoding;           /* CMD_VIDEOFRAME is in the command FIFO */
+} EVE_video_t;
+
+void EVE_video_init(EVE_video_t *video, EVE_media_t *media, uint32_t dest0, uint32_t dest1, uint32_t result, uint16_t interval);
+void EVE_video_open(EVE_video_t *video, EVE_media_producer_t producer, EVE_media_rewind_t rewind, void *context);
+uint8_t EVE_video_service(EVE_video_t *video);
+uint32_t EVE_video_bitmap(const EVE_video_t *video);
+void EVE_video_pause(EVE_video_t *video);
+void EVE_video_resume(EVE_video_t *video);
+void EVE_video_stop(EVE_video_t *video);
+uint8_t EVE_video_seek(EVE_video_t *video, uint32_t frame);
+#if EVE_GEN > 2
+void EVE_video_fullscreen(EVE_video_t *video, uint32_t options, EVE_media_producer_t producer, void *context);
+#endif
+
+#endif /* EVE_MEDIA_H */
@@ -0,0 +1,284 @@
+/*
+@file    EVE_profile.c
+@brief   measures named sections of each frame, keeps histograms of the times and shows them in an overlay
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#include "EVE_profile.h"
+#include "EVE_commands.h"
+
+#define EVE_PROFILE_BAR_WIDTH 100 /* pixels for the budget in the overlay */
+#define EVE_PROFILE_LINE 16       /* pixels per line in the overlay */
+
+static void eve_profile_sample(EVE_profile_t *profile, EVE_profile_section_t *section, uint32_t time)
+{
+    uint32_t bin = (time * 8UL) / ((profile->budget_us != 0UL) ? profile->budget_us : 1UL);
+
+    if (bin >= EVE_PROFILE_BINS)
+    {
+        bin = EVE_PROFILE_BINS - 1U;
+    }
+    if (section->histogram[bin] < 0xffffU)
+    {
+        section->histogram[bin]++;
+    }
+    section->last = time;
+    section->sum += time;
+    section->count++;
+    if (time > section->max)
+    {
+        section->max = time;
+    }
+}
+
+/* The clock is a function of the target that returns a free running microsecond counter, e.g. micros() for Arduino. */
+void EVE_profile_init(EVE_profile_t *profile, uint32_t (*clock_us)(void), uint32_t budget_us)
+{
+    profile->clock_us = clock_us;
+    profile->budget_us = budget_us;
+    for (uint8_t index = 0U; index < EVE_PROFILE_SECTIONS; index++)
+    {
+        profile->section[index].name = NULL;
+    }
+    profile->section[EVE_PROFILE_BUILD].name = "build";
+#if defined (EVE_DMA)
+    profile->section[EVE_PROFILE_TRANSFER].name = "transfer";
+#endif
+    profile->section[EVE_PROFILE_EXECUTE].name = "execute";
+    profile->section[EVE_PROFILE_SWAP].name = "swap";
+    profile->section[EVE_PROFILE_FRAME].name = "frame";
+    EVE_profile_reset(profile);
+}
+
+void EVE_profile_name(EVE_profile_t *profile, uint8_t section, const char *name)
+{
+    if (section < EVE_PROFILE_SECTIONS)
+    {
+        profile->section[section].name = name;
+    }
+}
+
+/* Clears the times, the histograms and the count of frames over the budget, e.g. when the application changes the page. */
+void EVE_profile_reset(EVE_profile_t *profile)
+{
+    for (uint8_t index = 0U; index < EVE_PROFILE_SECTIONS; index++)
+    {
+        EVE_profile_section_t *section = &profile->section[index];
+
+        section->last = 0UL;
+        section->max = 0UL;
+        section->sum = 0UL;
+        section->count = 0UL;
+        section->running = 0U;
+        for (uint8_t bin = 0U; bin < EVE_PROFILE_BINS; bin++)
+        {
+            section->histogram[bin] = 0U;
+        }
+    }
+    profile->over_budget = 0UL;
+    profile->pending = EVE_PROFILE_SECTIONS;
+}
+
+void EVE_profile_begin(EVE_profile_t *profile, uint8_t section)
+{
+    if (section < EVE_PROFILE_SECTIONS)
+    {
+        profile->section[section].start = profile->clock_us();
+        profile->section[section].running = 1U;
+    }
+}
+
+void EVE_profile_end(EVE_profile_t *profile, uint8_t section)
+{
+    if ((section < EVE_PROFILE_SECTIONS) && (profile->section[section].running != 0U))
+    {
+        EVE_profile_section_t *current = &profile->section[section];
+
+        current->running = 0U;
+        eve_profile_sample(profile, current, profile->clock_us() - current->start);
+    }
+}
+
+/* Marks the start of a frame, the time since the last call is the time of the frame. */
+void EVE_profile_frame(EVE_profile_t *profile)
+{
+    EVE_profile_section_t *frame = &profile->section[EVE_PROFILE_FRAME];
+    uint32_t now = profile->clock_us();
+
+    if (frame->running != 0U)
+    {
+        eve_profile_sample(profile, frame, now - frame->start);
+        if (frame->last > profile->budget_us)
+        {
+            profile->over_budget++;
+        }
+    }
+    frame->start = now;
+    frame->running = 1U;
+}
+
+/* To be called right after EVE_end_cmd_burst(), ends EVE_PROFILE_BUILD and starts to follow the list thru EVE. */
+void EVE_profile_submit(EVE_profile_t *profile)
+{
+    EVE_profile_end(profile, EVE_PROFILE_BUILD);
+#if defined (EVE_DMA)
+    EVE_profile_begin(profile, EVE_PROFILE_TRANSFER);
+    profile->pending = EVE_PROFILE_TRANSFER;
+#else
+    EVE_profile_begin(profile, EVE_PROFILE_EXECUTE);
+    profile->pending = EVE_PROFILE_EXECUTE;
+#endif
+}
+
+/* Ends the sections after EVE_profile_submit() when EVE got that far, this does not wait. */
+/* This is meant to be called outside display-list building, e.g. from the main loop, the accuracy is the interval of the calls. */
+void EVE_profile_poll(EVE_profile_t *profile)
+{
+#if defined (EVE_DMA)
+    if ((EVE_PROFILE_TRANSFER == profile->pending) && (0U == EVE_dma_busy))
+    {
+        EVE_profile_end(profile, EVE_PROFILE_TRANSFER);
+        EVE_profile_begin(profile, EVE_PROFILE_EXECUTE);
+        profile->pending = EVE_PROFILE_EXECUTE;
+    }
+#endif
+    /* EVE_FIFO_HALF_EMPTY still has commands to execute, only an empty cmd-FIFO ends the section */
+    if ((EVE_PROFILE_EXECUTE == profile->pending) && (E_OK == EVE_busy()))
+    {
+        EVE_profile_end(profile, EVE_PROFILE_EXECUTE);
+        EVE_profile_begin(profile, EVE_PROFILE_SWAP);
+        profile->frames = EVE_memRead32(REG_FRAMES);
+        profile->pending = EVE_PROFILE_SWAP;
+    }
+    else if ((EVE_PROFILE_SWAP == profile->pending) && (EVE_memRead32(REG_FRAMES) != profile->frames))
+    {
+        EVE_profile_end(profile, EVE_PROFILE_SWAP);
+        profile->pending = EVE_PROFILE_SECTIONS;
+    }
+    else
+    {
+        /* nothing changed */
+    }
+}
+
+uint32_t EVE_profile_average(const EVE_profile_t *profile, uint8_t section)
+{
+    uint32_t average = 0UL;
+
+    if ((section < EVE_PROFILE_SECTIONS) && (profile->section[section].count != 0UL))
+    {
+        average = profile->section[section].sum / profile->section[section].count;
+    }
+    return average;
+}
+
+/* Returns the time that percent of the passes did not exceed, rounded up to the bins of the histogram. */
+/* Passes that took longer than twice the budget all fall in the last bin, the maximum is returned for these. */
+uint32_t EVE_profile_percentile(const EVE_profile_t *profile, uint8_t section, uint8_t percent)
+{
+    uint32_t result = 0UL;
+
+    if (section < EVE_PROFILE_SECTIONS)
+    {
+        const EVE_profile_section_t *current = &profile->section[section];
+        uint32_t total = 0UL;
+        uint32_t target;
+        uint8_t bin = 0U;
+
+        for (uint8_t index = 0U; index < EVE_PROFILE_BINS; index++)
+        {
+            total += current->histogram[index];
+        }
+        target = ((total * percent) + 99UL) / 100UL;
+        total = 0UL;
+        while (bin < EVE_PROFILE_BINS)
+        {
+            total += current->histogram[bin];
+            if ((total >= target) && (total != 0UL))
+            {
+                break;
+            }
+            bin++;
+        }
+        if (bin >= (EVE_PROFILE_BINS - 1U))
+        {
+            result = current->max;
+        }
+        else
+        {
+            result = (((uint32_t) bin + 1UL) * profile->budget_us) / 8UL;
+            result = (result < current->max) ? result : current->max;
+        }
+    }
+    return result;
+}
+
+/* Shows the name, the last and the maximum time in us and a bar for the last time of each section with a name. */
+/* The bars are EVE_PROFILE_BAR_WIDTH pixels for the budget and turn red over the budget. */
+/* To be used between EVE_start_cmd_burst() and EVE_end_cmd_burst(), this draws EVE_PROFILE_LINE pixels per section. */
+void EVE_profile_overlay_burst(const EVE_profile_t *profile, int16_t xc0, int16_t yc0, int16_t font)
+{
+    int16_t ypos = yc0;
+    uint32_t budget = (profile->budget_us != 0UL) ? profile->budget_us : 1UL;
+
+    EVE_cmd_dl_burst(DL_SAVE_CONTEXT);
+    for (uint8_t index = 0U; index < EVE_PROFILE_SECTIONS; index++)
+    {
+        const EVE_profile_section_t *section = &profile->section[index];
+        uint32_t width;
+
+        if ((NULL == section->name) || (0UL == section->count))
+        {
+            continue;
+        }
+
+        width = (section->last * (uint32_t) EVE_PROFILE_BAR_WIDTH) / budget;
+        width = (width < (2UL * (uint32_t) EVE_PROFILE_BAR_WIDTH)) ? width : (2UL * (uint32_t) EVE_PROFILE_BAR_WIDTH);
+        EVE_cmd_dl_burst((section->last > profile->budget_us) ? COLOR_RGB(255U, 0U, 0U) : COLOR_RGB(0U, 192U, 0U));
+        EVE_cmd_dl_burst(DL_BEGIN | EVE_RECTS);
+        EVE_cmd_dl_burst(VERTEX2F((xc0 + 160) * 16, (ypos + 2) * 16));
+        EVE_cmd_dl_burst(VERTEX2F((xc0 + 160 + (int16_t) width) * 16, (ypos + EVE_PROFILE_LINE - 2) * 16));
+        EVE_cmd_dl_burst(DL_END);
+
+        EVE_cmd_dl_burst(COLOR_RGB(255U, 255U, 255U));
+        EVE_cmd_text_burst(xc0, ypos, font, 0U, section->name);
+        EVE_cmd_number_burst(xc0 + 100, ypos, font, EVE_OPT_RIGHTX, (int32_t) section->last);
+        EVE_cmd_number_burst(xc0 + 150, ypos, font, EVE_OPT_RIGHTX, (int32_t) section->max);
+        ypos += EVE_PROFILE_LINE;
+    }
+    if (profile->over_budget != 0UL)
+    {
+        EVE_cmd_dl_burst(COLOR_RGB(255U, 0U, 0U));
+        EVE_cmd_number_burst(xc0 + 150, ypos, font, EVE_OPT_RIGHTX, (int32_t) profile->over_budget);
+        EVE_cmd_text_burst(xc0 + 160, ypos, font, 0U, "over budget");
+    }
+    EVE_cmd_dl_burst(DL_RESTORE_CONTEXT);
+}
@@ -0,0 +1,90 @@
+/*
+@file    EVE_profile.h
+@brief   contains the prototypes for the per-frame timing of named sections
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#ifndef EVE_PROFILE_H
+#define EVE_PROFILE_H
+
+#pragma once
+
+#include "EVE.h"
+
+/* the sections that EVE_profile_submit() and EVE_profile_poll() measure, the rest is free for the application */
+#define EVE_PROFILE_BUILD 0U    /* building the display list, from EVE_profile_begin() to EVE_profile_submit() */
+#define EVE_PROFILE_TRANSFER 1U /* the DMA transfer of the cmd-FIFO, only with EVE_DMA */
+#define EVE_PROFILE_EXECUTE 2U  /* the co-processor executing the commands until the cmd-FIFO is empty */
+#define EVE_PROFILE_SWAP 3U     /* from an empty cmd-FIFO to the next frame on the display with the new list */
+#define EVE_PROFILE_FRAME 4U    /* from one EVE_profile_frame() to the next */
+#define EVE_PROFILE_USER 5U     /* the first section for the application */
+
+#if !defined (EVE_PROFILE_SECTIONS)
+#define EVE_PROFILE_SECTIONS 8U
+#endif
+
+/* the histogram bins are 1/8 of the budget wide, the last bin counts everything from twice the budget up */
+#define EVE_PROFILE_BINS 17U
+
+typedef struct
+{
+    const char *name; /* sections without a name are not shown by EVE_profile_overlay_burst() */
+    uint32_t start;   /* time of EVE_profile_begin() */
+    uint32_t last;    /* duration of the last pass in us */
+    uint32_t max;
+    uint32_t sum;
+    uint32_t count;
+    uint16_t histogram[EVE_PROFILE_BINS];
+    uint8_t running;
+} EVE_profile_section_t;
+
+typedef struct
+{
+    uint32_t (*clock_us)(void); /* a free running microsecond counter of the target */
+    uint32_t budget_us;         /* time per frame, e.g. 16667 for 60 Hz */
+    uint32_t over_budget;       /* frames that took longer than the budget */
+    uint32_t frames;            /* REG_FRAMES at the end of EVE_PROFILE_EXECUTE */
+    uint8_t pending;            /* the section EVE_profile_poll() waits for to end */
+    EVE_profile_section_t section[EVE_PROFILE_SECTIONS];
+} EVE_profile_t;
+
+void EVE_profile_init(EVE_profile_t *profile, uint32_t (*clock_us)(void), uint32_t budget_us);
+void EVE_profile_name(EVE_profile_t *profile, uint8_t section, const char *name);
+void EVE_profile_reset(EVE_profile_t *profile);
+void EVE_profile_begin(EVE_profile_t *profile, uint8_t section);
+void EVE_profile_end(EVE_profile_t *profile, uint8_t section);
+void EVE_profile_frame(EVE_profile_t *profile);
+void EVE_profile_submit(EVE_profile_t *profile);
+void EVE_profile_poll(EVE_profile_t *profile);
+uint32_t EVE_profile_average(const EVE_profile_t *profile, uint8_t section);
+uint32_t EVE_profile_percentile(const EVE_profile_t *profile, uint8_t section, uint8_t percent);
+void EVE_profile_overlay_burst(const EVE_profile_t *profile, int16_t xc0, int16_t yc0, int16_t font);
+
+#endif /* EVE_PROFILE_H */
@@ -52,6 +52,13 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 - added more defines for ATSAMC21 and ATSAMx51 - chip crises...
 - added DMA support for the GD32C103 target
 - fixed the ESP32 target to work with the ESP32-S3 as well
+- changed the native ESP32 target to queue several DMA transfers with a pool of buffers and transaction descriptors,
+this also fixes the transaction descriptor going out of scope while the transfer was still running
+- added an optional PIO transport with chained DMA for the RP2040 target: EVE_RP2040_PIO
+- replaced the HAL DMA code for STM32 with register level DMA for STM32F4 and STM32G4 and added spi_transmit_bulk()
+- the DMA interrupts record EVE_EVENT_DMA_DONE for the timeline of EVE_events.c when EVE_EVENTS is defined
+- EVE_RP2040_PIO: the state-machine runs at the clock of the SPI block by default, it stays single-bit SPI and only
+takes chip-select and the wait for the end of the transfer off the CPU
 
  */
 
@@ -59,6 +66,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
   #include "EVE_target.h"
   #include "EVE_commands.h"
+  #if defined (EVE_EVENTS)
+  #include "EVE_events.h"
+  #endif
 
     #if defined (__GNUC__)
 
@@ -131,6 +141,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
                 EVE_SPI->SPI.CTRLB.bit.RXEN = 1; /* switch receiver on by setting RXEN to 1 which is not enable protected */
                 EVE_cs_clear();
                 EVE_dma_busy = 0;
+                #if defined (EVE_EVENTS)
+                EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+                #endif
             }
 
         #endif /* DMA */
@@ -206,6 +219,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
                 while(EVE_SPI->SPI.INTFLAG.bit.TXC == 0); /* wait for the SPI to be done transmitting */
                 EVE_SPI->SPI.CTRLB.bit.RXEN = 1; /* switch receiver on by setting RXEN to 1 which is not enable protected */
                 EVE_dma_busy = 0;
+                #if defined (EVE_EVENTS)
+                EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+                #endif
                 EVE_cs_clear();
             }
 
@@ -280,47 +296,188 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
             volatile uint16_t EVE_dma_buffer_index;
             volatile uint8_t EVE_dma_busy = 0;
 
-            volatile DMA_HandleTypeDef EVE_dma_tx;
+            /* Register level DMA, the HAL is too slow to be used for every block transfer. */
+            /* The SPI is set up by the application, the DMA only feeds the TX register, received bytes are discarded. */
+
+            #if defined (STM32F4)
+            static const uint8_t eve_dma_flag_shift[4] = {0U, 6U, 16U, 22U};
+
+            static void eve_dma_clear_flags(void)
+            {
+                if (EVE_DMA_STREAM_NUM < 4U)
+                {
+                    EVE_DMA_INSTANCE->LIFCR = 0x3dUL << eve_dma_flag_shift[EVE_DMA_STREAM_NUM];
+                }
+                else
+                {
+                    EVE_DMA_INSTANCE->HIFCR = 0x3dUL << eve_dma_flag_shift[EVE_DMA_STREAM_NUM - 4U];
+                }
+            }
+
+            static uint32_t eve_dma_complete(void)
+            {
+                uint32_t flags;
+
+                if (EVE_DMA_STREAM_NUM < 4U)
+                {
+                    flags = EVE_DMA_INSTANCE->LISR >> eve_dma_flag_shift[EVE_DMA_STREAM_NUM];
+                }
+                else
+                {
+                    flags = EVE_DMA_INSTANCE->HISR >> eve_dma_flag_shift[EVE_DMA_STREAM_NUM - 4U];
+                }
+                return (flags & 0x20UL); /* TCIF */
+            }
+
+            static void eve_dma_stop(void)
+            {
+                LL_SPI_DisableDMAReq_TX(EVE_SPI);
+                EVE_DMA_STREAM->CR &= ~(DMA_SxCR_EN | DMA_SxCR_TCIE);
+                while ((EVE_DMA_STREAM->CR & DMA_SxCR_EN) != 0UL) {}
+                eve_dma_clear_flags();
+            }
+
+            static void eve_dma_start(const uint8_t *data, uint16_t length, uint32_t irq)
+            {
+                EVE_DMA_STREAM->M0AR = (uint32_t) data;
+                EVE_DMA_STREAM->NDTR = length;
+                EVE_DMA_STREAM->CR |= irq | DMA_SxCR_EN;
+                LL_SPI_EnableDMAReq_TX(EVE_SPI);
+            }
+
+            #define EVE_DMA_TCIE DMA_SxCR_TCIE
+
+            static void eve_dma_setup(void)
+            {
+                if (DMA2 == EVE_DMA_INSTANCE)
+                {
+                    RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+                }
+                else
+                {
+                    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+                }
+                (void) RCC->AHB1ENR; /* make sure the clock is running before the registers are written */
+
+                eve_dma_stop();
+                EVE_DMA_STREAM->PAR = (uint32_t) &EVE_SPI->DR;
+                EVE_DMA_STREAM->CR = (EVE_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL_1 | DMA_SxCR_MINC | DMA_SxCR_DIR_0;
+                EVE_DMA_STREAM->FCR = 0UL; /* direct mode */
+            }
+            #endif /* STM32F4 */
+
+            #if defined (STM32G4)
+            #define EVE_DMA_FLAG_SHIFT ((EVE_DMA_CHANNEL_NUM - 1U) * 4U)
+
+            static void eve_dma_clear_flags(void)
+            {
+                EVE_DMA_INSTANCE->IFCR = DMA_IFCR_CGIF1 << EVE_DMA_FLAG_SHIFT;
+            }
+
+            static uint32_t eve_dma_complete(void)
+            {
+                return (EVE_DMA_INSTANCE->ISR & (DMA_ISR_TCIF1 << EVE_DMA_FLAG_SHIFT));
+            }
+
+            static void eve_dma_stop(void)
+            {
+                LL_SPI_DisableDMAReq_TX(EVE_SPI);
+                EVE_DMA_CHANNEL->CCR &= ~(DMA_CCR_EN | DMA_CCR_TCIE);
+                eve_dma_clear_flags();
+            }
+
+            static void eve_dma_start(const uint8_t *data, uint16_t length, uint32_t irq)
+            {
+                EVE_DMA_CHANNEL->CMAR = (uint32_t) data;
+                EVE_DMA_CHANNEL->CNDTR = length;
+                EVE_DMA_CHANNEL->CCR |= irq | DMA_CCR_EN;
+                LL_SPI_EnableDMAReq_TX(EVE_SPI);
+            }
+
+            #define EVE_DMA_TCIE DMA_CCR_TCIE
+
+            static void eve_dma_setup(void)
+            {
+                if (DMA2 == EVE_DMA_INSTANCE)
+                {
+                    RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN | RCC_AHB1ENR_DMAMUX1EN;
+                }
+                else
+                {
+                    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN | RCC_AHB1ENR_DMAMUX1EN;
+                }
+                (void) RCC->AHB1ENR; /* make sure the clock is running before the registers are written */
+
+                eve_dma_stop();
+                EVE_DMAMUX_CHANNEL->CCR = EVE_DMA_REQUEST;
+                EVE_DMA_CHANNEL->CPAR = (uint32_t) &EVE_SPI->DR;
+                EVE_DMA_CHANNEL->CCR = DMA_CCR_PL_1 | DMA_CCR_MINC | DMA_CCR_DIR; /* 8 bit to 8 bit, memory to peripheral */
+            }
+            #endif /* STM32G4 */
+
+            /* wait for the last byte to leave the SPI and discard what was received meanwhile */
+            static void eve_spi_finish(void)
+            {
+                while (!LL_SPI_IsActiveFlag_TXE(EVE_SPI)) {}
+                while (LL_SPI_IsActiveFlag_BSY(EVE_SPI)) {}
+                while (LL_SPI_IsActiveFlag_RXNE(EVE_SPI))
+                {
+                    (void) LL_SPI_ReceiveData8(EVE_SPI);
+                }
+                LL_SPI_ClearFlag_OVR(EVE_SPI);
+            }
 
             void EVE_init_dma(void)
             {
-                __HAL_RCC_DMA2_CLK_ENABLE();
-                eve_dma_handle.Instance = DMA2_Stream3;
-                eve_dma_handle.Init.Channel = DMA_CHANNEL_3;
-                eve_dma_handle.Init.Direction = DMA_MEMORY_TO_PERIPH;
-                eve_dma_handle.Init.PeriphInc = DMA_PINC_DISABLE;
-                eve_dma_handle.Init.MemInc = DMA_MINC_ENABLE;
-                eve_dma_handle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
-                eve_dma_handle.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
-                eve_dma_handle.Init.Mode = DMA_NORMAL;
-                eve_dma_handle.Init.Priority = DMA_PRIORITY_HIGH;
-                eve_dma_handle.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
-                HAL_DMA_Init(&eve_dma_handle);
-                __HAL_LINKDMA(&eve_spi_handle, hdmatx, eve_dma_handle);
-                HAL_NVIC_SetPriority(DMA2_Stream3_IRQn, 0, 0);
-                HAL_NVIC_EnableIRQ(DMA2_Stream3_IRQn);
+                eve_dma_setup();
+                NVIC_SetPriority(EVE_DMA_IRQn, 0U);
+                NVIC_EnableIRQ(EVE_DMA_IRQn);
             }
 
             void EVE_start_dma_transfer(void)
             {
                 EVE_cs_set();
-                if(HAL_OK == HAL_SPI_Transmit_DMA(&eve_spi_handle, ((uint8_t *) &EVE_dma_buffer[0])+1, ((EVE_dma_buffer_index)*4)-1))
-                {
-                    EVE_dma_busy = 42;
-                }
+                EVE_dma_busy = 42;
+                eve_dma_start(((const uint8_t *) &EVE_dma_buffer[0])+1, (uint16_t) ((EVE_dma_buffer_index * 4U) - 1U), EVE_DMA_TCIE);
             }
 
             /* DMA-done-Interrupt-Handler */
-            void DMA2_Stream3_IRQHandler(void)
+            void EVE_DMA_IRQHandler(void)
             {
-                HAL_DMA_IRQHandler(&eve_dma_handle);
+                eve_dma_stop();
+                eve_spi_finish();
+                EVE_cs_clear();
+                EVE_dma_busy = 0;
+                #if defined (EVE_EVENTS)
+                EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+                #endif
             }
 
-            /* Callback for end-of-DMA-transfer */
-            void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+            /* Send a block of data with the DMA and wait for it to complete, the caller handles chip-select. */
+            /* The DMA reads directly from the source, const data in FLASH does not need to be copied to RAM first. */
+            void spi_transmit_bulk(const uint8_t *data, uint32_t length)
             {
-                EVE_dma_busy = 0;
-                EVE_cs_clear();
+                if (length < EVE_DMA_BULK_MIN)
+                {
+                    for (uint32_t count = 0U; count < length; count++)
+                    {
+                        spi_transmit(data[count]);
+                    }
+                }
+                else
+                {
+                    while (length > 0U)
+                    {
+                        uint16_t block_len = (length > 0xffffUL) ? 0xffffU : (uint16_t) length; /* the counter has 16 bits */
+
+                        eve_dma_start(data, block_len, 0UL);
+                        while (0UL == eve_dma_complete()) {}
+                        eve_dma_stop();
+                        data = &data[block_len];
+                        length -= block_len;
+                    }
+                    eve_spi_finish();
+                }
             }
 
         #endif /* DMA */
@@ -343,13 +500,41 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
         spi_device_handle_t EVE_spi_device = {0};
         spi_device_handle_t EVE_spi_device_simple = {0};
 
-        static void eve_spi_post_transfer_callback(void)
+        #if defined (EVE_DMA)
+
+        /* EVE_DMA_QUEUE_SIZE buffers with their own transaction descriptors, these are queued with the driver */
+        /* one after another and EVE_dma_buffer points to the one that is currently filled by the application */
+        static uint32_t eve_dma_pool[EVE_DMA_QUEUE_SIZE][1025U] DMA_ATTR;
+        static spi_transaction_t eve_dma_trans[EVE_DMA_QUEUE_SIZE];
+        static uint8_t eve_dma_slot = 0U;   /* index of the buffer EVE_dma_buffer points to */
+        static uint8_t eve_dma_queued = 0U; /* transactions not yet collected with spi_device_get_trans_result() */
+        static portMUX_TYPE eve_dma_lock = portMUX_INITIALIZER_UNLOCKED;
+
+        uint32_t *EVE_dma_buffer = eve_dma_pool[0U];
+        volatile uint16_t EVE_dma_buffer_index;
+        volatile uint8_t EVE_dma_busy = 0; /* number of transfers in flight */
+
+        #endif /* DMA */
+
+        static void eve_spi_pre_transfer_callback(spi_transaction_t *trans)
+        {
+            (void) trans;
+            gpio_set_level(EVE_CS, 0); /* make EVE listen */
+        }
+
+        static void eve_spi_post_transfer_callback(spi_transaction_t *trans)
         {
+            (void) trans;
             gpio_set_level(EVE_CS, 1); /* tell EVE to stop listen */
             #if defined (EVE_DMA)
-                EVE_dma_busy = 0;
+                portENTER_CRITICAL_ISR(&eve_dma_lock);
+                EVE_dma_busy--;
+                portEXIT_CRITICAL_ISR(&eve_dma_lock);
+                #if defined (EVE_EVENTS)
+                EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+                #endif
             #endif
-            }
+        }
 
         void EVE_init_spi(void)
         {
@@ -370,20 +555,23 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
             buscfg.sclk_io_num = EVE_SCK;
             buscfg.quadwp_io_num = -1;
             buscfg.quadhd_io_num = -1;
-            buscfg.max_transfer_sz= 4088;
+            buscfg.max_transfer_sz= 4096;
 
             devcfg.clock_speed_hz = 16 * 1000 * 1000; /* clock = 16 MHz */
             devcfg.mode = 0;                          /* SPI mode 0 */
-            devcfg.spics_io_num = -1;                 /* CS pin operated by app */
-            devcfg.queue_size = 3;                    /* we need only one transaction in the que */
+            devcfg.spics_io_num = -1;                 /* CS pin operated by the callbacks */
+            devcfg.queue_size = EVE_DMA_QUEUE_SIZE;   /* one transaction per DMA buffer */
             devcfg.address_bits = 24;                 /* 24 bits for the address */
             devcfg.command_bits = 0;                  /* command operated by app */
-            devcfg.post_cb = (transaction_cb_t)eve_spi_post_transfer_callback;
+            devcfg.pre_cb = eve_spi_pre_transfer_callback;
+            devcfg.post_cb = eve_spi_post_transfer_callback;
 
             spi_bus_initialize(SPI2_HOST, &buscfg, SPI_DMA_CH_AUTO);
             spi_bus_add_device(SPI2_HOST, &devcfg, &EVE_spi_device);
 
             devcfg.address_bits = 0;
+            devcfg.queue_size = 1;
+            devcfg.pre_cb = 0;
             devcfg.post_cb = 0;
             devcfg.clock_speed_hz = 10 * 1000 * 1000; /* clock = 10 MHz */
             spi_bus_add_device(SPI2_HOST, &devcfg, &EVE_spi_device_simple);
@@ -391,23 +579,45 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
         #if defined (EVE_DMA)
 
-        uint32_t EVE_dma_buffer[1025];
-        volatile uint16_t EVE_dma_buffer_index;
-        volatile uint8_t EVE_dma_busy = 0;
-
         void EVE_init_dma(void)
         {
         }
 
+        /* Queues the current buffer and switches EVE_dma_buffer over to the next one in the pool. */
+        /* This only blocks when all buffers are in flight, then it waits for the oldest transfer to finish. */
+        /* The transfers are executed in order and chip-select is handled per transfer by the pre/post callbacks. */
         void EVE_start_dma_transfer(void)
         {
-            spi_transaction_t EVE_spi_transaction = {0};
-            gpio_set_level(EVE_CS, 0); /* make EVE listen */
-            EVE_spi_transaction.tx_buffer = (uint8_t *) &EVE_dma_buffer[1];
-            EVE_spi_transaction.length = (EVE_dma_buffer_index-1) * 4 * 8;
-            EVE_spi_transaction.addr = 0x00b02578; /* WRITE + REG_CMDB_WRITE; */
-            spi_device_queue_trans(EVE_spi_device, &EVE_spi_transaction, portMAX_DELAY);
-            EVE_dma_busy = 42;
+            spi_transaction_t *trans = &eve_dma_trans[eve_dma_slot];
+
+            trans->flags = 0;
+            trans->addr = 0x00b02578; /* WRITE + REG_CMDB_WRITE; */
+            trans->length = (EVE_dma_buffer_index-1) * 4 * 8;
+            trans->rxlength = 0;
+            trans->tx_buffer = (uint8_t *) &EVE_dma_buffer[1];
+            trans->rx_buffer = NULL;
+
+            portENTER_CRITICAL(&eve_dma_lock);
+            EVE_dma_busy++;
+            portEXIT_CRITICAL(&eve_dma_lock);
+
+            spi_device_queue_trans(EVE_spi_device, trans, portMAX_DELAY);
+            eve_dma_queued++;
+
+            eve_dma_slot++;
+            if (eve_dma_slot >= EVE_DMA_QUEUE_SIZE)
+            {
+                eve_dma_slot = 0U;
+            }
+            EVE_dma_buffer = eve_dma_pool[eve_dma_slot];
+
+            if (eve_dma_queued >= EVE_DMA_QUEUE_SIZE) /* the next buffer still belongs to a queued transfer */
+            {
+                spi_transaction_t *done;
+
+                spi_device_get_trans_result(EVE_spi_device, &done, portMAX_DELAY);
+                eve_dma_queued--;
+            }
         }
 
         #endif /* DMA */
@@ -445,6 +655,155 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
         uint32_t EVE_dma_buffer[1025];
         volatile uint16_t EVE_dma_buffer_index;
         volatile uint8_t EVE_dma_busy = 0;
+
+        #if defined (EVE_RP2040_PIO)
+        /* note: activated by "build_flags = -D RP2040 -D EVE_RP2040_PIO" */
+        /* The DMA transfers are done by a PIO state-machine instead of the SPI block, it is fed by three chained DMA */
+        /* channels: the number of bits to send, the three byte address of REG_CMDB_WRITE and the payload from */
+        /* EVE_dma_buffer[1]. The state-machine pulls chip-select low, shifts out all bits, pulls chip-select high and */
+        /* raises an interrupt, so the interrupt handler only has to hand the pins back to the SPI block instead of */
+        /* waiting for SSPSR.BSY to clear. */
+        /* This is single-bit SPI with one bit per SCK, same as the SPI block, a burst takes as long as with the SPI */
+        /* block at the same clock. Quad-SPI is not supported, with REG_SPI_WIDTH set EVE expects all transfers on */
+        /* four lines, the reads included, and these still go thru the SPI block. */
+
+        #include "hardware/pio.h"
+        #include "hardware/pio_instructions.h"
+        #include "hardware/clocks.h"
+
+        #if !defined (EVE_PIO)
+            #define EVE_PIO pio0
+            #define EVE_PIO_IRQ PIO0_IRQ_0
+        #endif
+
+        #if !defined (EVE_PIO_SPI_FREQ)
+            #define EVE_PIO_SPI_FREQ 8000000UL /* same as the SPI block in EVE_init_spi() */
+        #endif
+
+        static const uint8_t eve_pio_header[3] = {0xB0U, 0x25U, 0x78U}; /* REG_CMDB_WRITE + MEM_WRITE */
+        static uint32_t eve_pio_bits; /* number of bits to transfer minus one, the first word for the state-machine */
+        static uint eve_pio_sm;
+        static int dma_count;
+        static int dma_header;
+        static int dma_tx;
+
+        /* SPI mode 0, MSB first, SCK is side-set, MOSI is the out pin and CS is the set pin */
+        static uint16_t eve_pio_instructions[8];
+
+        static void eve_pio_build_program(void)
+        {
+            eve_pio_instructions[0] = pio_encode_pull(true, true) | pio_encode_sideset(1, 0); /* wait for the bit-count */
+            eve_pio_instructions[1] = pio_encode_out(pio_x, 32) | pio_encode_sideset(1, 0);
+            eve_pio_instructions[2] = pio_encode_set(pio_pins, 0) | pio_encode_sideset(1, 0); /* CS low */
+            eve_pio_instructions[3] = pio_encode_out(pio_pins, 1) | pio_encode_sideset(1, 0) | pio_encode_delay(1); /* bit-loop */
+            eve_pio_instructions[4] = pio_encode_jmp_x_dec(3) | pio_encode_sideset(1, 1) | pio_encode_delay(1); /* SCK high */
+            eve_pio_instructions[5] = pio_encode_nop() | pio_encode_sideset(1, 0) | pio_encode_delay(1);
+            eve_pio_instructions[6] = pio_encode_set(pio_pins, 1) | pio_encode_sideset(1, 0); /* CS high */
+            eve_pio_instructions[7] = pio_encode_irq_set(false, 0) | pio_encode_sideset(1, 0);
+        }
+
+        static void eve_pio_pins_to_pio(void)
+        {
+            pio_gpio_init(EVE_PIO, EVE_SCK);
+            pio_gpio_init(EVE_PIO, EVE_MOSI);
+            pio_gpio_init(EVE_PIO, EVE_CS);
+        }
+
+        static void eve_pio_pins_to_spi(void)
+        {
+            gpio_set_function(EVE_SCK, GPIO_FUNC_SPI);
+            gpio_set_function(EVE_MOSI, GPIO_FUNC_SPI);
+            gpio_set_function(EVE_CS, GPIO_FUNC_SIO); /* the SIO output for CS still is high */
+        }
+
+        static void EVE_PIO_handler(void)
+        {
+            pio_interrupt_clear(EVE_PIO, 0);
+            eve_pio_pins_to_spi();
+            EVE_dma_busy = 0;
+            #if defined (EVE_EVENTS)
+            EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+            #endif
+        }
+
+        void EVE_init_dma(void)
+        {
+            pio_program_t program = {0};
+            pio_sm_config smc;
+            uint offset;
+            uint32_t pin_mask = (1UL << EVE_SCK) | (1UL << EVE_MOSI) | (1UL << EVE_CS);
+            dma_channel_config cfg;
+
+            eve_pio_build_program();
+            program.instructions = eve_pio_instructions;
+            program.length = 8;
+            program.origin = -1;
+
+            eve_pio_sm = pio_claim_unused_sm(EVE_PIO, true);
+            offset = pio_add_program(EVE_PIO, &program);
+
+            smc = pio_get_default_sm_config();
+            sm_config_set_wrap(&smc, offset, offset + 7U);
+            sm_config_set_sideset(&smc, 1, false, false);
+            sm_config_set_sideset_pins(&smc, EVE_SCK);
+            sm_config_set_out_pins(&smc, EVE_MOSI, 1);
+            sm_config_set_set_pins(&smc, EVE_CS, 1);
+            sm_config_set_out_shift(&smc, false, true, 8); /* shift left, autopull every 8 bits */
+            sm_config_set_fifo_join(&smc, PIO_FIFO_JOIN_TX);
+            sm_config_set_clkdiv(&smc, (float) clock_get_hz(clk_sys) / (4.0f * (float) EVE_PIO_SPI_FREQ)); /* 4 cycles per bit */
+
+            pio_sm_set_pins_with_mask(EVE_PIO, eve_pio_sm, (1UL << EVE_CS), pin_mask); /* CS high, SCK and MOSI low */
+            pio_sm_set_pindirs_with_mask(EVE_PIO, eve_pio_sm, pin_mask, pin_mask);
+            pio_sm_init(EVE_PIO, eve_pio_sm, offset, &smc);
+            pio_sm_set_enabled(EVE_PIO, eve_pio_sm, true);
+
+            pio_set_irq0_source_enabled(EVE_PIO, pis_interrupt0, true);
+            irq_set_exclusive_handler(EVE_PIO_IRQ, EVE_PIO_handler);
+            irq_set_enabled(EVE_PIO_IRQ, true);
+
+            dma_count = dma_claim_unused_channel(true);
+            dma_header = dma_claim_unused_channel(true);
+            dma_tx = dma_claim_unused_channel(true);
+
+            /* bit-count, 32 bit -> header */
+            cfg = dma_channel_get_default_config(dma_count);
+            channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+            channel_config_set_read_increment(&cfg, false);
+            channel_config_set_dreq(&cfg, pio_get_dreq(EVE_PIO, eve_pio_sm, true));
+            channel_config_set_chain_to(&cfg, dma_header);
+            dma_channel_configure(dma_count, &cfg, &EVE_PIO->txf[eve_pio_sm], &eve_pio_bits, 1, false);
+
+            /* address, 8 bit -> payload */
+            cfg = dma_channel_get_default_config(dma_header);
+            channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+            channel_config_set_dreq(&cfg, pio_get_dreq(EVE_PIO, eve_pio_sm, true));
+            channel_config_set_chain_to(&cfg, dma_tx);
+            dma_channel_configure(dma_header, &cfg, &EVE_PIO->txf[eve_pio_sm], eve_pio_header, 3, false);
+
+            /* payload, 8 bit, the byte is replicated over the FIFO word so the state-machine finds it in the top byte */
+            cfg = dma_channel_get_default_config(dma_tx);
+            channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+            channel_config_set_dreq(&cfg, pio_get_dreq(EVE_PIO, eve_pio_sm, true));
+            dma_channel_configure(dma_tx, &cfg, &EVE_PIO->txf[eve_pio_sm], &EVE_dma_buffer[1], 0, false);
+        }
+
+        void EVE_start_dma_transfer(void)
+        {
+            uint32_t length = ((uint32_t) EVE_dma_buffer_index - 1U) * 4U; /* payload without EVE_dma_buffer[0] */
+
+            EVE_dma_busy = 42;
+            eve_pio_bits = ((length + 3U) * 8U) - 1U;
+            eve_pio_pins_to_pio();
+
+            dma_channel_set_read_addr(dma_header, eve_pio_header, false);
+            dma_channel_set_trans_count(dma_header, 3, false);
+            dma_channel_set_read_addr(dma_tx, &EVE_dma_buffer[1], false);
+            dma_channel_set_trans_count(dma_tx, length, false);
+            dma_channel_set_read_addr(dma_count, &eve_pio_bits, true); /* start the chain */
+        }
+
+        #else
+
         int dma_tx;
         dma_channel_config dma_tx_config;
 
@@ -453,6 +812,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
             dma_hw->ints0 = 1u << dma_tx; /* ack irq */
             while((spi_get_hw(EVE_SPI)->sr & SPI_SSPSR_BSY_BITS) != 0); /* wait for the SPI to be done transmitting */
             EVE_dma_busy = 0;
+            #if defined (EVE_EVENTS)
+            EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+            #endif
             EVE_cs_clear();
         }
 
@@ -477,6 +839,7 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
                 true); // start transfer
             EVE_dma_busy = 42;
         }
+        #endif /* EVE_RP2040_PIO */
         #endif /* DMA */
 
         #endif /* RP2040 */
@@ -573,6 +936,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
                 while((EVE_SPI->SR & LPSPI_SR_TCF_MASK) == 0); /* wait for the SPI to be done transmitting */
                 EVE_cs_clear();
                 EVE_dma_busy = 0;
+                #if defined (EVE_EVENTS)
+                EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+                #endif
                 EVE_SPI->TCR &= ~LPSPI_TCR_RXMSK_MASK; /* enable LPSPI receive */
             }
 
@@ -680,6 +1046,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
                     while(SPI_STAT(SPI0) & SPI_STAT_TRANS) {};
                     EVE_cs_clear();
                     EVE_dma_busy = 0;
+                    #if defined (EVE_EVENTS)
+                    EVE_event_irq(EVE_EVENT_DMA_DONE, 0UL);
+                    #endif
                 }
             }
         #endif /* DMA */
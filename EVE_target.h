@@ -68,6 +68,9 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 - added DMA support for the GD32C103 target
 - moved targets to extra header files: ATSAMC21, ICCAVR, V851, XMEGA, AVR, Tricore, ATSAMx5x
 - moved targets to extra header files: GD32VF103, STM32, ESP32, RP2040, S32K14x, K32L2B31, GD32C103
+- changed the non-DMA Arduino targets ESP8266, BBC_MICROBIT_V2, XMC1100_XMC2GO and generic to collect the bytes of a
+transfer in EVE_spi_buffer and to send these as blocks with wrapper_spi_flush()
+- added a host target: EVE_HOST
 
 */
 
@@ -240,6 +243,14 @@ command buffer is executed by the command co-processor.
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+#if defined (EVE_HOST)
+/* note: set with "-D EVE_HOST" to build the library for a PC, see tools/ */
+#include "EVE_target/EVE_target_host.h"
+#endif /* EVE_HOST */
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 #endif /* __GNUC__ */
 
 /*---------------------------------------------------------------------------*/
@@ -452,6 +463,14 @@ command buffer is executed by the command co-processor.
 #endif
 
     #include <Arduino.h>
+
+    /* the targets without DMA and without a block transfer of their own send the bytes of a transfer in blocks, */
+    /* this needs to be known before EVE_cpp_wrapper.h which only declares the buffer for these */
+    #if !defined (__AVR__) && !defined (ARDUINO_METRO_M4) && !defined (ARDUINO_NUCLEO_F446RE) && !defined (ESP32) && \
+        !defined (ARDUINO_TEENSY41) && !defined (ARDUINO_TEENSY35) && !defined (WIZIOPICO) && !defined (PICOPI)
+        #define EVE_SPI_BUFFER /* see EVE_cpp_wrapper.cpp */
+    #endif
+
     #include "EVE_cpp_wrapper.h"
 
 #ifdef __cplusplus
@@ -671,17 +690,21 @@ extern "C" {
 
         static inline void EVE_cs_clear(void)
         {
+            wrapper_spi_flush();
             digitalWrite(EVE_CS, HIGH); /* tell EVE to stop listen */
         }
 
         static inline void spi_transmit(uint8_t data)
         {
-            wrapper_spi_transmit(data);
+            wrapper_spi_buffer_transmit(data);
         }
 
         static inline void spi_transmit_32(uint32_t data)
         {
-            wrapper_spi_transmit_32(__builtin_bswap32(data));
+            spi_transmit((uint8_t)(data & 0x000000ff));
+            spi_transmit((uint8_t)(data >> 8));
+            spi_transmit((uint8_t)(data >> 16));
+            spi_transmit((uint8_t)(data >> 24));
         }
 
         /* spi_transmit_burst() is only used for cmd-FIFO commands so it *always* has to transfer 4 bytes */
@@ -696,6 +719,7 @@ extern "C" {
 
         static inline uint8_t spi_receive(uint8_t data)
         {
+            wrapper_spi_flush();
             return wrapper_spi_receive(data);
         }
 
@@ -875,12 +899,13 @@ extern "C" {
 
         static inline void EVE_cs_clear(void)
         {
+            wrapper_spi_flush();
             digitalWrite(EVE_CS, HIGH); /* tell EVE to stop listen */
         }
 
         static inline void spi_transmit(uint8_t data)
         {
-            wrapper_spi_transmit(data);
+            wrapper_spi_buffer_transmit(data);
         }
 
         static inline void spi_transmit_32(uint32_t data)
@@ -899,6 +924,7 @@ extern "C" {
 
         static inline uint8_t spi_receive(uint8_t data)
         {
+            wrapper_spi_flush();
             return wrapper_spi_receive(data);
         }
 
@@ -924,12 +950,13 @@ extern "C" {
 
         static inline void EVE_cs_clear(void)
         {
+            wrapper_spi_flush();
             digitalWrite(EVE_CS, HIGH); /* tell EVE to stop listen */
         }
 
         static inline void spi_transmit(uint8_t data)
         {
-            wrapper_spi_transmit(data);
+            wrapper_spi_buffer_transmit(data);
         }
 
         static inline void spi_transmit_32(uint32_t data)
@@ -948,6 +975,7 @@ extern "C" {
 
         static inline uint8_t spi_receive(uint8_t data)
         {
+            wrapper_spi_flush();
             return wrapper_spi_receive(data);
         }
 
@@ -1044,12 +1072,13 @@ extern "C" {
 
         static inline void EVE_cs_clear(void)
         {
+            wrapper_spi_flush();
             digitalWrite(EVE_CS, HIGH); /* tell EVE to stop listen */
         }
 
         static inline void spi_transmit(uint8_t data)
         {
-            wrapper_spi_transmit(data);
+            wrapper_spi_buffer_transmit(data);
         }
 
         static inline void spi_transmit_32(uint32_t data)
@@ -1068,6 +1097,7 @@ extern "C" {
 
         static inline uint8_t spi_receive(uint8_t data)
         {
+            wrapper_spi_flush();
             return wrapper_spi_receive(data);
         }
 
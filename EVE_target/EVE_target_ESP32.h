@@ -26,6 +26,7 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
 5.0
 - extracted from EVE_target.h
+- changed EVE_dma_buffer to a pointer into a pool of EVE_DMA_QUEUE_SIZE buffers
 
 */
 
@@ -43,6 +44,7 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
 #include "freertos/task.h"
+#include "esp_attr.h"
 
 #if !defined (EVE_CS)
     #define EVE_CS      GPIO_NUM_13
@@ -57,6 +59,15 @@ extern spi_device_handle_t EVE_spi_device_simple;
 
 #define EVE_DMA
 
+/* Every EVE_end_cmd_burst() queues the DMA buffer with the SPI driver and continues with the next buffer from a pool. */
+/* Without EVE_DMA_QUEUE defined EVE_start_cmd_burst() still waits for the previous list to be executed. */
+/* With EVE_DMA_QUEUE defined, for example by "build_flags = -D EVE_DMA_QUEUE", it does not and up to */
+/* EVE_DMA_QUEUE_SIZE transfers are in flight, the application then has to make sure that the sum of these does not */
+/* exceed the free space in the command-FIFO, 4092 bytes with an idle co-processor. */
+#if !defined (EVE_DMA_QUEUE_SIZE)
+    #define EVE_DMA_QUEUE_SIZE 3U
+#endif
+
 void DELAY_MS(uint16_t ms);
 
 void EVE_init_spi(void);
@@ -84,7 +95,7 @@ static inline void EVE_pdn_clear(void)
 }
 
 #if defined (EVE_DMA)
-    extern uint32_t EVE_dma_buffer[1025U];
+    extern uint32_t *EVE_dma_buffer;
     extern volatile uint16_t EVE_dma_buffer_index;
     extern volatile uint8_t EVE_dma_busy;
 
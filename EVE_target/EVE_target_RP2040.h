@@ -26,6 +26,8 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
 5.0
 - extracted from EVE_target.h
+- added EVE_RP2040_PIO to send the DMA buffer with a PIO state-machine, see EVE_target.c
+- EVE_RP2040_PIO is single-bit SPI at the clock of the SPI block, it only takes chip-select and the end of the burst off the CPU
 
 */
 
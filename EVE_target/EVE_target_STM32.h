@@ -26,6 +26,7 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
 5.0
 - extracted from EVE_target.h
+- replaced the HAL DMA code with register level DMA for STM32F4 and STM32G4, EVE_DMA also enables spi_transmit_bulk()
 
 */
 
@@ -89,19 +90,51 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
     #define EVE_PDN_PORT GPIOD
     #define EVE_PDN GPIO_PIN_13
     #define EVE_SPI SPI1
-    #define EVE_DMA_INSTANCE DMA2
-    #define EVE_DMA_CHANNEL 3
-    #define EVE_DMA_STREAM 3
-//      #define EVE_DMA     /* do not activate, it is not working yet */
+//      #define EVE_DMA
 #endif
 
 #if defined (EVE_DMA)
+    /* The DMA is used directly without HAL, the defaults are for SPI1 TX. */
+    /* STM32F4: DMA2 Stream 3 Channel 3, STM32G4: DMA1 Channel 1 with DMAMUX request 11 */
+    #if defined (STM32F4)
+        #if !defined (EVE_DMA_STREAM)
+            #define EVE_DMA_INSTANCE DMA2
+            #define EVE_DMA_STREAM DMA2_Stream3
+            #define EVE_DMA_STREAM_NUM 3U
+            #define EVE_DMA_CHANNEL 3U
+            #define EVE_DMA_IRQn DMA2_Stream3_IRQn
+            #define EVE_DMA_IRQHandler DMA2_Stream3_IRQHandler
+        #endif
+    #elif defined (STM32G4)
+        #if !defined (EVE_DMA_CHANNEL)
+            #define EVE_DMA_INSTANCE DMA1
+            #define EVE_DMA_CHANNEL DMA1_Channel1
+            #define EVE_DMA_CHANNEL_NUM 1U
+            #define EVE_DMAMUX_CHANNEL DMAMUX1_Channel0
+            #define EVE_DMA_REQUEST 11U /* SPI1_TX */
+            #define EVE_DMA_IRQn DMA1_Channel1_IRQn
+            #define EVE_DMA_IRQHandler DMA1_Channel1_IRQHandler
+        #endif
+    #else
+        #error "EVE_DMA is only implemented for STM32F4 and STM32G4"
+    #endif
+
+    /* transfers shorter than this are not worth setting up the DMA for */
+    #if !defined (EVE_DMA_BULK_MIN)
+        #define EVE_DMA_BULK_MIN 32U
+    #endif
+
     extern uint32_t EVE_dma_buffer[1025U];
     extern volatile uint16_t EVE_dma_buffer_index;
     extern volatile uint8_t EVE_dma_busy;
 
     void EVE_init_dma(void);
     void EVE_start_dma_transfer(void);
+
+    /* EVE_memWrite_flash_buffer(), EVE_memWrite_sram_buffer() and the commands that use block_transfer() */
+    /* send their data with spi_transmit_bulk(), the DMA reads directly from the buffer in FLASH or RAM */
+    #define EVE_SPI_BULK
+    void spi_transmit_bulk(const uint8_t *data, uint32_t length);
 #endif
 
 #define DELAY_MS(ms) HAL_Delay(ms)
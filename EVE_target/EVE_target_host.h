@@ -0,0 +1,106 @@
+/*
+@file    EVE_target_host.h
+@brief   target specific includes, definitions and functions
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- added a host target to build the library and the tools in tools/ on a PC
+
+*/
+
+
+#ifndef EVE_TARGET_HOST_H
+#define EVE_TARGET_HOST_H
+
+#pragma once
+
+/* note: set with "-D EVE_HOST" when compiling for a PC, see tools/Makefile */
+#if defined (EVE_HOST)
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* There is no SPI on a PC, the program that uses the library on the host provides these functions. */
+/* This can be a USB to SPI bridge, a recorder or a simulation of EVE. */
+void EVE_host_cs_set(void);
+void EVE_host_cs_clear(void);
+void EVE_host_pdn_set(void);
+void EVE_host_pdn_clear(void);
+uint8_t EVE_host_spi_transfer(uint8_t data);
+void EVE_host_delay_ms(uint16_t val);
+
+#define DELAY_MS(ms) EVE_host_delay_ms(ms)
+
+static inline void EVE_pdn_set(void)
+{
+    EVE_host_pdn_set(); /* Power-Down low */
+}
+
+static inline void EVE_pdn_clear(void)
+{
+    EVE_host_pdn_clear(); /* Power-Down high */
+}
+
+static inline void EVE_cs_set(void)
+{
+    EVE_host_cs_set(); /* CS low */
+}
+
+static inline void EVE_cs_clear(void)
+{
+    EVE_host_cs_clear(); /* CS high */
+}
+
+static inline void spi_transmit(uint8_t data)
+{
+    (void) EVE_host_spi_transfer(data);
+}
+
+static inline void spi_transmit_32(uint32_t data)
+{
+    spi_transmit((uint8_t)(data & 0x000000ffUL));
+    spi_transmit((uint8_t)(data >> 8U));
+    spi_transmit((uint8_t)(data >> 16U));
+    spi_transmit((uint8_t)(data >> 24U));
+}
+
+/* spi_transmit_burst() is only used for cmd-FIFO commands so it *always* has to transfer 4 bytes */
+static inline void spi_transmit_burst(uint32_t data)
+{
+    spi_transmit_32(data);
+}
+
+static inline uint8_t spi_receive(uint8_t data)
+{
+    return EVE_host_spi_transfer(data);
+}
+
+static inline uint8_t fetch_flash_byte(const uint8_t *data)
+{
+    return *data;
+}
+
+#endif /* EVE_HOST */
+
+#endif /* EVE_TARGET_HOST_H */
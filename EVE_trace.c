@@ -0,0 +1,251 @@
+/*
+@file    EVE_trace.c
+@brief   records the SPI transactions with EVE in a ring buffer to find out what went over the bus
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+@section History
+
+5.0
+- initial version
+- added EVE_TRACE_FULL to keep all bytes of every transaction for an exact replay
+
+*/
+
+#include "EVE_trace.h"
+
+#if defined (EVE_TRACE)
+
+#if defined (EVE_TRACE_FULL)
+#define EVE_TRACE_KEEP(length) (1)
+#else
+#define EVE_TRACE_KEEP(length) ((length) < EVE_TRACE_PAYLOAD_MAX)
+#endif
+
+static uint8_t trace_buffer[EVE_TRACE_SIZE];
+static uint32_t trace_head;    /* next byte to write */
+static uint8_t trace_wrapped;  /* the buffer is full and the oldest bytes are overwritten */
+static uint8_t trace_enabled = 1U;
+static uint8_t trace_open;     /* a frame is started */
+static uint32_t trace_length;  /* bytes of the current transaction */
+
+static void eve_trace_put(uint8_t data)
+{
+    trace_buffer[trace_head] = data;
+    trace_head++;
+    if (trace_head >= EVE_TRACE_SIZE)
+    {
+        trace_head = 0U;
+        trace_wrapped = 1U;
+    }
+}
+
+static void eve_trace_put_escaped(uint8_t data)
+{
+    if ((EVE_TRACE_FLAG == data) || (EVE_TRACE_ESCAPE == data))
+    {
+        eve_trace_put(EVE_TRACE_ESCAPE);
+        eve_trace_put(data ^ EVE_TRACE_XOR);
+    }
+    else
+    {
+        eve_trace_put(data);
+    }
+}
+
+static void eve_trace_put_32(uint32_t data)
+{
+    eve_trace_put_escaped((uint8_t) data);
+    eve_trace_put_escaped((uint8_t) (data >> 8U));
+    eve_trace_put_escaped((uint8_t) (data >> 16U));
+    eve_trace_put_escaped((uint8_t) (data >> 24U));
+}
+
+static void eve_trace_byte(uint8_t data)
+{
+    if (trace_open != 0U)
+    {
+        if (EVE_TRACE_KEEP(trace_length))
+        {
+            eve_trace_put_escaped(data);
+        }
+        trace_length++;
+    }
+}
+
+/* Stops or resumes recording, stopping right after a glitch was detected keeps the transactions that led to it. */
+void EVE_trace_enable(uint8_t enable)
+{
+    trace_enabled = enable;
+}
+
+void EVE_trace_clear(void)
+{
+    trace_head = 0U;
+    trace_wrapped = 0U;
+    trace_open = 0U;
+}
+
+/* Copies the recorded bytes oldest first to the buffer, returns the number of bytes copied. */
+uint32_t EVE_trace_read(uint8_t *buffer, uint32_t size)
+{
+    uint32_t count = 0U;
+
+    if (trace_wrapped != 0U)
+    {
+        for (uint32_t index = trace_head; (index < EVE_TRACE_SIZE) && (count < size); index++)
+        {
+            buffer[count] = trace_buffer[index];
+            count++;
+        }
+    }
+    for (uint32_t index = 0U; (index < trace_head) && (count < size); index++)
+    {
+        buffer[count] = trace_buffer[index];
+        count++;
+    }
+    return count;
+}
+
+/* Hands the recorded bytes oldest first to a write function, e.g. for an UART or a file. */
+/* Recording is paused meanwhile so the dump itself does not change the buffer when the function uses EVE. */
+void EVE_trace_dump(void (*write)(const uint8_t *data, uint32_t length))
+{
+    uint8_t enabled = trace_enabled;
+
+    trace_enabled = 0U;
+    if (trace_wrapped != 0U)
+    {
+        write(&trace_buffer[trace_head], EVE_TRACE_SIZE - trace_head);
+    }
+    if (trace_head != 0U)
+    {
+        write(trace_buffer, trace_head);
+    }
+    trace_enabled = enabled;
+}
+
+/* Starts a frame, also used for transfers that do not use EVE_cs_set() like the DMA of EVE_end_cmd_burst(). */
+void EVE_trace_begin(void)
+{
+    if (trace_enabled != 0U)
+    {
+        eve_trace_put(EVE_TRACE_FLAG);
+        eve_trace_put_32(EVE_TRACE_TIME());
+        trace_length = 0UL;
+        trace_open = 1U;
+    }
+}
+
+void EVE_trace_end(void)
+{
+    if (trace_open != 0U)
+    {
+        eve_trace_put_32(trace_length);
+        trace_open = 0U;
+    }
+}
+
+/* Records a byte of the current frame without sending it. */
+void EVE_trace_byte(uint8_t data)
+{
+    eve_trace_byte(data);
+}
+
+void EVE_trace_cs_set(void)
+{
+    EVE_trace_begin();
+    EVE_cs_set();
+}
+
+void EVE_trace_cs_clear(void)
+{
+    EVE_cs_clear();
+    EVE_trace_end();
+}
+
+void EVE_trace_spi_transmit(uint8_t data)
+{
+    spi_transmit(data);
+    eve_trace_byte(data);
+}
+
+void EVE_trace_spi_transmit_32(uint32_t data)
+{
+    spi_transmit_32(data);
+    eve_trace_byte((uint8_t) data);
+    eve_trace_byte((uint8_t) (data >> 8U));
+    eve_trace_byte((uint8_t) (data >> 16U));
+    eve_trace_byte((uint8_t) (data >> 24U));
+}
+
+void EVE_trace_spi_transmit_burst(uint32_t data)
+{
+    spi_transmit_burst(data);
+    eve_trace_byte((uint8_t) data);
+    eve_trace_byte((uint8_t) (data >> 8U));
+    eve_trace_byte((uint8_t) (data >> 16U));
+    eve_trace_byte((uint8_t) (data >> 24U));
+}
+
+uint8_t EVE_trace_spi_receive(uint8_t data)
+{
+    uint8_t received = spi_receive(data);
+
+    eve_trace_byte(received);
+    return received;
+}
+
+#if defined (EVE_SPI_BULK)
+void EVE_trace_spi_transmit_bulk(const uint8_t *data, uint32_t length)
+{
+    spi_transmit_bulk(data, length);
+    if (trace_open != 0U)
+    {
+        uint32_t count = length;
+
+#if defined (EVE_TRACE_FULL)
+        for (uint32_t index = 0U; index < length; index++)
+        {
+            eve_trace_byte(fetch_flash_byte(&data[index]));
+        }
+        count = 0U;
+#else
+        if (trace_length < EVE_TRACE_PAYLOAD_MAX)
+        {
+            count = EVE_TRACE_PAYLOAD_MAX - trace_length;
+            count = (count < length) ? count : length;
+            for (uint32_t index = 0U; index < count; index++)
+            {
+                eve_trace_byte(fetch_flash_byte(&data[index]));
+            }
+            count = length - count;
+        }
+#endif
+        trace_length += count;
+    }
+}
+#endif
+
+#endif /* EVE_TRACE */
@@ -0,0 +1,96 @@
+/*
+@file    EVE_trace.h
+@brief   contains the prototypes and the trace format for the optional SPI transaction recorder
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+- added EVE_TRACE_FULL to keep all bytes of every transaction for an exact replay
+
+*/
+
+#ifndef EVE_TRACE_H
+#define EVE_TRACE_H
+
+#pragma once
+
+#include "EVE.h"
+
+/* Set with "-D EVE_TRACE" to record every SPI transaction of EVE_commands.c in a ring buffer,
+ * without it EVE_commands.c calls the target functions directly and nothing of this module is used. */
+
+/* Size of the ring buffer in bytes, the oldest transactions are overwritten. */
+#if !defined (EVE_TRACE_SIZE)
+#define EVE_TRACE_SIZE 2048U
+#endif
+
+/* Bytes per transaction that are kept, longer transfers like images are cut off but the length is still recorded. */
+#if !defined (EVE_TRACE_PAYLOAD_MAX)
+#define EVE_TRACE_PAYLOAD_MAX 16U
+#endif
+
+/* Set with "-D EVE_TRACE_FULL" to keep all bytes of every transaction instead, the frames then have the full length.
+ * This is what tools/eve_replay needs to send the same display lists and images again, EVE_TRACE_SIZE then needs to
+ * hold all transactions from EVE_init() on, e.g. "-D EVE_TRACE_SIZE=262144U". */
+
+/* The timestamp of a transaction, for example a millisecond counter or a free running timer,
+ * e.g. "-D EVE_TRACE_TIME()=millis()" for Arduino, the function needs to be declared thru EVE_target.h. */
+#if !defined (EVE_TRACE_TIME)
+#define EVE_TRACE_TIME() 0UL
+#endif
+
+/* The trace format:
+ * Each transaction is a frame that starts with EVE_TRACE_FLAG, so a reader can sync to the first complete frame
+ * after the ring buffer wrapped around. EVE_TRACE_FLAG and EVE_TRACE_ESCAPE in the frame are sent as EVE_TRACE_ESCAPE
+ * followed by the byte xor EVE_TRACE_XOR.
+ * frame: flag, timestamp (4 bytes, little endian), up to EVE_TRACE_PAYLOAD_MAX bytes or all with EVE_TRACE_FULL,
+ * length (4 bytes, little endian)
+ * The first byte tells the direction: 0x80 set is a memory write, 0x40 set is a host command, otherwise it is a read.
+ * The bytes are the ones written, for reads the address, the dummy byte and then the bytes received from EVE. */
+#define EVE_TRACE_FLAG 0x7eU
+#define EVE_TRACE_ESCAPE 0x7dU
+#define EVE_TRACE_XOR 0x20U
+
+void EVE_trace_enable(uint8_t enable);
+void EVE_trace_clear(void);
+uint32_t EVE_trace_read(uint8_t *buffer, uint32_t size);
+void EVE_trace_dump(void (*write)(const uint8_t *data, uint32_t length));
+
+/* the hooks for EVE_commands.c */
+void EVE_trace_begin(void);
+void EVE_trace_end(void);
+void EVE_trace_byte(uint8_t data);
+void EVE_trace_cs_set(void);
+void EVE_trace_cs_clear(void);
+void EVE_trace_spi_transmit(uint8_t data);
+void EVE_trace_spi_transmit_32(uint32_t data);
+void EVE_trace_spi_transmit_burst(uint32_t data);
+uint8_t EVE_trace_spi_receive(uint8_t data);
+#if defined (EVE_SPI_BULK)
+void EVE_trace_spi_transmit_bulk(const uint8_t *data, uint32_t length);
+#endif
+
+#endif /* EVE_TRACE_H */
@@ -0,0 +1,285 @@
+/*
+@file    EVE_upload.c
+@brief   selects the fastest way to upload an asset to RAM_G with a cost model calibrated at runtime
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#include "EVE_upload.h"
+
+#if defined (__AVR__)
+    #include <avr/pgmspace.h>
+#else
+    #if !defined(PROGMEM)
+        #define PROGMEM
+    #endif
+#endif
+
+/* The time for an upload is estimated as the SPI transfer plus the decoding by the co-processor, block_transfer() */
+/* waits for the co-processor after every block so the two add up. The rates are measured with REG_CLOCK, */
+/* once with EVE_upload_calibrate() and then again with every upload by EVE_upload() to follow the real data. */
+
+/* a 64x32 RGB565 test pattern, 4096 bytes compressed to 987 bytes, this is similar to typical UI graphics */
+static const uint8_t eve_upload_sample[987] PROGMEM =
+{
+    0x78, 0xDA, 0x2D, 0xC2, 0x37, 0x3C, 0x18, 0x61, 0x00, 0xC6, 0x61, 0x12, 0xE4, 0x1B, 0x75, 0xE3,
+    0xE9, 0x56, 0xDD, 0x2A, 0xEA, 0x8D, 0xBA, 0xF1, 0xD3, 0x22, 0x6B, 0x44, 0x5B, 0xB5, 0x70, 0xA3,
+    0x6E, 0x3C, 0xDD, 0xAA, 0x5B, 0x75, 0x37, 0x6A, 0x61, 0x3C, 0x91, 0x60, 0x8D, 0x04, 0x59, 0x33,
+    0xFC, 0xDF, 0xDF, 0xF3, 0x98, 0x08, 0x83, 0x58, 0x38, 0xA9, 0x92, 0x0B, 0x53, 0x2A, 0x35, 0x70,
+    0x5A, 0xE4, 0x0B, 0xCC, 0x80, 0x8C, 0xC3, 0x99, 0x97, 0x75, 0x98, 0x7D, 0x39, 0x87, 0x73, 0x27,
+    0xBF, 0xE1, 0x46, 0x48, 0x2C, 0x6C, 0xAA, 0xE4, 0xC2, 0x2D, 0x95, 0x1A, 0xD8, 0x16, 0xF9, 0x02,
+    0x77, 0x40, 0xC6, 0x61, 0xE7, 0x65, 0x1D, 0xEE, 0xBE, 0x9C, 0xC3, 0xDE, 0xC9, 0x6F, 0x78, 0x11,
+    0x12, 0x0B, 0x3F, 0x55, 0x72, 0xE1, 0x95, 0x4A, 0x0D, 0xFC, 0x16, 0xF9, 0x02, 0x6F, 0x40, 0xC6,
+    0xE1, 0xCF, 0xCB, 0x3A, 0xBC, 0x7D, 0x39, 0x87, 0x7F, 0x27, 0xBF, 0x11, 0x44, 0x48, 0x2C, 0xC2,
+    0x54, 0xC9, 0x45, 0x50, 0x2A, 0x35, 0x08, 0x5B, 0xE4, 0x0B, 0x82, 0x01, 0x19, 0x47, 0x38, 0x2F,
+    0xEB, 0x08, 0xF6, 0xE5, 0x1C, 0xE1, 0x9D, 0xFC, 0x86, 0x89, 0x94, 0x38, 0x38, 0x69, 0x92, 0x07,
+    0xF3, 0x51, 0x6A, 0xE1, 0xB4, 0x4A, 0x17, 0xCC, 0xA0, 0x4C, 0xC0, 0x59, 0x90, 0x0D, 0x98, 0x03,
+    0xB9, 0x80, 0xF3, 0x43, 0x9E, 0xE1, 0x46, 0x4A, 0x1C, 0x6C, 0x9A, 0xE4, 0xC1, 0xFD, 0x28, 0xB5,
+    0xB0, 0xAD, 0xD2, 0x05, 0x77, 0x50, 0x26, 0x60, 0x17, 0x64, 0x03, 0xEE, 0x81, 0x5C, 0xC0, 0xFE,
+    0x90, 0x67, 0x78, 0x91, 0x12, 0x07, 0x3F, 0x4D, 0xF2, 0xE0, 0x7D, 0x94, 0x5A, 0xF8, 0xAD, 0xD2,
+    0x05, 0x6F, 0x50, 0x26, 0xE0, 0x2F, 0xC8, 0x06, 0xBC, 0x03, 0xB9, 0x80, 0xFF, 0x43, 0x9E, 0x11,
+    0x44, 0x4A, 0x1C, 0xC2, 0x34, 0xC9, 0x43, 0xF0, 0x51, 0x6A, 0x11, 0xB6, 0x4A, 0x17, 0x82, 0x41,
+    0x99, 0x40, 0xB8, 0x20, 0x1B, 0x08, 0x0E, 0xE4, 0x02, 0xE1, 0x0F, 0x79, 0x86, 0xF3, 0x4E, 0xE2,
+    0x61, 0xD2, 0x25, 0x1F, 0x4E, 0x99, 0xD4, 0xC1, 0xB4, 0xC9, 0x57, 0x38, 0x43, 0x32, 0x09, 0xB3,
+    0x28, 0x9B, 0x70, 0x0E, 0xE5, 0x12, 0xE6, 0x5E, 0xFE, 0xC0, 0xBE, 0x93, 0x78, 0xB8, 0xE9, 0x92,
+    0x0F, 0x5B, 0x26, 0x75, 0x70, 0xDB, 0xE4, 0x2B, 0xEC, 0x90, 0x4C, 0xC2, 0x5D, 0x94, 0x4D, 0xD8,
+    0x43, 0xB9, 0x84, 0x7B, 0x2F, 0x7F, 0xE0, 0xBF, 0x93, 0x78, 0x78, 0xE9, 0x92, 0x0F, 0xBF, 0x4C,
+    0xEA, 0xE0, 0xB5, 0xC9, 0x57, 0xF8, 0x43, 0x32, 0x09, 0x6F, 0x51, 0x36, 0xE1, 0x1F, 0xCA, 0x25,
+    0xBC, 0x7B, 0xF9, 0x83, 0xF0, 0x9D, 0xC4, 0x23, 0x48, 0x97, 0x7C, 0x84, 0x65, 0x52, 0x87, 0xA0,
+    0x4D, 0xBE, 0x22, 0x1C, 0x92, 0x49, 0x04, 0x8B, 0xB2, 0x89, 0xF0, 0x50, 0x2E, 0x11, 0xDC, 0xCB,
+    0x1F, 0x38, 0xEF, 0x25, 0x01, 0x26, 0x43, 0x0A, 0xE0, 0x94, 0x4B, 0x3D, 0x4C, 0xBB, 0x74, 0xC3,
+    0x19, 0x96, 0x29, 0x98, 0x25, 0xD9, 0x82, 0x73, 0x24, 0x57, 0x30, 0x3F, 0xE5, 0x2F, 0xEC, 0x7B,
+    0x49, 0x80, 0x9B, 0x21, 0x05, 0xB0, 0xE5, 0x52, 0x0F, 0xB7, 0x5D, 0xBA, 0x61, 0x87, 0x65, 0x0A,
+    0xEE, 0x92, 0x6C, 0xC1, 0x1E, 0xC9, 0x15, 0xDC, 0x9F, 0xF2, 0x17, 0xFE, 0x7B, 0x49, 0x80, 0x97,
+    0x21, 0x05, 0xF0, 0xCB, 0xA5, 0x1E, 0x5E, 0xBB, 0x74, 0xC3, 0x1F, 0x96, 0x29, 0x78, 0x4B, 0xB2,
+    0x05, 0xFF, 0x48, 0xAE, 0xE0, 0xFD, 0x94, 0xBF, 0x08, 0xDF, 0x4B, 0x02, 0x82, 0x0C, 0x29, 0x40,
+    0x58, 0x2E, 0xF5, 0x08, 0xDA, 0xA5, 0x1B, 0xE1, 0xB0, 0x4C, 0x21, 0x58, 0x92, 0x2D, 0x84, 0x47,
+    0x72, 0x85, 0xE0, 0xA7, 0xFC, 0x85, 0x89, 0x92, 0x44, 0x38, 0x99, 0x52, 0x08, 0x53, 0x21, 0x0D,
+    0x70, 0x3A, 0xA4, 0x07, 0x66, 0x44, 0xA6, 0xE1, 0x2C, 0xCB, 0x36, 0xCC, 0xB1, 0x5C, 0xC3, 0xF9,
+    0x25, 0x2F, 0x70, 0xA3, 0x24, 0x11, 0x36, 0x53, 0x0A, 0xE1, 0x56, 0x48, 0x03, 0x6C, 0x87, 0xF4,
+    0xC0, 0x1D, 0x91, 0x69, 0xD8, 0x65, 0xD9, 0x86, 0x7B, 0x2C, 0xD7, 0xB0, 0xBF, 0xE4, 0x05, 0x5E,
+    0x94, 0x24, 0xC2, 0xCF, 0x94, 0x42, 0x78, 0x15, 0xD2, 0x00, 0xBF, 0x43, 0x7A, 0xE0, 0x8D, 0xC8,
+    0x34, 0xFC, 0x65, 0xD9, 0x86, 0x77, 0x2C, 0xD7, 0xF0, 0x7F, 0xC9, 0x0B, 0x82, 0x28, 0x49, 0x44,
+    0x98, 0x29, 0x85, 0x08, 0x2A, 0xA4, 0x01, 0x61, 0x87, 0xF4, 0x20, 0x18, 0x91, 0x69, 0x84, 0xCB,
+    0xB2, 0x8D, 0xE0, 0x58, 0xAE, 0x11, 0xFE, 0x92, 0x17, 0x98, 0x68, 0x49, 0x82, 0x93, 0x25, 0x45,
+    0x30, 0x95, 0xD2, 0x08, 0xE7, 0x93, 0xF4, 0xC2, 0x7C, 0x93, 0x19, 0x38, 0x2B, 0xB2, 0x03, 0x73,
+    0x22, 0xDF, 0xE1, 0x3C, 0xC8, 0x2B, 0xDC, 0x68, 0x49, 0x82, 0xCD, 0x92, 0x22, 0xB8, 0x95, 0xD2,
+    0x08, 0xFB, 0x49, 0x7A, 0xE1, 0x7E, 0x93, 0x19, 0xD8, 0x15, 0xD9, 0x81, 0x7B, 0x22, 0xDF, 0x61,
+    0x1F, 0xE4, 0x15, 0x5E, 0xB4, 0x24, 0xC1, 0xCF, 0x92, 0x22, 0x78, 0x95, 0xD2, 0x08, 0xFF, 0x93,
+    0xF4, 0xC2, 0xFB, 0x26, 0x33, 0xF0, 0x57, 0x64, 0x07, 0xDE, 0x89, 0x7C, 0x87, 0xFF, 0x20, 0xAF,
+    0x08, 0xA2, 0x25, 0x09, 0x61, 0x96, 0x14, 0x21, 0xA8, 0x94, 0x46, 0x84, 0x9F, 0xA4, 0x17, 0xC1,
+    0x37, 0x99, 0x41, 0xB8, 0x22, 0x3B, 0x08, 0x4E, 0xE4, 0x3B, 0xC2, 0x07, 0x79, 0x85, 0x13, 0x23,
+    0xC9, 0x30, 0xD9, 0x52, 0x0C, 0xA7, 0x4A, 0x9A, 0x60, 0x3A, 0xA5, 0x0F, 0xCE, 0xA8, 0xCC, 0xC2,
+    0xAC, 0xCA, 0x2E, 0x9C, 0x53, 0xB9, 0x81, 0x79, 0x94, 0x37, 0xD8, 0x18, 0x49, 0x86, 0x9B, 0x2D,
+    0xC5, 0xB0, 0x55, 0xD2, 0x04, 0xB7, 0x53, 0xFA, 0x60, 0x47, 0x65, 0x16, 0xEE, 0xAA, 0xEC, 0xC2,
+    0x9E, 0xCA, 0x0D, 0xDC, 0x47, 0x79, 0x83, 0x1F, 0x23, 0xC9, 0xF0, 0xB2, 0xA5, 0x18, 0x7E, 0x95,
+    0x34, 0xC1, 0xEB, 0x94, 0x3E, 0xF8, 0xA3, 0x32, 0x0B, 0x6F, 0x55, 0x76, 0xE1, 0x9F, 0xCA, 0x0D,
+    0xBC, 0x47, 0x79, 0x43, 0x18, 0x23, 0xC9, 0x08, 0xB2, 0xA5, 0x18, 0x61, 0x95, 0x34, 0x21, 0xE8,
+    0x94, 0x3E, 0x84, 0xA3, 0x32, 0x8B, 0x60, 0x55, 0x76, 0x11, 0x9E, 0xCA, 0x0D, 0x82, 0x47, 0x79,
+    0x83, 0xF3, 0x41, 0x52, 0x60, 0x72, 0xA4, 0x04, 0x4E, 0xB5, 0x34, 0xC3, 0x7C, 0x96, 0x7E, 0x38,
+    0x63, 0x32, 0x07, 0xB3, 0x26, 0x7B, 0x70, 0xCE, 0xE4, 0x16, 0xE6, 0x49, 0xFE, 0xC1, 0x7E, 0x90,
+    0x14, 0xB8, 0x39, 0x52, 0x02, 0x5B, 0x2D, 0xCD, 0x70, 0x3F, 0x4B, 0x3F, 0xEC, 0x98, 0xCC, 0xC1,
+    0x5D, 0x93, 0x3D, 0xD8, 0x33, 0xB9, 0x85, 0xFB, 0x24, 0xFF, 0xE0, 0x7F, 0x90, 0x14, 0x78, 0x39,
+    0x52, 0x02, 0xBF, 0x5A, 0x9A, 0xE1, 0x7D, 0x96, 0x7E, 0xF8, 0x63, 0x32, 0x07, 0x6F, 0x4D, 0xF6,
+    0xE0, 0x9F, 0xC9, 0x2D, 0xBC, 0x27, 0xF9, 0x87, 0xF0, 0x83, 0xA4, 0x20, 0xC8, 0x91, 0x12, 0x84,
+    0xD5, 0xD2, 0x8C, 0xE0, 0xB3, 0xF4, 0x23, 0x1C, 0x93, 0x39, 0x04, 0x6B, 0xB2, 0x87, 0xF0, 0x4C,
+    0x6E, 0x11, 0x3C, 0xC9, 0x3F, 0xFC, 0x07, 0x10, 0x02, 0x78, 0x6A,
+};
+
+#define EVE_UPLOAD_SAMPLE_DECODED 4096UL
+
+/* defaults for 20 MHz SPI and the decode rates tools/eve_asset assumes, these are replaced by measurements */
+static EVE_upload_model_t eve_upload_model = {2500UL, 8000UL, 1000UL, 2000UL};
+static uint32_t eve_upload_frequency = 0UL; /* REG_FREQUENCY */
+
+static uint32_t eve_upload_rate(uint32_t bytes, uint32_t ticks)
+{
+    uint64_t rate;
+
+    if (0UL == ticks)
+    {
+        ticks = 1UL;
+    }
+    rate = ((uint64_t) bytes * (uint64_t) eve_upload_frequency) / ((uint64_t) ticks * 1000ULL);
+    if (rate < 1ULL)
+    {
+        rate = 1ULL;
+    }
+    return (rate > 0xffffffffULL) ? 0xffffffffUL : (uint32_t) rate;
+}
+
+/* time in microseconds to process bytes at rate bytes per millisecond */
+static uint32_t eve_upload_us(uint32_t bytes, uint32_t rate)
+{
+    return (uint32_t) (((uint64_t) bytes * 1000ULL) / (uint64_t) ((0UL == rate) ? 1UL : rate));
+}
+
+/* follow the measurements with some damping */
+static void eve_upload_learn(uint32_t *rate, uint32_t measured)
+{
+    *rate = (uint32_t) ((((uint64_t) *rate * 3ULL) + (uint64_t) measured) / 4ULL);
+}
+
+/* the rate of the co-processor from the total time minus the time for the SPI transfer */
+static uint32_t eve_upload_decode_rate(uint32_t decoded, uint32_t transferred, uint32_t ticks)
+{
+    uint32_t transfer = (uint32_t) (((uint64_t) transferred * (uint64_t) eve_upload_frequency) /
+                                    ((uint64_t) eve_upload_model.bus * 1000ULL));
+
+    ticks = (ticks > transfer) ? (ticks - transfer) : (ticks / 8UL);
+    return eve_upload_rate(decoded, ticks);
+}
+
+static uint8_t eve_upload_is_png(const uint8_t *image)
+{
+    return ((0x89U == fetch_flash_byte(image)) && ('P' == fetch_flash_byte(&image[1]))) ? 1U : 0U;
+}
+
+/* This is meant to be called outside display-list building, it includes executing the command and waiting for completion. */
+/* Measures the SPI throughput and the CMD_INFLATE rate, scratch is an area of EVE_UPLOAD_SCRATCH_SIZE bytes in RAM_G. */
+/* The decode rates for CMD_LOADIMAGE are measured by the first uploads with EVE_upload(). */
+void EVE_upload_calibrate(uint32_t scratch)
+{
+    uint32_t start;
+    uint32_t ticks;
+
+    eve_upload_frequency = EVE_memRead32(REG_FREQUENCY);
+
+    start = EVE_memRead32(REG_CLOCK);
+    for (uint32_t offset = 0UL; offset < 4UL * sizeof(eve_upload_sample); offset += sizeof(eve_upload_sample))
+    {
+        EVE_memWrite_flash_buffer(scratch, eve_upload_sample, sizeof(eve_upload_sample));
+    }
+    ticks = EVE_memRead32(REG_CLOCK) - start;
+    eve_upload_model.bus = eve_upload_rate(4UL * sizeof(eve_upload_sample), ticks);
+
+    start = EVE_memRead32(REG_CLOCK);
+    EVE_cmd_inflate(scratch, eve_upload_sample, sizeof(eve_upload_sample));
+    ticks = EVE_memRead32(REG_CLOCK) - start;
+    eve_upload_model.inflate = eve_upload_decode_rate(EVE_UPLOAD_SAMPLE_DECODED, sizeof(eve_upload_sample), ticks);
+}
+
+/* The model can be stored and restored to skip the calibration on the next start. */
+void EVE_upload_get_model(EVE_upload_model_t *model)
+{
+    *model = eve_upload_model;
+}
+
+void EVE_upload_set_model(const EVE_upload_model_t *model)
+{
+    eve_upload_model = *model;
+}
+
+/* Returns the estimated time in microseconds to upload the asset with EVE_ASSET_RAW, EVE_ASSET_INFLATE or */
+/* EVE_ASSET_LOADIMAGE or 0xffffffff if the asset is not available in that encoding. */
+uint32_t EVE_upload_estimate(const EVE_upload_asset_t *asset, uint8_t method)
+{
+    uint32_t estimate = 0xffffffffUL;
+
+    if ((EVE_ASSET_RAW == method) && (asset->raw != NULL))
+    {
+        estimate = eve_upload_us(asset->raw_len, eve_upload_model.bus);
+    }
+    else if ((EVE_ASSET_INFLATE == method) && (asset->zlib != NULL))
+    {
+        estimate = eve_upload_us(asset->zlib_len, eve_upload_model.bus) +
+                   eve_upload_us(asset->decoded_len, eve_upload_model.inflate);
+    }
+    else if ((EVE_ASSET_LOADIMAGE == method) && (asset->image != NULL))
+    {
+        uint32_t rate = (eve_upload_is_png(asset->image) != 0U) ? eve_upload_model.png : eve_upload_model.jpeg;
+
+        estimate = eve_upload_us(asset->image_len, eve_upload_model.bus) + eve_upload_us(asset->decoded_len, rate);
+    }
+    else
+    {
+        /* not available */
+    }
+    return estimate;
+}
+
+/* Returns the encoding with the lowest estimated time or EVE_ASSET_NONE if there is no data at all. */
+uint8_t EVE_upload_select(const EVE_upload_asset_t *asset)
+{
+    uint8_t best = EVE_ASSET_NONE;
+    uint32_t best_time = 0xffffffffUL;
+
+    for (uint8_t method = EVE_ASSET_RAW; method <= EVE_ASSET_LOADIMAGE; method++)
+    {
+        uint32_t estimate = EVE_upload_estimate(asset, method);
+
+        if ((estimate != 0xffffffffUL) && ((EVE_ASSET_NONE == best) || (estimate < best_time)))
+        {
+            best = method;
+            best_time = estimate;
+        }
+    }
+    return best;
+}
+
+/* This is meant to be called outside display-list building, it includes executing the command and waiting for completion. */
+/* Uploads the asset to address in RAM_G with the encoding that has the lowest estimated time, the time it took */
+/* is used to refine the model. Returns the encoding that was used or EVE_ASSET_NONE. */
+uint8_t EVE_upload(uint32_t address, const EVE_upload_asset_t *asset)
+{
+    uint8_t method = EVE_upload_select(asset);
+    uint32_t start;
+    uint32_t ticks;
+
+    if (0UL == eve_upload_frequency)
+    {
+        eve_upload_frequency = EVE_memRead32(REG_FREQUENCY);
+    }
+
+    start = EVE_memRead32(REG_CLOCK);
+    switch (method)
+    {
+        case EVE_ASSET_RAW:
+            EVE_memWrite_flash_buffer(address, asset->raw, asset->raw_len);
+            ticks = EVE_memRead32(REG_CLOCK) - start;
+            eve_upload_learn(&eve_upload_model.bus, eve_upload_rate(asset->raw_len, ticks));
+            break;
+        case EVE_ASSET_INFLATE:
+            EVE_cmd_inflate(address, asset->zlib, asset->zlib_len);
+            ticks = EVE_memRead32(REG_CLOCK) - start;
+            eve_upload_learn(&eve_upload_model.inflate,
+                             eve_upload_decode_rate(asset->decoded_len, asset->zlib_len, ticks));
+            break;
+        case EVE_ASSET_LOADIMAGE:
+            EVE_cmd_loadimage(address, asset->options, asset->image, asset->image_len);
+            ticks = EVE_memRead32(REG_CLOCK) - start;
+            eve_upload_learn((eve_upload_is_png(asset->image) != 0U) ? &eve_upload_model.png : &eve_upload_model.jpeg,
+                             eve_upload_decode_rate(asset->decoded_len, asset->image_len, ticks));
+            break;
+        default:
+            break;
+    }
+    return method;
+}
@@ -0,0 +1,80 @@
+/*
+@file    EVE_upload.h
+@brief   contains the prototypes for the upload strategy selector
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#ifndef EVE_UPLOAD_H
+#define EVE_UPLOAD_H
+
+#pragma once
+
+#include "EVE.h"
+
+/* the same values as in the headers generated by tools/eve_asset */
+#if !defined (EVE_ASSET_RAW)
+#define EVE_ASSET_RAW 0U       /* EVE_memWrite_flash_buffer() */
+#define EVE_ASSET_INFLATE 1U   /* EVE_cmd_inflate() */
+#define EVE_ASSET_LOADIMAGE 2U /* EVE_cmd_loadimage() */
+#endif
+#define EVE_ASSET_NONE 0xffU
+
+#define EVE_UPLOAD_SCRATCH_SIZE 4096UL /* RAM_G needed by EVE_upload_calibrate() */
+
+/* An asset in one or more encodings, data that is not available is NULL. */
+typedef struct
+{
+    const uint8_t *raw;    /* the data as it is in RAM_G */
+    uint32_t raw_len;
+    const uint8_t *zlib;   /* zlib compressed for CMD_INFLATE */
+    uint32_t zlib_len;
+    const uint8_t *image;  /* PNG or JPEG for CMD_LOADIMAGE */
+    uint32_t image_len;
+    uint32_t decoded_len;  /* size in RAM_G */
+    uint32_t options;      /* options for CMD_LOADIMAGE, e.g. EVE_OPT_NODL */
+} EVE_upload_asset_t;
+
+/* the cost model, all rates are in bytes per millisecond */
+typedef struct
+{
+    uint32_t bus;     /* SPI transfers to RAM_G */
+    uint32_t inflate; /* output of CMD_INFLATE */
+    uint32_t png;     /* output of CMD_LOADIMAGE for PNG */
+    uint32_t jpeg;    /* output of CMD_LOADIMAGE for JPEG */
+} EVE_upload_model_t;
+
+void EVE_upload_calibrate(uint32_t scratch);
+void EVE_upload_get_model(EVE_upload_model_t *model);
+void EVE_upload_set_model(const EVE_upload_model_t *model);
+uint32_t EVE_upload_estimate(const EVE_upload_asset_t *asset, uint8_t method);
+uint8_t EVE_upload_select(const EVE_upload_asset_t *asset);
+uint8_t EVE_upload(uint32_t address, const EVE_upload_asset_t *asset);
+
+#endif /* EVE_UPLOAD_H */
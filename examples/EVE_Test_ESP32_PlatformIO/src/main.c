@@ -1,9 +1,12 @@
 /*
 @file    main.c
 @brief   Main file for ESP-IDF ESP32 example
-@version 1.0
+@version 1.1
 @date    2021-01-08
 @author  Rudolph Riedel
+
+1.1
+- added the option to run the display handling in a task pinned to the second core
 */
 
 #include "freertos/FreeRTOS.h"
@@ -17,7 +20,12 @@
 
 #define LED_BUILTIN GPIO_NUM_2
 
-void app_main()
+/* 1 = run EVE_init_spi(), TFT_init() and the display loop in a task on the second core, this leaves the first core to */
+/* the application while the display lists are built and queued from core 1 */
+/* note: the SPI interrupt is allocated on the core that calls EVE_init_spi() so the display task does the init as well */
+#define DISPLAY_ON_SECOND_CORE 0
+
+static void display_loop(void *parameter)
 {
     uint32_t current_millis;
     uint32_t previous_millis = 0;
@@ -27,6 +35,8 @@ void app_main()
     uint32_t micros_start, micros_end;
     gpio_config_t io_cfg = {0};
 
+    (void) parameter;
+
     io_cfg.intr_type = GPIO_PIN_INTR_DISABLE;
     io_cfg.mode = GPIO_MODE_OUTPUT;
     io_cfg.pin_bit_mask = BIT(LED_BUILTIN);
@@ -78,3 +88,12 @@ void app_main()
     vPortYield();
     }
 }
+
+void app_main()
+{
+#if DISPLAY_ON_SECOND_CORE
+    xTaskCreatePinnedToCore(display_loop, "display", 4096, NULL, 5, NULL, 1);
+#else
+    display_loop(NULL);
+#endif
+}
@@ -0,0 +1,1425 @@
+/*
+@file    eve_asset.c
+@brief   offline asset compiler, converts PNG, JPEG and TTF files to arrays that are ready to be uploaded to EVE
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+- added subsetted fonts with the characters from --strings files and a font map for EVE_set_font_maps()
+
+@section Usage
+
+eve_asset [options] name=file[:format[:encoding]] ...
+
+The output is <out>.c with the arrays, <out>.h with the extern declarations and the parameters of each asset and
+<out>.txt with a manifest that lists the sizes, the estimated upload times and suggested addresses in RAM_G.
+
+formats for images: argb1555, argb4, argb2, rgb565, rgb332, l8, l4, l2, l1, paletted8, astc4x4 ... astc12x12
+formats for fonts: font<size> with an optional bitmap format, e.g. "font24" or "font24l8", default is L4
+                   subset<size> for a font with only the characters used in the --strings files
+encodings: auto, raw, zlib, image - auto selects the encoding with the lowest estimated upload plus decode time
+
+*/
+
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include <png.h>
+#include <zlib.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "EVE.h"
+
+#define ASSET_MAX 64U
+#define FONT_METRIC_SIZE 148U /* legacy font metric block: 128 widths, format, stride, width, height, pointer */
+#define STRINGS_MAX 32U
+#define CODEPOINT_MAX 0x110000UL
+
+typedef enum
+{
+    ENC_AUTO = 0,
+    ENC_RAW,   /* EVE_memWrite_flash_buffer() */
+    ENC_ZLIB,  /* EVE_cmd_inflate() */
+    ENC_IMAGE  /* EVE_cmd_loadimage() */
+} encoding_t;
+
+static const char *const encoding_names[] = {"auto", "raw", "zlib", "image"};
+static const char *const encoding_defines[] = {"", "EVE_ASSET_RAW", "EVE_ASSET_INFLATE", "EVE_ASSET_LOADIMAGE"};
+
+typedef struct
+{
+    const char *name;
+    uint32_t format;
+    uint8_t bits; /* bits per pixel, 0 for ASTC */
+    uint8_t block_w;
+    uint8_t block_h;
+    uint8_t min_gen;
+} format_t;
+
+static const format_t formats[] =
+{
+    {"argb1555", EVE_ARGB1555, 16U, 0U, 0U, 2U},
+    {"argb4", EVE_ARGB4, 16U, 0U, 0U, 2U},
+    {"argb2", EVE_ARGB2, 8U, 0U, 0U, 2U},
+    {"rgb565", EVE_RGB565, 16U, 0U, 0U, 2U},
+    {"rgb332", EVE_RGB332, 8U, 0U, 0U, 2U},
+    {"l8", EVE_L8, 8U, 0U, 0U, 2U},
+    {"l4", EVE_L4, 4U, 0U, 0U, 2U},
+    {"l2", EVE_L2, 2U, 0U, 0U, 2U},
+    {"l1", EVE_L1, 1U, 0U, 0U, 2U},
+    {"paletted8", EVE_PALETTED8, 8U, 0U, 0U, 2U},
+    {"astc4x4", EVE_COMPRESSED_RGBA_ASTC_4x4_KHR, 0U, 4U, 4U, 3U},
+    {"astc5x4", EVE_COMPRESSED_RGBA_ASTC_5x4_KHR, 0U, 5U, 4U, 3U},
+    {"astc5x5", EVE_COMPRESSED_RGBA_ASTC_5x5_KHR, 0U, 5U, 5U, 3U},
+    {"astc6x5", EVE_COMPRESSED_RGBA_ASTC_6x5_KHR, 0U, 6U, 5U, 3U},
+    {"astc6x6", EVE_COMPRESSED_RGBA_ASTC_6x6_KHR, 0U, 6U, 6U, 3U},
+    {"astc8x5", EVE_COMPRESSED_RGBA_ASTC_8x5_KHR, 0U, 8U, 5U, 3U},
+    {"astc8x6", EVE_COMPRESSED_RGBA_ASTC_8x6_KHR, 0U, 8U, 6U, 3U},
+    {"astc8x8", EVE_COMPRESSED_RGBA_ASTC_8x8_KHR, 0U, 8U, 8U, 3U},
+    {"astc10x5", EVE_COMPRESSED_RGBA_ASTC_10x5_KHR, 0U, 10U, 5U, 3U},
+    {"astc10x6", EVE_COMPRESSED_RGBA_ASTC_10x6_KHR, 0U, 10U, 6U, 3U},
+    {"astc10x8", EVE_COMPRESSED_RGBA_ASTC_10x8_KHR, 0U, 10U, 8U, 3U},
+    {"astc10x10", EVE_COMPRESSED_RGBA_ASTC_10x10_KHR, 0U, 10U, 10U, 3U},
+    {"astc12x10", EVE_COMPRESSED_RGBA_ASTC_12x10_KHR, 0U, 12U, 10U, 3U},
+    {"astc12x12", EVE_COMPRESSED_RGBA_ASTC_12x12_KHR, 0U, 12U, 12U, 3U},
+};
+
+typedef struct
+{
+    char name[64];
+    const char *file;
+    const format_t *format;
+    encoding_t encoding;
+    bool is_font;
+    bool subset;
+    uint32_t font_size;
+
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t first_char; /* fonts only */
+    uint32_t last_char;
+    uint32_t charmap[128]; /* code point for each character of a font, 0 for unused */
+    uint8_t fallback;
+
+    uint8_t *decoded; /* the data as it is in RAM_G */
+    uint32_t decoded_len;
+    uint8_t *lut; /* palette for PALETTED8, ARGB8888 */
+    uint8_t *image; /* the original file if it can be used with CMD_LOADIMAGE */
+    uint32_t image_len;
+
+    uint8_t *out; /* the data that is stored in the array */
+    uint32_t out_len;
+    double upload_us;
+    double decode_us;
+    uint32_t address;
+    uint32_t lut_address;
+} asset_t;
+
+typedef struct
+{
+    const char *out;
+    uint32_t spi_hz;
+    uint32_t ram_g_start;
+    uint32_t ram_g_size;
+    uint8_t gen;
+    double inflate_rate; /* output bytes per µs */
+    double png_rate;
+    double jpeg_rate;
+    const char *astcenc;
+    const char *astc_quality;
+    const char *strings[STRINGS_MAX];
+    uint32_t strings_count;
+} options_t;
+
+static options_t opt =
+{
+    "tft_assets",
+    20000000UL,
+    EVE_RAM_G,
+    EVE_RAM_G_SIZE,
+    EVE_GEN,
+    8.0,  /* guesses, measure these on the real hardware and pass them on the command line */
+    1.0,
+    2.0,
+    "astcenc",
+    "-thorough",
+    {NULL},
+    0U
+};
+
+static asset_t assets[ASSET_MAX];
+static uint32_t asset_count;
+
+static void fail(const char *fmt, const char *arg)
+{
+    fprintf(stderr, "eve_asset: ");
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(EXIT_FAILURE);
+}
+
+static void *xmalloc(size_t size)
+{
+    void *ptr = calloc(1U, (size > 0U) ? size : 1U);
+
+    if (NULL == ptr)
+    {
+        fail("%s", "out of memory");
+    }
+    return ptr;
+}
+
+static uint8_t *read_file(const char *path, uint32_t *len)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *data;
+    long size;
+
+    if (NULL == file)
+    {
+        fail("can not open %s", path);
+    }
+    fseek(file, 0L, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0L, SEEK_SET);
+    data = xmalloc((size_t) size);
+    if (fread(data, 1U, (size_t) size, file) != (size_t) size)
+    {
+        fail("can not read %s", path);
+    }
+    fclose(file);
+    *len = (uint32_t) size;
+    return data;
+}
+
+static bool has_suffix(const char *str, const char *suffix)
+{
+    size_t len = strlen(str);
+    size_t slen = strlen(suffix);
+
+    return (len >= slen) && (0 == strcasecmp(&str[len - slen], suffix));
+}
+
+/*----------------------------------------------------------------------------------------------------------------*/
+/* images */
+/*----------------------------------------------------------------------------------------------------------------*/
+
+/* load a PNG as 8 bit RGBA, returns the PNG colour type so the caller knows what CMD_LOADIMAGE would make of it */
+/* alpha tells if the file has an alpha channel or a transparent colour */
+static uint8_t *load_png(const char *path, uint32_t *width, uint32_t *height, int *color_type, bool *interlaced,
+    bool *alpha)
+{
+    png_image image;
+    uint8_t *rgba;
+    uint32_t len;
+    uint8_t *file = read_file(path, &len);
+    png_structp png;
+    png_infop info;
+
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (0 == png_image_begin_read_from_memory(&image, file, len))
+    {
+        fail("%s is not a PNG file", path);
+    }
+    *alpha = ((image.format & PNG_FORMAT_FLAG_ALPHA) != 0U);
+    image.format = PNG_FORMAT_RGBA;
+    rgba = xmalloc(PNG_IMAGE_SIZE(image));
+    if (0 == png_image_finish_read(&image, NULL, rgba, 0, NULL))
+    {
+        fail("can not decode %s", path);
+    }
+    *width = image.width;
+    *height = image.height;
+
+    /* the simplified API does not tell the colour type and interlacing of the file, the header does */
+    png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    info = png_create_info_struct(png);
+    if (0 == setjmp(png_jmpbuf(png)))
+    {
+        FILE *fp = fopen(path, "rb");
+
+        if (NULL == fp)
+        {
+            fail("can not open %s", path);
+        }
+        png_init_io(png, fp);
+        png_read_info(png, info);
+        *color_type = png_get_color_type(png, info);
+        *interlaced = (png_get_interlace_type(png, info) != PNG_INTERLACE_NONE);
+        fclose(fp);
+    }
+    png_destroy_read_struct(&png, &info, NULL);
+    free(file);
+    return rgba;
+}
+
+static uint32_t image_stride(const format_t *format, uint32_t width)
+{
+    return ((width * format->bits) + 7U) / 8U;
+}
+
+static uint8_t luminance(const uint8_t *px)
+{
+    return (uint8_t) (((px[0] * 77U) + (px[1] * 150U) + (px[2] * 29U)) >> 8U);
+}
+
+/* median cut over the RGBA colours, good enough for icons and UI graphics */
+typedef struct
+{
+    uint32_t first;
+    uint32_t count;
+} box_t;
+
+static int sort_channel;
+
+static int compare_channel(const void *left, const void *right)
+{
+    return (int) ((const uint8_t *) left)[sort_channel] - (int) ((const uint8_t *) right)[sort_channel];
+}
+
+static void build_palette(asset_t *asset, const uint8_t *rgba)
+{
+    uint32_t pixels = asset->width * asset->height;
+    uint8_t *sorted = xmalloc((size_t) pixels * 4U);
+    box_t boxes[256];
+    uint32_t box_count = 1U;
+
+    memcpy(sorted, rgba, (size_t) pixels * 4U);
+    boxes[0].first = 0U;
+    boxes[0].count = pixels;
+
+    while (box_count < 256U)
+    {
+        uint32_t best = 0U;
+        int best_range = -1;
+        int best_channel = 0;
+
+        for (uint32_t index = 0U; index < box_count; index++)
+        {
+            for (int channel = 0; channel < 4; channel++)
+            {
+                int low = 255;
+                int high = 0;
+
+                for (uint32_t pixel = 0U; pixel < boxes[index].count; pixel++)
+                {
+                    int value = sorted[((boxes[index].first + pixel) * 4U) + (uint32_t) channel];
+                    low = (value < low) ? value : low;
+                    high = (value > high) ? value : high;
+                }
+                if ((boxes[index].count > 1U) && ((high - low) > best_range))
+                {
+                    best_range = high - low;
+                    best = index;
+                    best_channel = channel;
+                }
+            }
+        }
+        if (best_range <= 0)
+        {
+            break; /* every box holds a single colour */
+        }
+        sort_channel = best_channel;
+        qsort(&sorted[boxes[best].first * 4U], boxes[best].count, 4U, compare_channel);
+        boxes[box_count].first = boxes[best].first + (boxes[best].count / 2U);
+        boxes[box_count].count = boxes[best].count - (boxes[best].count / 2U);
+        boxes[best].count /= 2U;
+        box_count++;
+    }
+
+    asset->lut = xmalloc(1024U);
+    for (uint32_t index = 0U; index < box_count; index++)
+    {
+        uint32_t sum[4] = {0U, 0U, 0U, 0U};
+
+        for (uint32_t pixel = 0U; pixel < boxes[index].count; pixel++)
+        {
+            for (uint32_t channel = 0U; channel < 4U; channel++)
+            {
+                sum[channel] += sorted[((boxes[index].first + pixel) * 4U) + channel];
+            }
+        }
+        /* ARGB8888, little endian: B, G, R, A */
+        asset->lut[(index * 4U) + 0U] = (uint8_t) (sum[2] / boxes[index].count);
+        asset->lut[(index * 4U) + 1U] = (uint8_t) (sum[1] / boxes[index].count);
+        asset->lut[(index * 4U) + 2U] = (uint8_t) (sum[0] / boxes[index].count);
+        asset->lut[(index * 4U) + 3U] = (uint8_t) (sum[3] / boxes[index].count);
+    }
+
+    for (uint32_t pixel = 0U; pixel < pixels; pixel++)
+    {
+        const uint8_t *px = &rgba[pixel * 4U];
+        uint32_t best = 0U;
+        uint32_t best_dist = UINT32_MAX;
+
+        for (uint32_t index = 0U; index < box_count; index++)
+        {
+            const uint8_t *entry = &asset->lut[index * 4U];
+            int dr = (int) px[0] - entry[2];
+            int dg = (int) px[1] - entry[1];
+            int db = (int) px[2] - entry[0];
+            int da = (int) px[3] - entry[3];
+            uint32_t dist = (uint32_t) ((dr * dr) + (dg * dg) + (db * db) + (da * da));
+
+            if (dist < best_dist)
+            {
+                best_dist = dist;
+                best = index;
+            }
+        }
+        asset->decoded[pixel] = (uint8_t) best;
+    }
+    free(sorted);
+}
+
+/* the L formats use the alpha channel for images that have one and the luminance for all others */
+static void convert_pixels(asset_t *asset, const uint8_t *rgba, bool alpha)
+{
+    const format_t *format = asset->format;
+
+    asset->stride = image_stride(format, asset->width);
+    asset->decoded_len = asset->stride * asset->height;
+    asset->decoded = xmalloc(asset->decoded_len);
+
+    if (EVE_PALETTED8 == format->format)
+    {
+        build_palette(asset, rgba);
+        return;
+    }
+
+    for (uint32_t line = 0U; line < asset->height; line++)
+    {
+        uint8_t *dst = &asset->decoded[line * asset->stride];
+
+        for (uint32_t column = 0U; column < asset->width; column++)
+        {
+            const uint8_t *px = &rgba[((line * asset->width) + column) * 4U];
+            uint32_t value = 0U;
+
+            switch (format->format)
+            {
+                case EVE_ARGB1555:
+                    value = ((px[3] >= 128U) ? 0x8000U : 0U) | ((px[0] >> 3U) << 10U) | ((px[1] >> 3U) << 5U) | (px[2] >> 3U);
+                    break;
+                case EVE_ARGB4:
+                    value = ((px[3] >> 4U) << 12U) | ((px[0] >> 4U) << 8U) | ((px[1] >> 4U) << 4U) | (px[2] >> 4U);
+                    break;
+                case EVE_RGB565:
+                    value = ((px[0] >> 3U) << 11U) | ((px[1] >> 2U) << 5U) | (px[2] >> 3U);
+                    break;
+                case EVE_ARGB2:
+                    value = ((px[3] >> 6U) << 6U) | ((px[0] >> 6U) << 4U) | ((px[1] >> 6U) << 2U) | (px[2] >> 6U);
+                    break;
+                case EVE_RGB332:
+                    value = ((px[0] >> 5U) << 5U) | ((px[1] >> 5U) << 2U) | (px[2] >> 6U);
+                    break;
+                default: /* L formats */
+                    value = alpha ? px[3] : luminance(px);
+                    break;
+            }
+
+            if (16U == format->bits)
+            {
+                dst[column * 2U] = (uint8_t) value;
+                dst[(column * 2U) + 1U] = (uint8_t) (value >> 8U);
+            }
+            else if (8U == format->bits)
+            {
+                dst[column] = (uint8_t) value;
+            }
+            else /* L4, L2, L1: the first pixel goes into the most significant bits */
+            {
+                uint32_t per_byte = 8U / format->bits;
+                uint32_t shift = 8U - (format->bits * ((column % per_byte) + 1U));
+
+                dst[column / per_byte] |= (uint8_t) ((value >> (8U - format->bits)) << shift);
+            }
+        }
+    }
+}
+
+/* BT81x expects the ASTC blocks of two block-rows interleaved: (0,0) (0,1) (1,0) (1,1) (2,0) (2,1)... */
+/* an odd last block-row is stored in linear order */
+static void convert_astc(asset_t *asset)
+{
+    char tmp_name[] = "/tmp/eve_assetXXXXXX";
+    char command[1024];
+    uint8_t *astc;
+    uint32_t len;
+    uint32_t blocks_x;
+    uint32_t blocks_y;
+    int fd = mkstemp(tmp_name);
+
+    if (fd < 0)
+    {
+        fail("%s", "can not create a temporary file");
+    }
+    close(fd);
+    snprintf(command, sizeof(command), "%s -cl \"%s\" \"%s\" %ux%u %s > /dev/null", opt.astcenc, asset->file, tmp_name,
+        asset->format->block_w, asset->format->block_h, opt.astc_quality);
+    if (system(command) != 0)
+    {
+        remove(tmp_name);
+        fail("running astcenc failed for %s, is it installed? see --astcenc", asset->file);
+    }
+    astc = read_file(tmp_name, &len);
+    remove(tmp_name);
+
+    if ((len < 16U) || (astc[0] != 0x13U) || (astc[1] != 0xabU) || (astc[2] != 0xa1U) || (astc[3] != 0x5cU))
+    {
+        fail("astcenc did not produce an .astc file for %s", asset->file);
+    }
+    asset->width = astc[7] | ((uint32_t) astc[8] << 8U) | ((uint32_t) astc[9] << 16U);
+    asset->height = astc[10] | ((uint32_t) astc[11] << 8U) | ((uint32_t) astc[12] << 16U);
+    blocks_x = (asset->width + asset->format->block_w - 1U) / asset->format->block_w;
+    blocks_y = (asset->height + asset->format->block_h - 1U) / asset->format->block_h;
+    asset->stride = blocks_x * 16U;
+    asset->decoded_len = blocks_x * blocks_y * 16U;
+    if ((len - 16U) < asset->decoded_len)
+    {
+        fail("the .astc file for %s is truncated", asset->file);
+    }
+    asset->decoded = xmalloc(asset->decoded_len);
+
+    uint32_t out = 0U;
+    for (uint32_t by = 0U; by < blocks_y; by += 2U)
+    {
+        for (uint32_t bx = 0U; bx < blocks_x; bx++)
+        {
+            memcpy(&asset->decoded[out], &astc[16U + (((by * blocks_x) + bx) * 16U)], 16U);
+            out += 16U;
+            if ((by + 1U) < blocks_y)
+            {
+                memcpy(&asset->decoded[out], &astc[16U + ((((by + 1U) * blocks_x) + bx) * 16U)], 16U);
+                out += 16U;
+            }
+        }
+    }
+    free(astc);
+}
+
+/* follows the marker segments to the frame header, FF C0 can also be part of an EXIF thumbnail or the image data */
+static void jpeg_size(asset_t *asset, const uint8_t *jpeg, uint32_t len)
+{
+    uint32_t index = 2U;
+
+    if ((len < 4U) || (jpeg[0] != 0xffU) || (jpeg[1] != 0xd8U))
+    {
+        fail("%s is not a JPEG file", asset->file);
+    }
+    while ((index + 4U) <= len)
+    {
+        uint8_t marker = jpeg[index + 1U];
+
+        if (jpeg[index] != 0xffU)
+        {
+            break;
+        }
+        if (0xffU == marker)
+        {
+            index++; /* fill byte */
+            continue;
+        }
+        if ((0xd9U == marker) || (0xdaU == marker))
+        {
+            break; /* end of image or start of scan before a frame header */
+        }
+        if ((0x01U == marker) || ((marker >= 0xd0U) && (marker <= 0xd7U)))
+        {
+            index += 2U; /* markers without a segment */
+            continue;
+        }
+        if ((0xc0U == marker) || (0xc2U == marker))
+        {
+            if ((index + 9U) > len)
+            {
+                break;
+            }
+            asset->height = ((uint32_t) jpeg[index + 5U] << 8U) | jpeg[index + 6U];
+            asset->width = ((uint32_t) jpeg[index + 7U] << 8U) | jpeg[index + 8U];
+            return;
+        }
+        index += 2U + (((uint32_t) jpeg[index + 2U] << 8U) | jpeg[index + 3U]);
+    }
+    fail("%s has no baseline or progressive frame header", asset->file);
+}
+
+static void load_image(asset_t *asset)
+{
+    if (has_suffix(asset->file, ".jpg") || has_suffix(asset->file, ".jpeg"))
+    {
+        /* JPEG is only supported as is for CMD_LOADIMAGE which always decodes it to RGB565 */
+        uint8_t *jpeg = read_file(asset->file, &asset->image_len);
+
+        asset->image = jpeg;
+        asset->format = &formats[3]; /* rgb565 */
+        asset->encoding = ENC_IMAGE;
+        jpeg_size(asset, jpeg, asset->image_len);
+        asset->stride = asset->width * 2U;
+        asset->decoded_len = asset->stride * asset->height;
+        return;
+    }
+
+    if (0U == asset->format->bits)
+    {
+        convert_astc(asset);
+        return;
+    }
+
+    int color_type = 0;
+    bool interlaced = false;
+    bool alpha = false;
+    uint8_t *rgba = load_png(asset->file, &asset->width, &asset->height, &color_type, &interlaced, &alpha);
+    convert_pixels(asset, rgba, alpha);
+    free(rgba);
+
+    /* CMD_LOADIMAGE decodes PNG to RGB565 for RGB, ARGB4 for RGBA and L8 for grayscale, no interlacing */
+    bool usable = false;
+    if (!interlaced)
+    {
+        usable = ((EVE_RGB565 == asset->format->format) && (PNG_COLOR_TYPE_RGB == color_type)) ||
+                 ((EVE_ARGB4 == asset->format->format) && (PNG_COLOR_TYPE_RGB_ALPHA == color_type)) ||
+                 ((EVE_L8 == asset->format->format) && (PNG_COLOR_TYPE_GRAY == color_type));
+    }
+    if (usable)
+    {
+        asset->image = read_file(asset->file, &asset->image_len);
+    }
+}
+
+/*----------------------------------------------------------------------------------------------------------------*/
+/* fonts */
+/*----------------------------------------------------------------------------------------------------------------*/
+
+static uint8_t *codepoints_used; /* CODEPOINT_MAX entries, the characters in the --strings files */
+
+/* collects the code points of UTF-8 text files, control characters are ignored */
+static void read_strings(void)
+{
+    codepoints_used = xmalloc(CODEPOINT_MAX);
+    for (uint32_t file_index = 0U; file_index < opt.strings_count; file_index++)
+    {
+        uint32_t len;
+        uint8_t *text = read_file(opt.strings[file_index], &len);
+        uint32_t index = 0U;
+
+        while (index < len)
+        {
+            uint32_t codepoint = text[index++];
+            uint32_t follow = 0U;
+
+            if ((codepoint & 0xe0U) == 0xc0U)
+            {
+                codepoint &= 0x1fU;
+                follow = 1U;
+            }
+            else if ((codepoint & 0xf0U) == 0xe0U)
+            {
+                codepoint &= 0x0fU;
+                follow = 2U;
+            }
+            else if ((codepoint & 0xf8U) == 0xf0U)
+            {
+                codepoint &= 0x07U;
+                follow = 3U;
+            }
+            else if (codepoint > 0x7fU)
+            {
+                fail("%s is not UTF-8", opt.strings[file_index]);
+            }
+            for (; follow > 0U; follow--)
+            {
+                if ((index >= len) || ((text[index] & 0xc0U) != 0x80U))
+                {
+                    fail("%s is not UTF-8", opt.strings[file_index]);
+                }
+                codepoint = (codepoint << 6U) | (text[index++] & 0x3fU);
+            }
+            if ((codepoint >= 32U) && (codepoint != 0x7fU) && (codepoint != 0xfeffU) && (codepoint < CODEPOINT_MAX))
+            {
+                codepoints_used[codepoint] = 1U;
+            }
+        }
+        free(text);
+    }
+}
+
+/* Assigns the characters of a subsetted legacy font: ASCII stays as it is so strings without other characters do */
+/* not need to be translated, the other code points go into the free characters in and then next to the ASCII range. */
+/* '\n' and '%' are not used for other code points as these have a meaning for CMD_TEXT with OPT_FILL and OPT_FORMAT. */
+static void subset_charmap(asset_t *asset)
+{
+    uint32_t low = 128U;
+    uint32_t high = 0U;
+    uint32_t order[128];
+    uint32_t order_count = 0U;
+    uint32_t next = 0U;
+
+    for (uint32_t chr = 32U; chr < 127U; chr++)
+    {
+        if (codepoints_used[chr] != 0U)
+        {
+            asset->charmap[chr] = chr;
+            low = (chr < low) ? chr : low;
+            high = (chr > high) ? chr : high;
+        }
+    }
+    if (low > high)
+    {
+        low = 32U;
+        high = 31U;
+    }
+    for (uint32_t chr = low; chr <= high; chr++)
+    {
+        order[order_count++] = chr;
+    }
+    for (uint32_t chr = high + 1U; chr < 128U; chr++)
+    {
+        order[order_count++] = chr;
+    }
+    for (uint32_t chr = low - 1U; chr > 0U; chr--)
+    {
+        order[order_count++] = chr;
+    }
+
+    for (uint32_t codepoint = 128U; codepoint < CODEPOINT_MAX; codepoint++)
+    {
+        if (0U == codepoints_used[codepoint])
+        {
+            continue;
+        }
+        while ((next < order_count) && ((asset->charmap[order[next]] != 0U) || ('\n' == order[next]) || ('%' == order[next])))
+        {
+            next++;
+        }
+        if (next >= order_count)
+        {
+            fail("the --strings files have too many characters for one legacy font, split them for %s", asset->name);
+        }
+        asset->charmap[order[next]] = codepoint;
+        low = (order[next] < low) ? order[next] : low;
+        high = (order[next] > high) ? order[next] : high;
+    }
+    if (low > high)
+    {
+        fail("the --strings files have no characters for %s", asset->name);
+    }
+
+    asset->first_char = low;
+    asset->last_char = high;
+    asset->fallback = (uint8_t) low;
+    if (asset->charmap['?'] != 0U)
+    {
+        asset->fallback = (uint8_t) '?';
+    }
+}
+
+/* legacy font for CMD_SETFONT2 with the characters 32 to 127 or the subset from the --strings files */
+static void load_font(asset_t *asset)
+{
+    FT_Library library;
+    FT_Face face;
+    uint32_t first;
+    uint32_t last;
+    uint32_t cell_w = 0U;
+    int ascender;
+    int descender;
+
+    if (asset->subset)
+    {
+        subset_charmap(asset);
+    }
+    else
+    {
+        asset->first_char = 32U;
+        asset->last_char = 127U;
+        for (uint32_t chr = 32U; chr < 128U; chr++)
+        {
+            asset->charmap[chr] = chr;
+        }
+    }
+    first = asset->first_char;
+    last = asset->last_char;
+
+    if ((FT_Init_FreeType(&library) != 0) || (FT_New_Face(library, asset->file, 0, &face) != 0))
+    {
+        fail("can not load the font %s", asset->file);
+    }
+    FT_Set_Pixel_Sizes(face, 0, asset->font_size);
+    ascender = (int) (face->size->metrics.ascender >> 6);
+    descender = (int) (-(face->size->metrics.descender >> 6));
+
+    for (uint32_t glyph = first; glyph <= last; glyph++)
+    {
+        if (asset->subset && (asset->charmap[glyph] != 0U) && (0U == FT_Get_Char_Index(face, asset->charmap[glyph])))
+        {
+            fprintf(stderr, "eve_asset: warning, %s has no glyph for U+%04X\n", asset->file, asset->charmap[glyph]);
+        }
+        if ((asset->charmap[glyph] != 0U) && (0 == FT_Load_Char(face, asset->charmap[glyph], FT_LOAD_DEFAULT)))
+        {
+            uint32_t advance = (uint32_t) ((face->glyph->advance.x + 63) >> 6);
+            uint32_t right = (uint32_t) (face->glyph->metrics.horiBearingX >> 6) + face->glyph->bitmap.width;
+
+            cell_w = (advance > cell_w) ? advance : cell_w;
+            cell_w = (right > cell_w) ? right : cell_w;
+        }
+    }
+
+    asset->width = cell_w;
+    asset->height = (uint32_t) (ascender + descender);
+    asset->stride = image_stride(asset->format, cell_w);
+
+    uint32_t cell_size = asset->stride * asset->height;
+    asset->decoded_len = FONT_METRIC_SIZE + (cell_size * (last - first + 1U));
+    asset->decoded = xmalloc(asset->decoded_len);
+
+    for (uint32_t glyph = first; glyph <= last; glyph++)
+    {
+        uint8_t *cell = &asset->decoded[FONT_METRIC_SIZE + ((glyph - first) * cell_size)];
+
+        if ((0U == asset->charmap[glyph]) || (FT_Load_Char(face, asset->charmap[glyph], FT_LOAD_RENDER) != 0))
+        {
+            continue;
+        }
+        FT_Bitmap *bitmap = &face->glyph->bitmap;
+        int left = face->glyph->bitmap_left;
+        int top = ascender - face->glyph->bitmap_top;
+
+        asset->decoded[glyph] = (uint8_t) ((face->glyph->advance.x + 63) >> 6);
+        for (uint32_t row = 0U; row < bitmap->rows; row++)
+        {
+            for (uint32_t column = 0U; column < bitmap->width; column++)
+            {
+                int x = left + (int) column;
+                int y = top + (int) row;
+                uint8_t value = bitmap->buffer[(row * (uint32_t) bitmap->pitch) + column];
+
+                if ((x < 0) || (y < 0) || (x >= (int) cell_w) || (y >= (int) asset->height))
+                {
+                    continue;
+                }
+                uint32_t per_byte = 8U / asset->format->bits;
+                uint32_t shift = 8U - (asset->format->bits * (((uint32_t) x % per_byte) + 1U));
+                cell[((uint32_t) y * asset->stride) + ((uint32_t) x / per_byte)] |= (uint8_t) ((value >> (8U - asset->format->bits)) << shift);
+            }
+        }
+    }
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+/* the metric block has the absolute address of the glyph data, it can only be completed after placing the font */
+static void patch_font(asset_t *asset)
+{
+    uint32_t values[5];
+    uint32_t glyphs = asset->address + FONT_METRIC_SIZE;
+
+    values[0] = asset->format->format;
+    values[1] = asset->stride;
+    values[2] = asset->width;
+    values[3] = asset->height;
+    values[4] = glyphs - (asset->first_char * asset->stride * asset->height); /* address of character 0 */
+
+    for (uint32_t index = 0U; index < 5U; index++)
+    {
+        for (uint32_t byte = 0U; byte < 4U; byte++)
+        {
+            asset->decoded[128U + (index * 4U) + byte] = (uint8_t) (values[index] >> (byte * 8U));
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------------------------------------------*/
+/* encoding */
+/*----------------------------------------------------------------------------------------------------------------*/
+
+static double upload_time(uint32_t bytes)
+{
+    return ((double) bytes * 8.0 * 1000000.0) / (double) opt.spi_hz;
+}
+
+static void encode(asset_t *asset)
+{
+    uLongf zlen = compressBound(asset->decoded_len);
+    uint8_t *zdata = xmalloc(zlen);
+    double cost[4] = {0.0, 0.0, 0.0, 0.0};
+    double decode[4] = {0.0, 0.0, 0.0, 0.0};
+    bool possible[4] = {false, false, false, false};
+
+    if (asset->decoded != NULL)
+    {
+        possible[ENC_RAW] = true;
+        cost[ENC_RAW] = upload_time(asset->decoded_len);
+
+        if (compress2(zdata, &zlen, asset->decoded, asset->decoded_len, Z_BEST_COMPRESSION) != Z_OK)
+        {
+            fail("zlib failed for %s", asset->name);
+        }
+        possible[ENC_ZLIB] = true;
+        decode[ENC_ZLIB] = (double) asset->decoded_len / opt.inflate_rate;
+        cost[ENC_ZLIB] = upload_time((uint32_t) zlen) + decode[ENC_ZLIB];
+    }
+    if (asset->image != NULL)
+    {
+        double rate = has_suffix(asset->file, ".png") ? opt.png_rate : opt.jpeg_rate;
+
+        possible[ENC_IMAGE] = true;
+        decode[ENC_IMAGE] = (double) asset->decoded_len / rate;
+        cost[ENC_IMAGE] = upload_time(asset->image_len) + decode[ENC_IMAGE];
+    }
+
+    if (ENC_AUTO == asset->encoding)
+    {
+        asset->encoding = ENC_RAW;
+        for (int enc = ENC_RAW; enc <= ENC_IMAGE; enc++)
+        {
+            if (possible[enc] && (!possible[asset->encoding] || (cost[enc] < cost[asset->encoding])))
+            {
+                asset->encoding = (encoding_t) enc;
+            }
+        }
+    }
+    if (!possible[asset->encoding])
+    {
+        fail("the requested encoding is not possible for %s", asset->name);
+    }
+
+    switch (asset->encoding)
+    {
+        case ENC_ZLIB:
+            asset->out = zdata;
+            asset->out_len = (uint32_t) zlen;
+            zdata = NULL;
+            break;
+        case ENC_IMAGE:
+            asset->out = asset->image;
+            asset->out_len = asset->image_len;
+            break;
+        default:
+            asset->out = asset->decoded;
+            asset->out_len = asset->decoded_len;
+            break;
+    }
+    asset->decode_us = decode[asset->encoding];
+    asset->upload_us = cost[asset->encoding] - decode[asset->encoding];
+    free(zdata);
+}
+
+/* suggest addresses in RAM_G, fonts and palettes first as these need to be known before the data is final */
+static void place(void)
+{
+    uint32_t address = opt.ram_g_start;
+
+    for (uint32_t index = 0U; index < asset_count; index++)
+    {
+        asset_t *asset = &assets[index];
+        uint32_t align = (0U == asset->format->bits) ? 16U : 4U;
+
+        address = (address + align - 1U) & ~(align - 1U);
+        asset->address = address;
+        address += (asset->decoded_len + 3U) & ~3U;
+        if (asset->lut != NULL)
+        {
+            asset->lut_address = address;
+            address += 1024U;
+        }
+        if (asset->is_font)
+        {
+            patch_font(asset);
+        }
+        encode(asset);
+    }
+    if (address > (opt.ram_g_start + opt.ram_g_size))
+    {
+        fprintf(stderr, "eve_asset: warning, the assets need %u bytes but RAM_G has only %u\n",
+            address - opt.ram_g_start, opt.ram_g_size);
+    }
+}
+
+/*----------------------------------------------------------------------------------------------------------------*/
+/* output */
+/*----------------------------------------------------------------------------------------------------------------*/
+
+static void upper(char *dst, const char *src, size_t size)
+{
+    size_t index;
+
+    for (index = 0U; (index + 1U) < size && src[index] != '\0'; index++)
+    {
+        dst[index] = (char) toupper((unsigned char) src[index]);
+    }
+    dst[index] = '\0';
+}
+
+static void write_array(FILE *file, const char *name, const char *suffix, const uint8_t *data, uint32_t len)
+{
+    fprintf(file, "const uint8_t %s%s[%u] PROGMEM =\n{\n", name, suffix, len);
+    for (uint32_t index = 0U; index < len; index++)
+    {
+        fprintf(file, "%s0x%02X,%s", ((index % 16U) == 0U) ? "    " : "", data[index],
+            (((index % 16U) == 15U) || ((index + 1U) == len)) ? "\n" : " ");
+    }
+    fprintf(file, "};\n\n");
+}
+
+/* the characters above 127 of a subsetted font as arrays for EVE_font_map_t, these are not PROGMEM as */
+/* private_string_write() reads them directly, plus a UTF-8 text file with all characters for EVE Asset Builder */
+static void write_font_map(FILE *source, FILE *header, const asset_t *asset, const char *name)
+{
+    uint32_t codepoints[128];
+    uint8_t glyphs[128];
+    uint32_t count = 0U;
+    char path[1024];
+    FILE *chars;
+
+    for (uint32_t codepoint = 128U; codepoint < CODEPOINT_MAX; codepoint++)
+    {
+        if (0U == codepoints_used[codepoint])
+        {
+            continue;
+        }
+        for (uint32_t chr = 1U; chr < 128U; chr++)
+        {
+            if (asset->charmap[chr] == codepoint)
+            {
+                codepoints[count] = codepoint;
+                glyphs[count] = (uint8_t) chr;
+                count++;
+            }
+        }
+    }
+
+    fprintf(source, "const uint32_t %s_codepoints[%u] =\n{\n", asset->name, (count > 0U) ? count : 1U);
+    for (uint32_t index = 0U; index < count; index++)
+    {
+        fprintf(source, "%s0x%05XUL,%s", ((index % 8U) == 0U) ? "    " : "", codepoints[index],
+            (((index % 8U) == 7U) || ((index + 1U) == count)) ? "\n" : " ");
+    }
+    fprintf(source, "%s};\n\n", (0U == count) ? "    0UL\n" : "");
+    fprintf(source, "const uint8_t %s_glyphs[%u] =\n{\n", asset->name, (count > 0U) ? count : 1U);
+    for (uint32_t index = 0U; index < count; index++)
+    {
+        fprintf(source, "%s0x%02X,%s", ((index % 16U) == 0U) ? "    " : "", glyphs[index],
+            (((index % 16U) == 15U) || ((index + 1U) == count)) ? "\n" : " ");
+    }
+    fprintf(source, "%s};\n\n", (0U == count) ? "    0U\n" : "");
+
+    fprintf(header, "/* EVE_font_map_t map = {%s_codepoints, %s_glyphs, %s_MAP_COUNT, handle, %s_FALLBACK}; */\n",
+        asset->name, asset->name, name, name);
+    fprintf(header, "extern const uint32_t %s_codepoints[%u];\n", asset->name, (count > 0U) ? count : 1U);
+    fprintf(header, "extern const uint8_t %s_glyphs[%u];\n", asset->name, (count > 0U) ? count : 1U);
+    fprintf(header, "#define %s_MAP_COUNT %uU\n", name, count);
+    fprintf(header, "#define %s_FALLBACK %uU\n", name, asset->fallback);
+
+    if (snprintf(path, sizeof(path), "%s_%s_chars.txt", opt.out, asset->name) >= (int) sizeof(path))
+    {
+        fail("%s", "the output name is too long");
+    }
+    chars = fopen(path, "w");
+    if (NULL == chars)
+    {
+        fail("can not write %s", path);
+    }
+    for (uint32_t codepoint = 32U; codepoint < CODEPOINT_MAX; codepoint++)
+    {
+        if (0U == codepoints_used[codepoint])
+        {
+            continue;
+        }
+        if (codepoint < 0x80U)
+        {
+            fputc((int) codepoint, chars);
+        }
+        else if (codepoint < 0x800U)
+        {
+            fputc((int) (0xc0U | (codepoint >> 6U)), chars);
+            fputc((int) (0x80U | (codepoint & 0x3fU)), chars);
+        }
+        else if (codepoint < 0x10000U)
+        {
+            fputc((int) (0xe0U | (codepoint >> 12U)), chars);
+            fputc((int) (0x80U | ((codepoint >> 6U) & 0x3fU)), chars);
+            fputc((int) (0x80U | (codepoint & 0x3fU)), chars);
+        }
+        else
+        {
+            fputc((int) (0xf0U | (codepoint >> 18U)), chars);
+            fputc((int) (0x80U | ((codepoint >> 12U) & 0x3fU)), chars);
+            fputc((int) (0x80U | ((codepoint >> 6U) & 0x3fU)), chars);
+            fputc((int) (0x80U | (codepoint & 0x3fU)), chars);
+        }
+    }
+    fputc('\n', chars);
+    fclose(chars);
+}
+
+static FILE *open_output(const char *suffix)
+{
+    char path[1024];
+    FILE *file;
+
+    snprintf(path, sizeof(path), "%s%s", opt.out, suffix);
+    file = fopen(path, "w");
+    if (NULL == file)
+    {
+        fail("can not write %s", path);
+    }
+    return file;
+}
+
+static const char *base_name(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+
+    return (slash != NULL) ? &slash[1] : path;
+}
+
+static void write_outputs(void)
+{
+    FILE *source = open_output(".c");
+    FILE *header = open_output(".h");
+    FILE *manifest = open_output(".txt");
+    char guard[256];
+    double total = 0.0;
+    uint32_t stored = 0U;
+    uint32_t ram = 0U;
+
+    upper(guard, base_name(opt.out), sizeof(guard));
+    for (char *chr = guard; *chr != '\0'; chr++)
+    {
+        *chr = isalnum((unsigned char) *chr) ? *chr : '_';
+    }
+
+    fprintf(source, "/* generated by eve_asset, do not edit */\n\n#include \"%s.h\"\n\n", base_name(opt.out));
+
+    fprintf(header, "/* generated by eve_asset, do not edit */\n\n#ifndef %s_H\n#define %s_H\n\n", guard, guard);
+    fprintf(header, "#include <stdint.h>\n\n");
+    fprintf(header, "#if defined (__AVR__)\n    #include <avr/pgmspace.h>\n#else\n    #if !defined(PROGMEM)\n        #define PROGMEM\n    #endif\n#endif\n\n");
+    fprintf(header, "#if !defined (EVE_ASSET_RAW)\n");
+    fprintf(header, "#define EVE_ASSET_RAW 0U       /* EVE_memWrite_flash_buffer(ADDR, name, SIZE) */\n");
+    fprintf(header, "#define EVE_ASSET_INFLATE 1U   /* EVE_cmd_inflate(ADDR, name, SIZE) */\n");
+    fprintf(header, "#define EVE_ASSET_LOADIMAGE 2U /* EVE_cmd_loadimage(ADDR, EVE_OPT_NODL, name, SIZE) */\n");
+    fprintf(header, "#endif\n\n");
+
+    fprintf(manifest, "# eve_asset manifest, SPI at %u Hz, estimated times in us\n", opt.spi_hz);
+    fprintf(manifest, "# %-16s %-10s %5s %5s %6s %-5s %8s %8s %10s %10s %10s %10s\n", "name", "format", "w", "h",
+        "stride", "enc", "stored", "ram_g", "address", "upload", "decode", "total");
+
+    for (uint32_t index = 0U; index < asset_count; index++)
+    {
+        asset_t *asset = &assets[index];
+        char name[64];
+
+        upper(name, asset->name, sizeof(name));
+        write_array(source, asset->name, "", asset->out, asset->out_len);
+
+        fprintf(header, "/* %s from %s */\n", asset->name, base_name(asset->file));
+        fprintf(header, "extern const uint8_t %s[%u] PROGMEM;\n", asset->name, asset->out_len);
+        fprintf(header, "#define %s_SIZE %uUL\n", name, asset->out_len);
+        fprintf(header, "#define %s_RAM_G_SIZE %uUL\n", name, asset->decoded_len);
+        fprintf(header, "#define %s_ADDR 0x%06xUL\n", name, asset->address);
+        fprintf(header, "#define %s_UPLOAD %s\n", name, encoding_defines[asset->encoding]);
+        if (asset->is_font)
+        {
+            fprintf(header, "#define %s_FIRSTCHAR %uU /* EVE_cmd_setfont2(handle, %s_ADDR, %s_FIRSTCHAR) */\n", name,
+                asset->first_char, name, name);
+            if (asset->subset)
+            {
+                write_font_map(source, header, asset, name);
+            }
+        }
+        else
+        {
+            fprintf(header, "#define %s_FORMAT %uUL /* %s */\n", name, asset->format->format, asset->format->name);
+            fprintf(header, "#define %s_WIDTH %uU\n", name, asset->width);
+            fprintf(header, "#define %s_HEIGHT %uU\n", name, asset->height);
+            fprintf(header, "#define %s_STRIDE %uU\n", name, asset->stride);
+        }
+        if (asset->lut != NULL)
+        {
+            write_array(source, asset->name, "_lut", asset->lut, 1024U);
+            fprintf(header, "extern const uint8_t %s_lut[1024] PROGMEM; /* ARGB8888 palette, upload as is */\n", asset->name);
+            fprintf(header, "#define %s_LUT_ADDR 0x%06xUL\n", name, asset->lut_address);
+        }
+        fprintf(header, "\n");
+
+        fprintf(manifest, "  %-16s %-10s %5u %5u %6u %-5s %8u %8u 0x%08x %10.0f %10.0f %10.0f\n", asset->name,
+            asset->is_font ? "font" : asset->format->name, asset->width, asset->height, asset->stride,
+            encoding_names[asset->encoding], asset->out_len, asset->decoded_len, asset->address, asset->upload_us,
+            asset->decode_us, asset->upload_us + asset->decode_us);
+        total += asset->upload_us + asset->decode_us;
+        stored += asset->out_len + ((asset->lut != NULL) ? 1024U : 0U);
+        ram += asset->decoded_len + ((asset->lut != NULL) ? 1024U : 0U);
+    }
+
+    fprintf(header, "#endif /* %s_H */\n", guard);
+    fprintf(manifest, "# total: %u bytes stored, %u bytes in RAM_G, %.0f us estimated upload time\n", stored, ram, total);
+
+    fclose(source);
+    fclose(header);
+    fclose(manifest);
+}
+
+/*----------------------------------------------------------------------------------------------------------------*/
+/* command line */
+/*----------------------------------------------------------------------------------------------------------------*/
+
+static void usage(void)
+{
+    printf("usage: eve_asset [options] name=file[:format[:encoding]] ...\n\n"
+           "  -o <name>           output base name, default: tft_assets\n"
+           "  --spi <hz>          SPI clock for the estimates, default: 20000000\n"
+           "  --gen <2|3|4>       EVE generation, default: EVE_GEN of the display selected in the Makefile\n"
+           "  --ram-g <start>     first address in RAM_G to use, default: 0\n"
+           "  --ram-g-size <size> default: 1048576\n"
+           "  --inflate-rate <r>  CMD_INFLATE output in bytes per us, default: 8\n"
+           "  --png-rate <r>      CMD_LOADIMAGE output for PNG in bytes per us, default: 1\n"
+           "  --jpeg-rate <r>     CMD_LOADIMAGE output for JPEG in bytes per us, default: 2\n"
+           "  --astcenc <path>    ASTC encoder to use, default: astcenc\n"
+           "  --astc-quality <q>  quality option for astcenc, default: -thorough\n"
+           "  --strings <file>    UTF-8 text with the characters for subset fonts, can be used more than once\n\n"
+           "formats: argb1555 (default), argb4, argb2, rgb565, rgb332, l8, l4, l2, l1, paletted8, astc<w>x<h>,\n"
+           "         font<size>[l1|l2|l4|l8] and subset<size>[l1|l2|l4|l8] for .ttf and .otf files\n"
+           "encodings: auto (default), raw, zlib, image\n");
+    exit(EXIT_SUCCESS);
+}
+
+static const format_t *find_format(const char *name)
+{
+    for (size_t index = 0U; index < (sizeof(formats) / sizeof(formats[0])); index++)
+    {
+        if (0 == strcmp(formats[index].name, name))
+        {
+            return &formats[index];
+        }
+    }
+    fail("unknown format %s", name);
+    return NULL;
+}
+
+static void parse_asset(char *spec)
+{
+    asset_t *asset = &assets[asset_count];
+    char *equal = strchr(spec, '=');
+    char *format;
+    char *encoding;
+
+    if (asset_count >= ASSET_MAX)
+    {
+        fail("%s", "too many assets");
+    }
+    if (NULL == equal)
+    {
+        fail("expected name=file, got %s", spec);
+    }
+    *equal = '\0';
+    snprintf(asset->name, sizeof(asset->name), "%s", spec);
+    asset->file = &equal[1];
+    format = strchr(asset->file, ':');
+    encoding = NULL;
+    if (format != NULL)
+    {
+        *format = '\0';
+        format++;
+        encoding = strchr(format, ':');
+        if (encoding != NULL)
+        {
+            *encoding = '\0';
+            encoding++;
+        }
+    }
+
+    asset->encoding = ENC_AUTO;
+    if (encoding != NULL)
+    {
+        for (int enc = ENC_AUTO; enc <= ENC_IMAGE; enc++)
+        {
+            if (0 == strcmp(encoding, encoding_names[enc]))
+            {
+                asset->encoding = (encoding_t) enc;
+            }
+        }
+    }
+
+    if (has_suffix(asset->file, ".ttf") || has_suffix(asset->file, ".otf"))
+    {
+        char *end = NULL;
+        char *size;
+
+        if ((NULL != format) && (0 == strncmp(format, "subset", 6U)))
+        {
+            asset->subset = true;
+            size = &format[6];
+        }
+        else if ((NULL != format) && (0 == strncmp(format, "font", 4U)))
+        {
+            size = &format[4];
+        }
+        else
+        {
+            fail("fonts need a format like font24 or subset24, got %s", asset->file);
+        }
+        asset->is_font = true;
+        asset->font_size = (uint32_t) strtoul(size, &end, 10);
+        asset->format = find_format(((end != NULL) && (*end != '\0')) ? end : "l4");
+        if ((asset->format->bits > 8U) || (0U == asset->font_size) || (EVE_PALETTED8 == asset->format->format) ||
+            (EVE_RGB332 == asset->format->format) || (EVE_ARGB2 == asset->format->format))
+        {
+            fail("fonts can only use l1, l2, l4 or l8: %s", asset->file);
+        }
+        if (ENC_IMAGE == asset->encoding)
+        {
+            fail("%s", "fonts can not be uploaded with CMD_LOADIMAGE");
+        }
+    }
+    else
+    {
+        asset->format = find_format((format != NULL) ? format : "argb1555");
+    }
+
+    if (asset->format->min_gen > opt.gen)
+    {
+        fail("format %s is not supported by the selected EVE generation", asset->format->name);
+    }
+    if ((EVE_L2 == asset->format->format) && (opt.gen < 3U))
+    {
+        fail("%s", "L2 needs BT81x");
+    }
+    asset_count++;
+}
+
+int main(int argc, char *argv[])
+{
+    for (int arg = 1; arg < argc; arg++)
+    {
+        const char *value = ((arg + 1) < argc) ? argv[arg + 1] : "";
+
+        if ((0 == strcmp(argv[arg], "-h")) || (0 == strcmp(argv[arg], "--help")))
+        {
+            usage();
+        }
+        else if (0 == strcmp(argv[arg], "-o"))
+        {
+            opt.out = value;
+            arg++;
+        }
+        else if (0 == strcmp(argv[arg], "--spi"))
+        {
+            opt.spi_hz = (uint32_t) strtoul(value, NULL, 0);
+            arg++;
+        }
+        else if (0 == strcmp(argv[arg], "--gen"))
+        {
+            opt.gen = (uint8_t) strtoul(value, NULL, 0);
+            arg++;
+        }
+        else if (0 == strcmp(argv[arg], "--ram-g"))
+        {
+            opt.ram_g_start = (uint32_t) strtoul(value, NULL, 0);
+            arg++;
+        }
+        else if (0 == strcmp(argv[arg], "--ram-g-size"))
+        {
+            opt.ram_g_size = (uint32_t) strtoul(value, NULL, 0);
+            arg++;
+        }
+        else if (0 == strcmp(argv[arg], "--inflate-rate"))
+        {
+            opt.inflate_rate = strtod(value, NULL);
+            arg++;
+        }
+        else if (0 == strcmp(argv[arg], "--png-rate"))
+        {
+            opt.png_rate = strtod(value, NULL);
+            arg++;
+        }
+        else if (0 == strcmp(argv[arg], "--jpeg-rate"))
+        {
+            opt.jpeg_rate = strtod(value, NULL);
+            arg++;
+        }
+        else if (0 == strcmp(argv[arg], "--astcenc"))
+        {
+            opt.astcenc = value;
+            arg++;
+        }
+        else if (0 == strcmp(argv[arg], "--astc-quality"))
+        {
+            opt.astc_quality = value;
+            arg++;
+        }
+        else if (0 == strcmp(argv[arg], "--strings"))
+        {
+            if (opt.strings_count >= STRINGS_MAX)
+            {
+                fail("%s", "too many --strings files");
+            }
+            opt.strings[opt.strings_count++] = value;
+            arg++;
+        }
+        else if (argv[arg][0] == '-')
+        {
+            fail("unknown option %s", argv[arg]);
+        }
+        else
+        {
+            parse_asset(argv[arg]);
+        }
+    }
+
+    if ((0U == asset_count) || (0U == opt.spi_hz) || (opt.inflate_rate <= 0.0) || (opt.png_rate <= 0.0) ||
+        (opt.jpeg_rate <= 0.0))
+    {
+        usage();
+    }
+
+    read_strings();
+    for (uint32_t index = 0U; index < asset_count; index++)
+    {
+        if (assets[index].is_font)
+        {
+            load_font(&assets[index]);
+        }
+        else
+        {
+            load_image(&assets[index]);
+        }
+    }
+
+    place();
+    write_outputs();
+    return EXIT_SUCCESS;
+}
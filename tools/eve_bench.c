@@ -0,0 +1,583 @@
+/*
+@file    eve_bench.c
+@brief   benchmarks the encoders of EVE_commands.c on the host, bytes per command, bytes per frame and transfer times
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+@section Usage
+
+eve_bench [--iterations <n>] [--rounds <n>] [--spi-hz <hz,hz,...>] [--compare <baseline.csv>] [--tolerance <percent>]
+          [--fail-on-time]
+
+The library is linked with a stand-in for EVE that only counts the bytes and transactions, so the results are the cost
+of encoding on the host plus the bytes that go over SPI which are the same on every target.
+The output is CSV with "section,name,metric,value", one line per result:
+- encoder: ns per call, bytes and SPI transactions per call of each EVE_cmd_*() function, burst and non-burst
+- screen: ns per frame, bytes per frame and the fill of the DMA buffer for a set of reference screens
+- spi: transfer time in us per frame of each reference screen for each SPI clock
+All measurements are repeated in --rounds rounds and the fastest time of each is reported. The rounds spread the
+measurements over time, the slower ones are those that shared the CPU with other processes.
+With --compare the results are checked against an earlier run, a changed number of bytes is reported and the exit
+code is 1. A time that is more than --tolerance percent higher is reported as a warning, even the fastest of the
+rounds varies by more than 10 percent from run to run on a busy PC. With --fail-on-time it sets the exit code as well.
+
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "EVE.h"
+
+#define ITERATIONS_DEFAULT 20000U
+#define ROUNDS_DEFAULT 15U
+#define SPI_HZ_MAX 8U
+#define DMA_BUFFER_WORDS 1025U /* uint32_t EVE_dma_buffer[1025] of the DMA targets in EVE_target.h */
+#define RESULT_MAX 512U
+
+typedef struct
+{
+    char section[16];
+    char name[40];
+    char metric[24];
+    double value;
+} result_t;
+
+static result_t results[RESULT_MAX];
+static uint32_t result_count;
+
+/*---- the stand-in for EVE -------------------------------------------------------------------------------------------*/
+
+static uint32_t spi_bytes;
+static uint32_t spi_transactions;
+static uint32_t spi_count;   /* bytes of the current transaction */
+static uint32_t spi_address;
+
+void EVE_host_cs_set(void)
+{
+    spi_transactions++;
+    spi_count = 0U;
+    spi_address = 0U;
+}
+
+void EVE_host_cs_clear(void)
+{
+}
+
+void EVE_host_pdn_set(void)
+{
+}
+
+void EVE_host_pdn_clear(void)
+{
+}
+
+void EVE_host_delay_ms(uint16_t val)
+{
+    (void) val;
+}
+
+/* reads return 0 except for REG_CMDB_SPACE which always reports an empty FIFO so nothing waits */
+uint8_t EVE_host_spi_transfer(uint8_t data)
+{
+    uint8_t result = 0U;
+
+    spi_bytes++;
+    if (spi_count < 3U)
+    {
+        spi_address = (spi_address << 8U) | data;
+    }
+    else if ((spi_count > 3U) && (0U == (spi_address & 0x800000UL)))
+    {
+        uint32_t offset = spi_count - 4U;
+
+        if ((REG_CMDB_SPACE == (spi_address & 0x3fffffUL)) && (offset < 2U))
+        {
+            result = (uint8_t) (0xffcU >> (offset * 8U));
+        }
+    }
+    spi_count++;
+    return result;
+}
+
+/*---- measurement ----------------------------------------------------------------------------------------------------*/
+
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec * 1000000000U) + (uint64_t) now.tv_nsec;
+}
+
+/* a result that is already there from an earlier round keeps the lower value */
+static void add_result(const char *section, const char *name, const char *metric, double value)
+{
+    for (uint32_t index = 0U; index < result_count; index++)
+    {
+        result_t *result = &results[index];
+
+        if ((0 == strcmp(result->section, section)) && (0 == strcmp(result->name, name)) &&
+            (0 == strcmp(result->metric, metric)))
+        {
+            if (value < result->value)
+            {
+                result->value = value;
+            }
+            return;
+        }
+    }
+    if (result_count < RESULT_MAX)
+    {
+        result_t *result = &results[result_count];
+
+        snprintf(result->section, sizeof(result->section), "%s", section);
+        snprintf(result->name, sizeof(result->name), "%s", name);
+        snprintf(result->metric, sizeof(result->metric), "%s", metric);
+        result->value = value;
+        result_count++;
+    }
+}
+
+/*---- the encoders ---------------------------------------------------------------------------------------------------*/
+
+static void b_dl(void) { EVE_cmd_dl_burst(COLOR_RGB(255U, 255U, 255U)); }
+static void n_dl(void) { EVE_cmd_dl(COLOR_RGB(255U, 255U, 255U)); }
+static void b_color_rgb(void) { EVE_color_rgb_burst(0x00ff8000UL); }
+static void n_color_rgb(void) { EVE_color_rgb(0x00ff8000UL); }
+static void b_fgcolor(void) { EVE_cmd_fgcolor_burst(0x00c0c0c0UL); }
+static void n_fgcolor(void) { EVE_cmd_fgcolor(0x00c0c0c0UL); }
+static void b_text(void) { EVE_cmd_text_burst(10, 10, 28, 0U, "Hello World"); }
+static void n_text(void) { EVE_cmd_text(10, 10, 28, 0U, "Hello World"); }
+static void b_number(void) { EVE_cmd_number_burst(100, 10, 26, EVE_OPT_RIGHTX, 12345); }
+static void n_number(void) { EVE_cmd_number(100, 10, 26, EVE_OPT_RIGHTX, 12345); }
+static void b_button(void) { EVE_cmd_button_burst(20, 20, 80, 30, 28, 0U, "Touch!"); }
+static void n_button(void) { EVE_cmd_button(20, 20, 80, 30, 28, 0U, "Touch!"); }
+static void b_toggle(void) { EVE_cmd_toggle_burst(20, 60, 60, 27, 0U, 0U, "no" "\xff" "yes"); }
+static void n_toggle(void) { EVE_cmd_toggle(20, 60, 60, 27, 0U, 0U, "no" "\xff" "yes"); }
+static void b_slider(void) { EVE_cmd_slider_burst(20, 100, 200, 10, 0U, 50U, 100U); }
+static void n_slider(void) { EVE_cmd_slider(20, 100, 200, 10, 0U, 50U, 100U); }
+static void b_progress(void) { EVE_cmd_progress_burst(20, 120, 200, 10, 0U, 50U, 100U); }
+static void n_progress(void) { EVE_cmd_progress(20, 120, 200, 10, 0U, 50U, 100U); }
+static void b_scrollbar(void) { EVE_cmd_scrollbar_burst(20, 140, 200, 10, 0U, 20U, 10U, 100U); }
+static void n_scrollbar(void) { EVE_cmd_scrollbar(20, 140, 200, 10, 0U, 20U, 10U, 100U); }
+static void b_gauge(void) { EVE_cmd_gauge_burst(300, 100, 50, 0U, 10U, 5U, 30U, 100U); }
+static void n_gauge(void) { EVE_cmd_gauge(300, 100, 50, 0U, 10U, 5U, 30U, 100U); }
+static void b_dial(void) { EVE_cmd_dial_burst(400, 100, 40, 0U, 0x4000U); }
+static void n_dial(void) { EVE_cmd_dial(400, 100, 40, 0U, 0x4000U); }
+static void b_clock(void) { EVE_cmd_clock_burst(300, 200, 50, 0U, 10U, 20U, 30U, 0U); }
+static void n_clock(void) { EVE_cmd_clock(300, 200, 50, 0U, 10U, 20U, 30U, 0U); }
+static void b_keys(void) { EVE_cmd_keys_burst(20, 200, 200, 30, 28, 0U, "12345"); }
+static void n_keys(void) { EVE_cmd_keys(20, 200, 200, 30, 28, 0U, "12345"); }
+static void b_gradient(void) { EVE_cmd_gradient_burst(0, 0, 0x000000ffUL, 0, 272, 0x00ff0000UL); }
+static void n_gradient(void) { EVE_cmd_gradient(0, 0, 0x000000ffUL, 0, 272, 0x00ff0000UL); }
+static void b_setbitmap(void) { EVE_cmd_setbitmap_burst(0x1000UL, EVE_RGB565, 100U, 100U); }
+static void n_setbitmap(void) { EVE_cmd_setbitmap(0x1000UL, EVE_RGB565, 100U, 100U); }
+static void b_translate(void) { EVE_cmd_translate_burst(65536 * 70, 65536 * 50); }
+static void n_translate(void) { EVE_cmd_translate(65536 * 70, 65536 * 50); }
+static void b_rotate(void) { EVE_cmd_rotate_burst(256); }
+static void n_rotate(void) { EVE_cmd_rotate(256); }
+static void b_append(void) { EVE_cmd_append_burst(0x1000UL, 256UL); }
+static void n_append(void) { EVE_cmd_append(0x1000UL, 256UL); }
+
+typedef struct
+{
+    const char *name;
+    void (*burst)(void);
+    void (*single)(void);
+} encoder_t;
+
+static const encoder_t encoders[] =
+{
+    {"cmd_dl", b_dl, n_dl},
+    {"color_rgb", b_color_rgb, n_color_rgb},
+    {"cmd_fgcolor", b_fgcolor, n_fgcolor},
+    {"cmd_text", b_text, n_text},
+    {"cmd_number", b_number, n_number},
+    {"cmd_button", b_button, n_button},
+    {"cmd_toggle", b_toggle, n_toggle},
+    {"cmd_slider", b_slider, n_slider},
+    {"cmd_progress", b_progress, n_progress},
+    {"cmd_scrollbar", b_scrollbar, n_scrollbar},
+    {"cmd_gauge", b_gauge, n_gauge},
+    {"cmd_dial", b_dial, n_dial},
+    {"cmd_clock", b_clock, n_clock},
+    {"cmd_keys", b_keys, n_keys},
+    {"cmd_gradient", b_gradient, n_gradient},
+    {"cmd_setbitmap", b_setbitmap, n_setbitmap},
+    {"cmd_translate", b_translate, n_translate},
+    {"cmd_rotate", b_rotate, n_rotate},
+    {"cmd_append", b_append, n_append},
+};
+
+static void bench_encoder(const encoder_t *encoder, uint32_t iterations)
+{
+    char name[48];
+    uint64_t start;
+    uint32_t bytes;
+    uint32_t transactions;
+
+    /* burst: one transaction for all calls, the bytes are counted without the three address bytes */
+    EVE_start_cmd_burst();
+    bytes = spi_bytes;
+    encoder->burst();
+    bytes = spi_bytes - bytes;
+    for (uint32_t count = 0U; count < (iterations / 10U); count++)
+    {
+        encoder->burst(); /* warm up the caches */
+    }
+    start = now_ns();
+    for (uint32_t count = 0U; count < iterations; count++)
+    {
+        encoder->burst();
+    }
+    start = now_ns() - start;
+    EVE_end_cmd_burst();
+    snprintf(name, sizeof(name), "%s_burst", encoder->name);
+    add_result("encoder", name, "ns", (double) start / iterations);
+    add_result("encoder", name, "bytes", bytes);
+    add_result("encoder", name, "transactions", 0.0);
+
+    /* non-burst: every call is a transaction of its own */
+    bytes = spi_bytes;
+    transactions = spi_transactions;
+    encoder->single();
+    bytes = spi_bytes - bytes;
+    transactions = spi_transactions - transactions;
+    start = now_ns();
+    for (uint32_t count = 0U; count < iterations; count++)
+    {
+        encoder->single();
+    }
+    start = now_ns() - start;
+    add_result("encoder", encoder->name, "ns", (double) start / iterations);
+    add_result("encoder", encoder->name, "bytes", bytes);
+    add_result("encoder", encoder->name, "transactions", transactions);
+}
+
+/*---- the reference screens ------------------------------------------------------------------------------------------*/
+
+static void screen_begin(void)
+{
+    EVE_start_cmd_burst();
+    EVE_cmd_dl_burst(CMD_DLSTART);
+    EVE_cmd_dl_burst(CLEAR_COLOR_RGB(255U, 255U, 255U));
+    EVE_cmd_dl_burst(DL_CLEAR | CLR_COL | CLR_STN | CLR_TAG);
+}
+
+static void screen_end(void)
+{
+    EVE_cmd_dl_burst(DL_DISPLAY);
+    EVE_cmd_dl_burst(CMD_SWAP);
+    EVE_end_cmd_burst();
+}
+
+/* a text heavy screen like a list or a log */
+static void screen_text(void)
+{
+    screen_begin();
+    EVE_color_rgb_burst(0x00000000UL);
+    for (int16_t line = 0; line < 16; line++)
+    {
+        EVE_cmd_text_burst(10, (int16_t) (line * 16), 26, 0U, "The quick brown fox jumps over the lazy dog");
+        EVE_cmd_number_burst(470, (int16_t) (line * 16), 26, EVE_OPT_RIGHTX, 1000 + line);
+    }
+    screen_end();
+}
+
+/* a control panel with the co-processor widgets */
+static void screen_widgets(void)
+{
+    screen_begin();
+    EVE_cmd_fgcolor_burst(0x00c0c0c0UL);
+    for (uint16_t index = 0U; index < 6U; index++)
+    {
+        EVE_cmd_dl_burst(TAG(index + 1U));
+        EVE_cmd_button_burst((int16_t) (10 + (index * 78)), 10, 70, 30, 27, 0U, "Button");
+    }
+    EVE_cmd_dl_burst(TAG(0U));
+    EVE_cmd_slider_burst(20, 60, 200, 10, 0U, 50U, 100U);
+    EVE_cmd_progress_burst(20, 90, 200, 10, 0U, 30U, 100U);
+    EVE_cmd_scrollbar_burst(20, 120, 200, 10, 0U, 20U, 10U, 100U);
+    EVE_cmd_toggle_burst(20, 150, 60, 27, 0U, 0U, "off" "\xff" "on");
+    EVE_cmd_gauge_burst(300, 110, 50, 0U, 10U, 5U, 30U, 100U);
+    EVE_cmd_dial_burst(420, 110, 40, 0U, 0x4000U);
+    EVE_cmd_clock_burst(300, 220, 40, 0U, 10U, 20U, 30U, 0U);
+    EVE_cmd_keys_burst(20, 200, 200, 30, 28, 0U, "12345");
+    screen_end();
+}
+
+/* a screen with bitmaps and a rotated picture */
+static void screen_bitmaps(void)
+{
+    screen_begin();
+    EVE_cmd_setbitmap_burst(0x1000UL, EVE_RGB565, 32U, 32U);
+    EVE_cmd_dl_burst(DL_BEGIN | EVE_BITMAPS);
+    for (uint32_t index = 0U; index < 40U; index++)
+    {
+        EVE_cmd_dl_burst(VERTEX2F((index % 10U) * 48U * 16U, (index / 10U) * 48U * 16U));
+    }
+    EVE_cmd_dl_burst(DL_END);
+    EVE_cmd_setbitmap_burst(0x10000UL, EVE_RGB565, 100U, 100U);
+    EVE_cmd_dl_burst(CMD_LOADIDENTITY);
+    EVE_cmd_translate_burst(65536 * 50, 65536 * 50);
+    EVE_cmd_rotate_burst(4096);
+    EVE_cmd_translate_burst(65536 * -50, 65536 * -50);
+    EVE_cmd_dl_burst(CMD_SETMATRIX);
+    EVE_cmd_dl_burst(DL_BEGIN | EVE_BITMAPS);
+    EVE_cmd_dl_burst(VERTEX2F(350U * 16U, 150U * 16U));
+    EVE_cmd_dl_burst(DL_END);
+    screen_end();
+}
+
+/* the screen of the demo in the examples, a static part appended from RAM_G plus a couple of commands */
+static void screen_demo(void)
+{
+    screen_begin();
+    EVE_cmd_dl_burst(TAG(0U));
+    EVE_cmd_append_burst(0x1000UL, 100UL);
+    EVE_color_rgb_burst(0x00ffffffUL);
+    EVE_cmd_fgcolor_burst(0x00c0c0c0UL);
+    EVE_cmd_dl_burst(TAG(10U));
+    EVE_cmd_button_burst(20, 20, 80, 30, 28, 0U, "Touch!");
+    EVE_cmd_dl_burst(TAG(0U));
+    EVE_cmd_setbitmap_burst(0x10000UL, EVE_RGB565, 100U, 100U);
+    EVE_cmd_dl_burst(CMD_LOADIDENTITY);
+    EVE_cmd_translate_burst(65536 * 70, 65536 * 50);
+    EVE_cmd_rotate_burst(256);
+    EVE_cmd_translate_burst(65536 * -70, 65536 * -50);
+    EVE_cmd_dl_burst(CMD_SETMATRIX);
+    EVE_cmd_dl_burst(DL_BEGIN | EVE_BITMAPS);
+    EVE_cmd_dl_burst(VERTEX2F(380U * 16U, 10U * 16U));
+    EVE_cmd_dl_burst(DL_END);
+    EVE_cmd_dl_burst(DL_RESTORE_CONTEXT);
+    EVE_color_rgb_burst(0x00000000UL);
+    EVE_cmd_number_burst(100, 222, 26, EVE_OPT_RIGHTX, 1234);
+    EVE_cmd_number_burst(100, 237, 26, EVE_OPT_RIGHTX | 4U, 567);
+    EVE_cmd_number_burst(100, 252, 26, EVE_OPT_RIGHTX | 4U, 89);
+    screen_end();
+}
+
+typedef struct
+{
+    const char *name;
+    void (*build)(void);
+} screen_t;
+
+static const screen_t screens[] =
+{
+    {"text", screen_text},
+    {"widgets", screen_widgets},
+    {"bitmaps", screen_bitmaps},
+    {"demo", screen_demo},
+};
+
+static void bench_screen(const screen_t *screen, uint32_t iterations, const uint32_t spi_hz[], uint32_t spi_hz_count)
+{
+    uint64_t start;
+    uint32_t bytes;
+    uint32_t words;
+
+    bytes = spi_bytes;
+    screen->build();
+    bytes = spi_bytes - bytes;
+    start = now_ns();
+    for (uint32_t count = 0U; count < iterations; count++)
+    {
+        screen->build();
+    }
+    start = now_ns() - start;
+
+    /* the DMA buffer holds the address in the first word and then the words of the commands */
+    words = 1U + ((bytes - 3U) / 4U);
+
+    add_result("screen", screen->name, "ns", (double) start / iterations);
+    add_result("screen", screen->name, "bytes", bytes);
+    add_result("screen", screen->name, "dma_fill_percent", (100.0 * words) / DMA_BUFFER_WORDS);
+    for (uint32_t index = 0U; index < spi_hz_count; index++)
+    {
+        char metric[24];
+
+        snprintf(metric, sizeof(metric), "us_at_%uhz", spi_hz[index]);
+        add_result("spi", screen->name, metric, (8.0e6 * bytes) / spi_hz[index]);
+    }
+}
+
+/*---- comparison with an earlier run ---------------------------------------------------------------------------------*/
+
+static uint32_t compare(const char *path, double tolerance, bool fail_on_time)
+{
+    FILE *file = fopen(path, "r");
+    char line[256];
+    uint32_t regressions = 0U;
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "eve_bench: can not open %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        result_t old;
+
+        if (sscanf(line, "%15[^,],%39[^,],%23[^,],%lf", old.section, old.name, old.metric, &old.value) != 4)
+        {
+            continue; /* the header */
+        }
+        for (uint32_t index = 0U; index < result_count; index++)
+        {
+            const result_t *result = &results[index];
+            bool worse;
+            bool time;
+
+            if ((strcmp(result->section, old.section) != 0) || (strcmp(result->name, old.name) != 0) ||
+                (strcmp(result->metric, old.metric) != 0))
+            {
+                continue;
+            }
+            time = (0 == strcmp(result->metric, "ns"));
+            if (time)
+            {
+                worse = result->value > (old.value * (1.0 + (tolerance / 100.0)));
+            }
+            else
+            {
+                worse = (result->value > (old.value + 0.005)) || (result->value < (old.value - 0.005));
+            }
+            if (worse)
+            {
+                fprintf(stderr, "eve_bench: %s%s,%s,%s changed from %.2f to %.2f\n",
+                    (time && !fail_on_time) ? "warning, " : "", result->section, result->name, result->metric,
+                    old.value, result->value);
+                if (fail_on_time || !time)
+                {
+                    regressions++;
+                }
+            }
+        }
+    }
+    fclose(file);
+    return regressions;
+}
+
+static void usage(void)
+{
+    printf("usage: eve_bench [--iterations <n>] [--rounds <n>] [--spi-hz <hz,hz,...>] [--compare <baseline.csv>]\n"
+           "                 [--tolerance <percent>] [--fail-on-time]\n"
+           "  --iterations <n>       calls per measurement, default: %u\n"
+           "  --rounds <n>           repetitions of all measurements, the fastest time is reported, default: %u\n"
+           "  --spi-hz <hz,...>      SPI clocks for the transfer times, default: 8000000,16000000,30000000\n"
+           "  --compare <file>       report differences to the CSV output of an earlier run, exit code 1 if there are any\n"
+           "  --tolerance <percent>  allowed increase of the times for --compare, default: 10\n"
+           "  --fail-on-time         times above the tolerance also set exit code 1, not only changed bytes\n",
+           ITERATIONS_DEFAULT, ROUNDS_DEFAULT);
+    exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = ITERATIONS_DEFAULT;
+    uint32_t rounds = ROUNDS_DEFAULT;
+    uint32_t spi_hz[SPI_HZ_MAX] = {8000000U, 16000000U, 30000000U};
+    uint32_t spi_hz_count = 3U;
+    const char *baseline = NULL;
+    double tolerance = 10.0;
+    bool fail_on_time = false;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "--iterations")) && ((arg + 1) < argc))
+        {
+            iterations = (uint32_t) strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[arg], "--rounds")) && ((arg + 1) < argc))
+        {
+            rounds = (uint32_t) strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[arg], "--spi-hz")) && ((arg + 1) < argc))
+        {
+            char *list = argv[++arg];
+
+            spi_hz_count = 0U;
+            while ((*list != '\0') && (spi_hz_count < SPI_HZ_MAX))
+            {
+                spi_hz[spi_hz_count] = (uint32_t) strtoul(list, &list, 0);
+                if (spi_hz[spi_hz_count] != 0U)
+                {
+                    spi_hz_count++;
+                }
+                list = (',' == *list) ? &list[1] : &list[strlen(list)];
+            }
+        }
+        else if ((0 == strcmp(argv[arg], "--compare")) && ((arg + 1) < argc))
+        {
+            baseline = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--tolerance")) && ((arg + 1) < argc))
+        {
+            tolerance = strtod(argv[++arg], NULL);
+        }
+        else if (0 == strcmp(argv[arg], "--fail-on-time"))
+        {
+            fail_on_time = true;
+        }
+        else
+        {
+            usage();
+        }
+    }
+    if ((0U == iterations) || (0U == rounds))
+    {
+        usage();
+    }
+
+    for (uint32_t round = 0U; round < rounds; round++)
+    {
+        for (size_t index = 0U; index < (sizeof(encoders) / sizeof(encoders[0])); index++)
+        {
+            bench_encoder(&encoders[index], iterations);
+        }
+        for (size_t index = 0U; index < (sizeof(screens) / sizeof(screens[0])); index++)
+        {
+            bench_screen(&screens[index], iterations / 10U + 1U, spi_hz, spi_hz_count);
+        }
+    }
+
+    printf("section,name,metric,value\n");
+    for (uint32_t index = 0U; index < result_count; index++)
+    {
+        printf("%s,%s,%s,%.2f\n", results[index].section, results[index].name, results[index].metric, results[index].value);
+    }
+
+    if ((baseline != NULL) && (compare(baseline, tolerance, fail_on_time) != 0U))
+    {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
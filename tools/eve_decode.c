@@ -0,0 +1,689 @@
+/*
+@file    eve_decode.c
+@brief   decoder for display-list words and co-processor command streams, used by the tools
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <zlib.h>
+
+#include "EVE.h"
+#include "eve_decode.h"
+
+/* The parameters of the co-processor commands, one character per 32 bit word:
+ * i - int32, x - uint32 as hex, c - color, o - options, p - two int16, q - int16 and options, r - options and uint16,
+ * u - two uint16, s - string padded to 4 bytes plus the arguments for EVE_OPT_FORMAT,
+ * w - data with the length of the previous parameter, Z - zlib data, z - zlib data unless the options say
+ * EVE_OPT_MEDIAFIFO or EVE_OPT_FLASH, m - PNG or JPEG data with the same exception, v - video data */
+typedef struct
+{
+    uint32_t command;
+    const char *name;
+    const char *params;
+} cmd_info_t;
+
+static const cmd_info_t cmd_info[] =
+{
+    {CMD_DLSTART, "CMD_DLSTART", ""},
+    {CMD_SWAP, "CMD_SWAP", ""},
+    {CMD_INTERRUPT, "CMD_INTERRUPT", "i"},
+    {CMD_BGCOLOR, "CMD_BGCOLOR", "c"},
+    {CMD_FGCOLOR, "CMD_FGCOLOR", "c"},
+    {CMD_GRADIENT, "CMD_GRADIENT", "pcpc"},
+    {CMD_TEXT, "CMD_TEXT", "pqs"},
+    {CMD_BUTTON, "CMD_BUTTON", "ppqs"},
+    {CMD_KEYS, "CMD_KEYS", "ppqs"},
+    {CMD_PROGRESS, "CMD_PROGRESS", "ppri"},
+    {CMD_SLIDER, "CMD_SLIDER", "ppri"},
+    {CMD_SCROLLBAR, "CMD_SCROLLBAR", "ppru"},
+    {CMD_TOGGLE, "CMD_TOGGLE", "pprs"},
+    {CMD_GAUGE, "CMD_GAUGE", "pquu"},
+    {CMD_CLOCK, "CMD_CLOCK", "pquu"},
+    {CMD_CALIBRATE, "CMD_CALIBRATE", "x"},
+    {CMD_SPINNER, "CMD_SPINNER", "pu"},
+    {CMD_STOP, "CMD_STOP", ""},
+    {CMD_MEMCRC, "CMD_MEMCRC", "xix"},
+    {CMD_REGREAD, "CMD_REGREAD", "xx"},
+    {CMD_MEMWRITE, "CMD_MEMWRITE", "xiw"},
+    {CMD_MEMSET, "CMD_MEMSET", "xxi"},
+    {CMD_MEMZERO, "CMD_MEMZERO", "xi"},
+    {CMD_MEMCPY, "CMD_MEMCPY", "xxi"},
+    {CMD_APPEND, "CMD_APPEND", "xi"},
+    {CMD_SNAPSHOT, "CMD_SNAPSHOT", "x"},
+    {CMD_INFLATE, "CMD_INFLATE", "xZ"},
+    {CMD_GETPTR, "CMD_GETPTR", "x"},
+    {CMD_LOADIMAGE, "CMD_LOADIMAGE", "xom"},
+    {CMD_GETPROPS, "CMD_GETPROPS", "xii"},
+    {CMD_LOADIDENTITY, "CMD_LOADIDENTITY", ""},
+    {CMD_TRANSLATE, "CMD_TRANSLATE", "ii"},
+    {CMD_SCALE, "CMD_SCALE", "ii"},
+    {CMD_ROTATE, "CMD_ROTATE", "i"},
+    {CMD_SETMATRIX, "CMD_SETMATRIX", ""},
+    {CMD_SETFONT, "CMD_SETFONT", "ix"},
+    {CMD_TRACK, "CMD_TRACK", "ppi"},
+    {CMD_DIAL, "CMD_DIAL", "pqi"},
+    {CMD_NUMBER, "CMD_NUMBER", "pqi"},
+    {CMD_SCREENSAVER, "CMD_SCREENSAVER", ""},
+    {CMD_SKETCH, "CMD_SKETCH", "ppxi"},
+    {CMD_LOGO, "CMD_LOGO", ""},
+    {CMD_COLDSTART, "CMD_COLDSTART", ""},
+    {CMD_GETMATRIX, "CMD_GETMATRIX", "iiiiii"},
+    {CMD_GRADCOLOR, "CMD_GRADCOLOR", "c"},
+    {CMD_SETROTATE, "CMD_SETROTATE", "i"},
+    {CMD_SNAPSHOT2, "CMD_SNAPSHOT2", "ixpp"},
+    {CMD_SETBASE, "CMD_SETBASE", "i"},
+    {CMD_MEDIAFIFO, "CMD_MEDIAFIFO", "xi"},
+    {CMD_PLAYVIDEO, "CMD_PLAYVIDEO", "ov"},
+    {CMD_SETFONT2, "CMD_SETFONT2", "ixi"},
+    {CMD_SETSCRATCH, "CMD_SETSCRATCH", "i"},
+    {CMD_ROMFONT, "CMD_ROMFONT", "ii"},
+    {CMD_VIDEOSTART, "CMD_VIDEOSTART", ""},
+    {CMD_VIDEOFRAME, "CMD_VIDEOFRAME", "xx"},
+    {CMD_SETBITMAP, "CMD_SETBITMAP", "xui"},
+#if EVE_GEN > 2
+    {CMD_BITMAP_TRANSFORM, "CMD_BITMAP_TRANSFORM", "iiiiiiiiiiiix"},
+    {CMD_SYNC, "CMD_SYNC", ""},
+    {CMD_FLASHERASE, "CMD_FLASHERASE", ""},
+    {CMD_FLASHWRITE, "CMD_FLASHWRITE", "xiw"},
+    {CMD_FLASHREAD, "CMD_FLASHREAD", "xxi"},
+    {CMD_FLASHUPDATE, "CMD_FLASHUPDATE", "xxi"},
+    {CMD_FLASHDETACH, "CMD_FLASHDETACH", ""},
+    {CMD_FLASHATTACH, "CMD_FLASHATTACH", ""},
+    {CMD_FLASHFAST, "CMD_FLASHFAST", "x"},
+    {CMD_FLASHSPIDESEL, "CMD_FLASHSPIDESEL", ""},
+    {CMD_FLASHSPITX, "CMD_FLASHSPITX", "iw"},
+    {CMD_FLASHSPIRX, "CMD_FLASHSPIRX", "xi"},
+    {CMD_FLASHSOURCE, "CMD_FLASHSOURCE", "x"},
+    {CMD_CLEARCACHE, "CMD_CLEARCACHE", ""},
+    {CMD_INFLATE2, "CMD_INFLATE2", "xoz"},
+    {CMD_ROTATEAROUND, "CMD_ROTATEAROUND", "iiii"},
+    {CMD_RESETFONTS, "CMD_RESETFONTS", ""},
+    {CMD_ANIMSTART, "CMD_ANIMSTART", "ixi"},
+    {CMD_ANIMSTOP, "CMD_ANIMSTOP", "i"},
+    {CMD_ANIMXY, "CMD_ANIMXY", "ip"},
+    {CMD_ANIMDRAW, "CMD_ANIMDRAW", "i"},
+    {CMD_GRADIENTA, "CMD_GRADIENTA", "pcpc"},
+    {CMD_FILLWIDTH, "CMD_FILLWIDTH", "i"},
+    {CMD_APPENDF, "CMD_APPENDF", "xi"},
+    {CMD_ANIMFRAME, "CMD_ANIMFRAME", "pxi"},
+    {CMD_VIDEOSTARTF, "CMD_VIDEOSTARTF", ""},
+#endif
+#if EVE_GEN > 3
+    {CMD_CALIBRATESUB, "CMD_CALIBRATESUB", "ppx"},
+    {CMD_TESTCARD, "CMD_TESTCARD", ""},
+    {CMD_HSF, "CMD_HSF", "i"},
+    {CMD_APILEVEL, "CMD_APILEVEL", "i"},
+    {CMD_GETIMAGE, "CMD_GETIMAGE", "xiiix"},
+    {CMD_WAIT, "CMD_WAIT", "i"},
+    {CMD_RETURN, "CMD_RETURN", ""},
+    {CMD_CALLLIST, "CMD_CALLLIST", "x"},
+    {CMD_NEWLIST, "CMD_NEWLIST", "x"},
+    {CMD_ENDLIST, "CMD_ENDLIST", ""},
+    {CMD_PCLKFREQ, "CMD_PCLKFREQ", "iii"},
+    {CMD_FONTCACHE, "CMD_FONTCACHE", "ixi"},
+    {CMD_FONTCACHEQUERY, "CMD_FONTCACHEQUERY", "ii"},
+    {CMD_ANIMFRAMERAM, "CMD_ANIMFRAMERAM", "pxi"},
+    {CMD_ANIMSTARTRAM, "CMD_ANIMSTARTRAM", "ixi"},
+    {CMD_RUNANIM, "CMD_RUNANIM", "xi"},
+    {CMD_LINETIME, "CMD_LINETIME", "x"},
+    {CMD_FLASHPROGRAM, "CMD_FLASHPROGRAM", "xxi"},
+#endif
+};
+
+static const char *const dl_names[] =
+{
+    "DISPLAY", "BITMAP_SOURCE", "CLEAR_COLOR_RGB", "TAG", "COLOR_RGB", "BITMAP_HANDLE", "CELL", "BITMAP_LAYOUT",
+    "BITMAP_SIZE", "ALPHA_FUNC", "STENCIL_FUNC", "BLEND_FUNC", "STENCIL_OP", "POINT_SIZE", "LINE_WIDTH",
+    "CLEAR_COLOR_A", "COLOR_A", "CLEAR_STENCIL", "CLEAR_TAG", "STENCIL_MASK", "TAG_MASK", "BITMAP_TRANSFORM_A",
+    "BITMAP_TRANSFORM_B", "BITMAP_TRANSFORM_C", "BITMAP_TRANSFORM_D", "BITMAP_TRANSFORM_E", "BITMAP_TRANSFORM_F",
+    "SCISSOR_XY", "SCISSOR_SIZE", "CALL", "JUMP", "BEGIN", "COLOR_MASK", "END", "SAVE_CONTEXT", "RESTORE_CONTEXT",
+    "RETURN", "MACRO", "CLEAR", "VERTEX_FORMAT", "BITMAP_LAYOUT_H", "BITMAP_SIZE_H", "PALETTE_SOURCE",
+    "VERTEX_TRANSLATE_X", "VERTEX_TRANSLATE_Y", "NOP", "BITMAP_EXT_FORMAT", "BITMAP_SWIZZLE", "INT_FRR"
+};
+
+static const char *const primitive_names[] =
+{
+    "0", "EVE_BITMAPS", "EVE_POINTS", "EVE_LINES", "EVE_LINE_STRIP", "EVE_EDGE_STRIP_R", "EVE_EDGE_STRIP_L",
+    "EVE_EDGE_STRIP_A", "EVE_EDGE_STRIP_B", "EVE_RECTS"
+};
+
+static const char *const format_names[] =
+{
+    "EVE_ARGB1555", "EVE_L1", "EVE_L4", "EVE_L8", "EVE_RGB332", "EVE_ARGB2", "EVE_ARGB4", "EVE_RGB565",
+    "EVE_PALETTED", "EVE_TEXT8X8", "EVE_TEXTVGA", "EVE_BARGRAPH", "12", "13", "EVE_PALETTED565", "EVE_PALETTED4444",
+    "EVE_PALETTED8", "EVE_L2", "18", "19", "20", "21", "22", "23", "24", "25", "26", "27", "28", "29", "30", "EVE_GLFORMAT"
+};
+
+static const char *const test_names[] =
+{
+    "EVE_NEVER", "EVE_LESS", "EVE_LEQUAL", "EVE_GREATER", "EVE_GEQUAL", "EVE_EQUAL", "EVE_NOTEQUAL", "EVE_ALWAYS"
+};
+
+static const char *const blend_names[] =
+{
+    "EVE_ZERO", "EVE_ONE", "EVE_SRC_ALPHA", "EVE_DST_ALPHA", "EVE_ONE_MINUS_SRC_ALPHA", "EVE_ONE_MINUS_DST_ALPHA", "6", "7"
+};
+
+static const char *const stencil_names[] =
+{
+    "EVE_ZERO", "EVE_KEEP", "EVE_REPLACE", "EVE_INCR", "EVE_DECR", "EVE_INVERT", "6", "7"
+};
+
+static int32_t sign_extend(uint32_t value, uint8_t bits)
+{
+    uint32_t sign = 1U << (bits - 1U);
+
+    value &= (sign << 1U) - 1U;
+    return (int32_t) (value ^ sign) - (int32_t) sign;
+}
+
+void eve_decode_dl(uint32_t word, char *text, size_t size)
+{
+    uint32_t opcode = word >> 24U;
+
+    if (1U == (word >> 30U))
+    {
+        snprintf(text, size, "VERTEX2F(%d, %d)", sign_extend(word >> 15U, 15U), sign_extend(word, 15U));
+        return;
+    }
+    if (2U == (word >> 30U))
+    {
+        snprintf(text, size, "VERTEX2II(%u, %u, %u, %u)", (word >> 21U) & 511U, (word >> 12U) & 511U,
+            (word >> 7U) & 31U, word & 127U);
+        return;
+    }
+    if (opcode >= (sizeof(dl_names) / sizeof(dl_names[0])))
+    {
+        snprintf(text, size, "0x%08x /* unknown */", word);
+        return;
+    }
+
+    switch (opcode)
+    {
+        case 0U: /* DISPLAY */
+        case 33U: /* END */
+        case 34U: /* SAVE_CONTEXT */
+        case 35U: /* RESTORE_CONTEXT */
+        case 36U: /* RETURN */
+        case 45U: /* NOP */
+        case 48U: /* INT_FRR */
+            snprintf(text, size, "%s()", dl_names[opcode]);
+            break;
+        case 1U: /* BITMAP_SOURCE */
+            if ((word & 0x800000U) != 0U)
+            {
+                snprintf(text, size, "BITMAP_SOURCE2(1, 0x%06x) /* flash 0x%x */", word & 0x7fffffU, (word & 0x7fffffU) << 5U);
+            }
+            else
+            {
+                snprintf(text, size, "BITMAP_SOURCE(0x%06x)", word & 0x7fffffU);
+            }
+            break;
+        case 2U: /* CLEAR_COLOR_RGB */
+        case 4U: /* COLOR_RGB */
+            snprintf(text, size, "%s(%u, %u, %u)", dl_names[opcode], (word >> 16U) & 255U, (word >> 8U) & 255U, word & 255U);
+            break;
+        case 7U: /* BITMAP_LAYOUT */
+            snprintf(text, size, "BITMAP_LAYOUT(%s, %u, %u)", format_names[(word >> 19U) & 31U], (word >> 9U) & 1023U,
+                word & 511U);
+            break;
+        case 8U: /* BITMAP_SIZE */
+            snprintf(text, size, "BITMAP_SIZE(%s, %s, %s, %u, %u)", ((word >> 20U) & 1U) ? "EVE_BILINEAR" : "EVE_NEAREST",
+                ((word >> 19U) & 1U) ? "EVE_REPEAT" : "EVE_BORDER", ((word >> 18U) & 1U) ? "EVE_REPEAT" : "EVE_BORDER",
+                (word >> 9U) & 511U, word & 511U);
+            break;
+        case 9U: /* ALPHA_FUNC */
+            snprintf(text, size, "ALPHA_FUNC(%s, %u)", test_names[(word >> 8U) & 7U], word & 255U);
+            break;
+        case 10U: /* STENCIL_FUNC */
+            snprintf(text, size, "STENCIL_FUNC(%s, %u, 0x%02x)", test_names[(word >> 16U) & 7U], (word >> 8U) & 255U,
+                word & 255U);
+            break;
+        case 11U: /* BLEND_FUNC */
+            snprintf(text, size, "BLEND_FUNC(%s, %s)", blend_names[(word >> 3U) & 7U], blend_names[word & 7U]);
+            break;
+        case 12U: /* STENCIL_OP */
+            snprintf(text, size, "STENCIL_OP(%s, %s)", stencil_names[(word >> 3U) & 7U], stencil_names[word & 7U]);
+            break;
+        case 21U: /* BITMAP_TRANSFORM_A */
+        case 22U: /* BITMAP_TRANSFORM_B */
+        case 24U: /* BITMAP_TRANSFORM_D */
+        case 25U: /* BITMAP_TRANSFORM_E */
+            if ((word & 0x20000U) != 0U)
+            {
+                snprintf(text, size, "%s_EXT(1, %d)", dl_names[opcode], sign_extend(word, 17U));
+            }
+            else
+            {
+                snprintf(text, size, "%s(%d)", dl_names[opcode], sign_extend(word, 17U));
+            }
+            break;
+        case 23U: /* BITMAP_TRANSFORM_C */
+        case 26U: /* BITMAP_TRANSFORM_F */
+            snprintf(text, size, "%s(%d)", dl_names[opcode], sign_extend(word, 24U));
+            break;
+        case 27U: /* SCISSOR_XY */
+            snprintf(text, size, "SCISSOR_XY(%u, %u)", (word >> 11U) & 2047U, word & 2047U);
+            break;
+        case 28U: /* SCISSOR_SIZE */
+            snprintf(text, size, "SCISSOR_SIZE(%u, %u)", (word >> 12U) & 4095U, word & 4095U);
+            break;
+        case 31U: /* BEGIN */
+            snprintf(text, size, "BEGIN(%s)", ((word & 15U) < 10U) ? primitive_names[word & 15U] : "?");
+            break;
+        case 32U: /* COLOR_MASK */
+            snprintf(text, size, "COLOR_MASK(%u, %u, %u, %u)", (word >> 3U) & 1U, (word >> 2U) & 1U, (word >> 1U) & 1U,
+                word & 1U);
+            break;
+        case 38U: /* CLEAR */
+            snprintf(text, size, "CLEAR(%u, %u, %u)", (word >> 2U) & 1U, (word >> 1U) & 1U, word & 1U);
+            break;
+        case 40U: /* BITMAP_LAYOUT_H, the original values like the macro of EVE.h takes them */
+            snprintf(text, size, "BITMAP_LAYOUT_H(0x%x, 0x%x)", ((word >> 2U) & 3U) << 10U, (word & 3U) << 9U);
+            break;
+        case 41U: /* BITMAP_SIZE_H */
+            snprintf(text, size, "BITMAP_SIZE_H(0x%x, 0x%x)", ((word >> 2U) & 3U) << 9U, (word & 3U) << 9U);
+            break;
+        case 43U: /* VERTEX_TRANSLATE_X */
+        case 44U: /* VERTEX_TRANSLATE_Y */
+            snprintf(text, size, "%s(%d)", dl_names[opcode], sign_extend(word, 17U));
+            break;
+        case 46U: /* BITMAP_EXT_FORMAT */
+            snprintf(text, size, "BITMAP_EXT_FORMAT(%u)", word & 65535U);
+            break;
+        case 47U: /* BITMAP_SWIZZLE */
+            snprintf(text, size, "BITMAP_SWIZZLE(%u, %u, %u, %u)", (word >> 9U) & 7U, (word >> 6U) & 7U,
+                (word >> 3U) & 7U, word & 7U);
+            break;
+        case 29U: /* CALL */
+        case 30U: /* JUMP */
+            snprintf(text, size, "%s(%u)", dl_names[opcode], word & 65535U);
+            break;
+        case 42U: /* PALETTE_SOURCE */
+            snprintf(text, size, "PALETTE_SOURCE(0x%06x)", word & 0x3fffffU);
+            break;
+        case 3U: /* TAG */
+        case 15U: /* CLEAR_COLOR_A */
+        case 16U: /* COLOR_A */
+        case 17U: /* CLEAR_STENCIL */
+        case 18U: /* CLEAR_TAG */
+        case 19U: /* STENCIL_MASK */
+            snprintf(text, size, "%s(%u)", dl_names[opcode], word & 255U);
+            break;
+        case 5U: /* BITMAP_HANDLE */
+            snprintf(text, size, "BITMAP_HANDLE(%u)", word & 31U);
+            break;
+        case 6U: /* CELL */
+            snprintf(text, size, "CELL(%u)", word & 127U);
+            break;
+        case 13U: /* POINT_SIZE */
+            snprintf(text, size, "POINT_SIZE(%u)", word & 8191U);
+            break;
+        case 14U: /* LINE_WIDTH */
+            snprintf(text, size, "LINE_WIDTH(%u)", word & 4095U);
+            break;
+        case 39U: /* VERTEX_FORMAT */
+            snprintf(text, size, "VERTEX_FORMAT(%u)", word & 7U);
+            break;
+        default: /* TAG_MASK, MACRO */
+            snprintf(text, size, "%s(%u)", dl_names[opcode], word & 1U);
+            break;
+    }
+}
+
+static uint32_t get_word(const uint8_t *data)
+{
+    return data[0] | ((uint32_t) data[1] << 8U) | ((uint32_t) data[2] << 16U) | ((uint32_t) data[3] << 24U);
+}
+
+static void append(char *text, size_t size, const char *fmt, ...)
+{
+    size_t used = strlen(text);
+    va_list args;
+
+    if (used < size)
+    {
+        va_start(args, fmt);
+        vsnprintf(&text[used], size - used, fmt, args);
+        va_end(args);
+    }
+}
+
+/* returns the length of the zlib stream, 0 if it does not end in the data */
+static uint32_t zlib_length(const uint8_t *data, uint32_t length)
+{
+    static uint8_t scratch[16384];
+    z_stream stream;
+    uint32_t result = 0U;
+    int status = Z_OK;
+
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit(&stream) != Z_OK)
+    {
+        return 0U;
+    }
+    stream.next_in = (Bytef *) (uintptr_t) data;
+    stream.avail_in = length;
+    while (Z_OK == status)
+    {
+        stream.next_out = scratch;
+        stream.avail_out = sizeof(scratch);
+        status = inflate(&stream, Z_NO_FLUSH);
+    }
+    if (Z_STREAM_END == status)
+    {
+        result = (uint32_t) stream.total_in;
+    }
+    inflateEnd(&stream);
+    return result;
+}
+
+/* returns the length of a PNG or a JPEG, 0 if it does not end in the data */
+static uint32_t image_length(const uint8_t *data, uint32_t length)
+{
+    uint32_t pos;
+
+    if ((length > 8U) && (0 == memcmp(data, "\x89PNG\r\n\x1a\n", 8U)))
+    {
+        pos = 8U;
+        while ((pos + 12U) <= length)
+        {
+            uint32_t chunk = ((uint32_t) data[pos] << 24U) | ((uint32_t) data[pos + 1U] << 16U) |
+                ((uint32_t) data[pos + 2U] << 8U) | data[pos + 3U];
+
+            if (0 == memcmp(&data[pos + 4U], "IEND", 4U))
+            {
+                return pos + 12U;
+            }
+            pos += chunk + 12U;
+        }
+        return 0U;
+    }
+    if ((length > 4U) && (0xffU == data[0]) && (0xd8U == data[1]))
+    {
+        pos = 2U;
+        while ((pos + 4U) <= length) /* the marker segments up to the start of scan */
+        {
+            uint8_t marker = data[pos + 1U];
+
+            if (data[pos] != 0xffU)
+            {
+                return 0U;
+            }
+            pos += 2U + (((uint32_t) data[pos + 2U] << 8U) | data[pos + 3U]);
+            if (0xdaU == marker)
+            {
+                break;
+            }
+        }
+        while ((pos + 1U) < length) /* the entropy coded data ends with a marker that is not a restart marker */
+        {
+            if ((0xffU == data[pos]) && (data[pos + 1U] != 0U) && ((data[pos + 1U] & 0xf8U) != 0xd0U))
+            {
+                if (0xd9U == data[pos + 1U])
+                {
+                    return pos + 2U;
+                }
+                pos += 2U + (((uint32_t) data[pos + 2U] << 8U) | data[pos + 3U]); /* another scan */
+            }
+            else
+            {
+                pos++;
+            }
+        }
+    }
+    return 0U;
+}
+
+static uint32_t decode_string(const uint8_t *data, uint32_t length, char *text, size_t size, uint32_t options)
+{
+    uint32_t len = 0U;
+    uint32_t used;
+    uint32_t args = 0U;
+
+    while ((len < length) && (data[len] != 0U))
+    {
+        len++;
+    }
+    if (len >= length)
+    {
+        return 0U;
+    }
+    append(text, size, ", \"");
+    for (uint32_t index = 0U; index < len; index++)
+    {
+        uint8_t character = data[index];
+
+        if ((character < 32U) || (character > 126U) || ('"' == character) || ('\\' == character))
+        {
+            append(text, size, "\\x%02x", character);
+        }
+        else
+        {
+            append(text, size, "%c", character);
+        }
+        if (('%' == character) && ((index + 1U) < len))
+        {
+            if ('%' == data[index + 1U])
+            {
+                index++;
+                append(text, size, "%%");
+            }
+            else
+            {
+                args++;
+            }
+        }
+    }
+    append(text, size, "\"");
+    used = (len + 4U) & ~3U;
+
+#if EVE_GEN > 2
+    if ((options & EVE_OPT_FORMAT) != 0U)
+    {
+        for (uint32_t index = 0U; index < args; index++)
+        {
+            if ((used + 4U) > length)
+            {
+                return 0U;
+            }
+            append(text, size, ", %d", (int32_t) get_word(&data[used]));
+            used += 4U;
+        }
+    }
+#else
+    (void) options;
+    (void) args;
+#endif
+    return used;
+}
+
+uint32_t eve_decode_cmd(const uint8_t *data, uint32_t length, char *text, size_t size, const char **name)
+{
+    const cmd_info_t *info = NULL;
+    uint32_t command;
+    uint32_t used = 4U;
+    uint32_t last = 0U;
+    uint32_t options = 0U;
+
+    text[0] = '\0';
+    if (length < 4U)
+    {
+        return 0U;
+    }
+    command = get_word(data);
+    if ((command & 0xffffff00U) != 0xffffff00U)
+    {
+        eve_decode_dl(command, text, size);
+        if (name != NULL)
+        {
+            static char dl_name[32];
+            char *paren;
+
+            snprintf(dl_name, sizeof(dl_name), "%s", text);
+            paren = strchr(dl_name, '(');
+            if (paren != NULL)
+            {
+                *paren = '\0';
+            }
+            *name = dl_name;
+        }
+        return 4U;
+    }
+    for (size_t index = 0U; index < (sizeof(cmd_info) / sizeof(cmd_info[0])); index++)
+    {
+        if (cmd_info[index].command == command)
+        {
+            info = &cmd_info[index];
+            break;
+        }
+    }
+    if (NULL == info)
+    {
+        snprintf(text, size, "0x%08x /* unknown co-processor command */", command);
+        if (name != NULL)
+        {
+            *name = "unknown";
+        }
+        return 4U;
+    }
+    if (name != NULL)
+    {
+        *name = info->name;
+    }
+
+    snprintf(text, size, "%s(", info->name);
+    for (const char *param = info->params; *param != '\0'; param++)
+    {
+        uint32_t word = 0U;
+        uint32_t data_len = 0U;
+        const char *separator = (param == info->params) ? "" : ", ";
+
+        if (strchr("ixcopqru", *param) != NULL) /* a parameter word */
+        {
+            if ((used + 4U) > length)
+            {
+                return 0U;
+            }
+            word = get_word(&data[used]);
+            used += 4U;
+        }
+        switch (*param)
+        {
+            case 'i':
+                append(text, size, "%s%d", separator, (int32_t) word);
+                break;
+            case 'x':
+                append(text, size, "%s0x%x", separator, word);
+                break;
+            case 'c':
+                append(text, size, "%s0x%06x", separator, word);
+                break;
+            case 'o':
+                options = word;
+                append(text, size, "%s0x%04x", separator, word);
+                break;
+            case 'p':
+                append(text, size, "%s%d, %d", separator, (int16_t) (word & 0xffffU), (int16_t) (word >> 16U));
+                break;
+            case 'q':
+                options = word >> 16U;
+                append(text, size, "%s%d, 0x%04x", separator, (int16_t) (word & 0xffffU), word >> 16U);
+                break;
+            case 'r':
+                options = word & 0xffffU;
+                append(text, size, "%s0x%04x, %u", separator, word & 0xffffU, word >> 16U);
+                break;
+            case 'u':
+                append(text, size, "%s%u, %u", separator, word & 0xffffU, word >> 16U);
+                break;
+            case 's':
+                data_len = decode_string(&data[used], length - used, text, size, options);
+                if (0U == data_len)
+                {
+                    return 0U;
+                }
+                used += data_len;
+                break;
+            case 'w':
+                data_len = (last + 3U) & ~3U;
+                break;
+            case 'Z':
+                data_len = zlib_length(&data[used], length - used);
+                if (0U == data_len)
+                {
+                    return 0U;
+                }
+                break;
+            case 'z':
+            case 'm':
+#if EVE_GEN > 2
+                if ((options & (EVE_OPT_MEDIAFIFO | EVE_OPT_FLASH)) != 0U)
+#else
+                if ((options & EVE_OPT_MEDIAFIFO) != 0U)
+#endif
+                {
+                    break;
+                }
+                data_len = ('z' == *param) ? zlib_length(&data[used], length - used) : image_length(&data[used], length - used);
+                if (0U == data_len)
+                {
+                    return 0U;
+                }
+                break;
+            default: /* 'v', the length of a video is not known, everything else in the stream is taken as the video */
+#if EVE_GEN > 2
+                if ((options & (EVE_OPT_MEDIAFIFO | EVE_OPT_FLASH)) == 0U)
+#else
+                if ((options & EVE_OPT_MEDIAFIFO) == 0U)
+#endif
+                {
+                    data_len = length - used;
+                }
+                break;
+        }
+        if ((data_len != 0U) && (strchr("wZzmv", *param) != NULL))
+        {
+            data_len = (data_len + 3U) & ~3U;
+            if ((used + data_len) > length)
+            {
+                return 0U;
+            }
+            used += data_len;
+            append(text, size, ") /* + %u bytes of data */", data_len);
+            return used;
+        }
+        last = word;
+    }
+    append(text, size, ")");
+    return used;
+}
@@ -0,0 +1,50 @@
+/*
+@file    eve_decode.h
+@brief   decoder for display-list words and co-processor command streams, used by the tools
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+*/
+
+#ifndef EVE_DECODE_H
+#define EVE_DECODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* The commands of the generation of the EVE_DISPLAY the tools are built for are decoded, see tools/Makefile. */
+
+/* Writes one display-list word as the macro of EVE.h that would produce it, e.g. "COLOR_RGB(255, 0, 0)". */
+void eve_decode_dl(uint32_t word, char *text, size_t size);
+
+/* Writes the command at the start of a co-processor stream like EVE_cmd_*() would have been called with it,
+ * e.g. "CMD_TEXT(10, 10, 28, 0x0000, "Hello")" or the display-list macro for words that are no co-processor commands.
+ * name is set to the name of the command without the parameters, it can be NULL.
+ * Returns the number of bytes the command uses in the stream including strings and the data that follows it,
+ * 0 if the stream ends before the command is complete. */
+uint32_t eve_decode_cmd(const uint8_t *data, uint32_t length, char *text, size_t size, const char **name);
+
+#endif /* EVE_DECODE_H */
@@ -0,0 +1,474 @@
+/*
+@file    eve_disasm.c
+@brief   lists display-lists and co-processor command streams as readable commands
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+@section Usage
+
+eve_disasm [--dl | --cmd] [--hex] [--all] [--summary] <file>
+eve_disasm --spidev <device> [--speed <hz>] --read-dl [--all]
+eve_disasm --spidev <device> [--speed <hz>] --expand [--summary] <file>
+
+The file is a binary dump of little-endian words, or text with hex words with --hex, for example RAM_DL read with
+EVE_memRead32() and printed over an UART or a copy of the DMA buffer.
+--dl lists display-list words up to the DISPLAY command, --all lists all of them.
+--cmd lists a co-processor command stream with the offset and the number of bytes of each command.
+--summary adds a table with the number of commands and the bytes for each command, sorted by the bytes.
+--read-dl reads RAM_DL from an EVE attached thru Linux spidev.
+--expand sends the co-processor stream one command at a time to an EVE attached thru spidev and lists the
+display-list words that each command generated below it, the stream should start with CMD_DLSTART.
+
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <linux/spi/spidev.h>
+
+#include "EVE.h"
+#include "eve_decode.h"
+
+#define SUMMARY_MAX 128U
+#define EXECUTE_TIMEOUT_MS 1000U
+
+typedef struct
+{
+    const char *name;
+    uint32_t count;
+    uint32_t bytes;
+    uint32_t dl_words;
+} summary_t;
+
+static summary_t summary[SUMMARY_MAX];
+static uint32_t summary_count;
+static int spi = -1;
+static uint32_t spi_speed = 8000000U;
+
+static void fail(const char *fmt, const char *arg)
+{
+    fprintf(stderr, "eve_disasm: ");
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(EXIT_FAILURE);
+}
+
+static uint8_t *read_file(const char *path, bool hex, uint32_t *length)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *data;
+    long size;
+
+    if (NULL == file)
+    {
+        fail("can not open %s", path);
+    }
+    fseek(file, 0L, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0L, SEEK_SET);
+    data = malloc((size_t) size + 4U);
+    if (NULL == data)
+    {
+        fail("%s", "out of memory");
+    }
+    if (hex)
+    {
+        char token[64];
+        uint32_t count = 0U;
+
+        /* one word per token, separated by white space or commas, tokens that end with ':' are offsets */
+        while ((1 == fscanf(file, "%63s", token)) && ((count + 4U) <= ((uint32_t) size + 4U)))
+        {
+            char *end;
+            unsigned long word = strtoul(token, &end, 16);
+
+            if ((end == token) || (':' == *end))
+            {
+                continue;
+            }
+            data[count] = (uint8_t) word;
+            data[count + 1U] = (uint8_t) (word >> 8U);
+            data[count + 2U] = (uint8_t) (word >> 16U);
+            data[count + 3U] = (uint8_t) (word >> 24U);
+            count += 4U;
+        }
+        *length = count;
+    }
+    else
+    {
+        *length = (uint32_t) fread(data, 1U, (size_t) size, file);
+    }
+    fclose(file);
+    return data;
+}
+
+static void add_summary(const char *name, uint32_t bytes, uint32_t dl_words)
+{
+    uint32_t index;
+
+    for (index = 0U; index < summary_count; index++)
+    {
+        if (0 == strcmp(summary[index].name, name))
+        {
+            break;
+        }
+    }
+    if (index == summary_count)
+    {
+        if (summary_count >= SUMMARY_MAX)
+        {
+            return;
+        }
+        summary[index].name = strdup(name);
+        summary_count++;
+    }
+    summary[index].count++;
+    summary[index].bytes += bytes;
+    summary[index].dl_words += dl_words;
+}
+
+static int compare_summary(const void *left, const void *right)
+{
+    const summary_t *a = left;
+    const summary_t *b = right;
+
+    return (a->bytes < b->bytes) ? 1 : ((a->bytes > b->bytes) ? -1 : 0);
+}
+
+static void print_summary(bool dl_words)
+{
+    uint32_t count = 0U;
+    uint32_t bytes = 0U;
+    uint32_t words = 0U;
+
+    qsort(summary, summary_count, sizeof(summary[0]), compare_summary);
+    printf("\n%-24s %8s %8s%s\n", "command", "count", "bytes", dl_words ? " dl-words" : "");
+    for (uint32_t index = 0U; index < summary_count; index++)
+    {
+        printf("%-24s %8u %8u", summary[index].name, summary[index].count, summary[index].bytes);
+        if (dl_words)
+        {
+            printf(" %8u", summary[index].dl_words);
+        }
+        printf("\n");
+        count += summary[index].count;
+        bytes += summary[index].bytes;
+        words += summary[index].dl_words;
+    }
+    printf("%-24s %8u %8u", "total", count, bytes);
+    if (dl_words)
+    {
+        printf(" %8u", words);
+    }
+    printf("\n");
+}
+
+/*---- access to EVE thru spidev --------------------------------------------------------------------------------------*/
+
+static void spi_transfer(uint8_t *tx, uint8_t *rx, uint32_t length)
+{
+    struct spi_ioc_transfer transfer;
+
+    memset(&transfer, 0, sizeof(transfer));
+    transfer.tx_buf = (uintptr_t) tx;
+    transfer.rx_buf = (uintptr_t) rx;
+    transfer.len = length;
+    transfer.speed_hz = spi_speed;
+    transfer.bits_per_word = 8U;
+    if (ioctl(spi, SPI_IOC_MESSAGE(1), &transfer) < 0)
+    {
+        fail("SPI transfer failed: %s", strerror(errno));
+    }
+}
+
+static uint32_t spi_read32(uint32_t address)
+{
+    uint8_t tx[8] = {(uint8_t) (address >> 16U), (uint8_t) (address >> 8U), (uint8_t) address, 0U, 0U, 0U, 0U, 0U};
+    uint8_t rx[8];
+
+    spi_transfer(tx, rx, 8U);
+    return rx[4] | ((uint32_t) rx[5] << 8U) | ((uint32_t) rx[6] << 16U) | ((uint32_t) rx[7] << 24U);
+}
+
+static void spi_write(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    static uint8_t tx[4096 + 3];
+
+    tx[0] = (uint8_t) ((address >> 16U) | 0x80U);
+    tx[1] = (uint8_t) (address >> 8U);
+    tx[2] = (uint8_t) address;
+    memcpy(&tx[3], data, length);
+    spi_transfer(tx, NULL, length + 3U);
+}
+
+static void spi_open(const char *device)
+{
+    uint8_t mode = SPI_MODE_0;
+
+    spi = open(device, O_RDWR);
+    if ((spi < 0) || (ioctl(spi, SPI_IOC_WR_MODE, &mode) < 0))
+    {
+        fail("can not use %s", device);
+    }
+}
+
+/* sends a command thru REG_CMDB_WRITE and waits for the co-processor to finish it */
+static void execute(const uint8_t *data, uint32_t length)
+{
+    uint32_t sent = 0U;
+
+    for (uint32_t tries = 0U; tries < EXECUTE_TIMEOUT_MS; tries++)
+    {
+        uint32_t space = spi_read32(REG_CMDB_SPACE) & 0xfffU;
+
+        if ((space & 3U) != 0U)
+        {
+            fail("%s", "co-processor fault, see RAM_ERR_REPORT");
+        }
+        if (sent < length)
+        {
+            uint32_t chunk = ((length - sent) < space) ? (length - sent) : space;
+
+            spi_write(REG_CMDB_WRITE, &data[sent], chunk);
+            sent += chunk;
+            tries = 0U;
+        }
+        else if (0xffcU == space)
+        {
+            return;
+        }
+        else
+        {
+            usleep(1000U);
+        }
+    }
+    fail("%s", "the co-processor does not finish");
+}
+
+/*---- listings -------------------------------------------------------------------------------------------------------*/
+
+static void list_dl(const uint8_t *data, uint32_t length, bool all)
+{
+    char text[256];
+
+    for (uint32_t offset = 0U; (offset + 4U) <= length; offset += 4U)
+    {
+        uint32_t word = data[offset] | ((uint32_t) data[offset + 1U] << 8U) | ((uint32_t) data[offset + 2U] << 16U) |
+            ((uint32_t) data[offset + 3U] << 24U);
+
+        eve_decode_dl(word, text, sizeof(text));
+        printf("0x%04x  0x%08x  %s\n", offset, word, text);
+        if ((0U == word) && !all)
+        {
+            break;
+        }
+    }
+}
+
+static void list_cmd(const uint8_t *data, uint32_t length, bool expand)
+{
+    static char text[65536];
+    uint32_t offset = 0U;
+    uint32_t dl_start = 0U;
+
+    if (expand)
+    {
+        dl_start = spi_read32(REG_CMD_DL);
+    }
+    while (offset < length)
+    {
+        const char *name = NULL;
+        uint32_t used = eve_decode_cmd(&data[offset], length - offset, text, sizeof(text), &name);
+        uint32_t dl_words = 0U;
+
+        if (0U == used)
+        {
+            printf("0x%04x  the stream ends inside of a command\n", offset);
+            break;
+        }
+        printf("0x%04x %5u  %s\n", offset, used, text);
+        if (expand)
+        {
+            uint32_t dl_end;
+
+            execute(&data[offset], used);
+            dl_end = spi_read32(REG_CMD_DL);
+            if (dl_end < dl_start)
+            {
+                dl_start = 0U; /* CMD_DLSTART */
+            }
+            for (uint32_t address = dl_start; address < dl_end; address += 4U)
+            {
+                char dl_text[128];
+
+                eve_decode_dl(spi_read32(EVE_RAM_DL + address), dl_text, sizeof(dl_text));
+                printf("              0x%04x: %s\n", address, dl_text);
+                dl_words++;
+            }
+            dl_start = dl_end;
+        }
+        add_summary(name, used, dl_words);
+        offset += used;
+    }
+}
+
+static void usage(void)
+{
+    printf("usage: eve_disasm [--dl | --cmd] [--hex] [--all] [--summary] <file>\n"
+           "       eve_disasm --spidev <device> [--speed <hz>] --read-dl [--all]\n"
+           "       eve_disasm --spidev <device> [--speed <hz>] --expand [--summary] <file>\n"
+           "  --dl          the file is a display-list, this is the default\n"
+           "  --cmd         the file is a co-processor command stream\n"
+           "  --hex         the file is text with hex words instead of binary\n"
+           "  --all         list the display-list after the DISPLAY command\n"
+           "  --summary     count and bytes for each command\n"
+           "  --spidev      EVE attached thru Linux spidev, e.g. /dev/spidev0.0\n"
+           "  --read-dl     list RAM_DL\n"
+           "  --expand      run the command stream and list the display-list words of each command\n");
+    exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = NULL;
+    const char *device = NULL;
+    bool cmd = false;
+    bool hex = false;
+    bool all = false;
+    bool show_summary = false;
+    bool read_dl = false;
+    bool expand = false;
+    uint8_t *data = NULL;
+    uint32_t length = 0U;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (0 == strcmp(argv[arg], "--dl"))
+        {
+            cmd = false;
+        }
+        else if (0 == strcmp(argv[arg], "--cmd"))
+        {
+            cmd = true;
+        }
+        else if (0 == strcmp(argv[arg], "--hex"))
+        {
+            hex = true;
+        }
+        else if (0 == strcmp(argv[arg], "--all"))
+        {
+            all = true;
+        }
+        else if (0 == strcmp(argv[arg], "--summary"))
+        {
+            show_summary = true;
+        }
+        else if ((0 == strcmp(argv[arg], "--spidev")) && ((arg + 1) < argc))
+        {
+            device = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--speed")) && ((arg + 1) < argc))
+        {
+            spi_speed = (uint32_t) strtoul(argv[++arg], NULL, 0);
+        }
+        else if (0 == strcmp(argv[arg], "--read-dl"))
+        {
+            read_dl = true;
+        }
+        else if (0 == strcmp(argv[arg], "--expand"))
+        {
+            expand = true;
+            cmd = true;
+        }
+        else if (argv[arg][0] == '-')
+        {
+            usage();
+        }
+        else
+        {
+            path = argv[arg];
+        }
+    }
+    if ((read_dl || expand) && (NULL == device))
+    {
+        usage();
+    }
+    if (device != NULL)
+    {
+        spi_open(device);
+    }
+
+    if (read_dl)
+    {
+        length = EVE_RAM_DL_SIZE;
+        data = malloc(length);
+        if (NULL == data)
+        {
+            fail("%s", "out of memory");
+        }
+        for (uint32_t offset = 0U; offset < length; offset += 4U)
+        {
+            uint32_t word = spi_read32(EVE_RAM_DL + offset);
+
+            memcpy(&data[offset], &word, 4U); /* the host is little-endian like EVE */
+        }
+        list_dl(data, length, all);
+    }
+    else
+    {
+        if (NULL == path)
+        {
+            usage();
+        }
+        data = read_file(path, hex, &length);
+        if (cmd)
+        {
+            list_cmd(data, length, expand);
+            if (show_summary)
+            {
+                print_summary(expand);
+            }
+        }
+        else
+        {
+            list_dl(data, length, all);
+        }
+    }
+
+    free(data);
+    if (spi >= 0)
+    {
+        close(spi);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,308 @@
+/*
+@file    eve_flashmap.c
+@brief   converts the .map file of a flash image from EVE Asset Builder into a flash asset directory for EVE_flash.c
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+@section Usage
+
+eve_flashmap [-o <name>] [--prefix <prefix>] flash.map
+
+The .map file has one line per asset: "name : offset : size".
+The output is <name>.c with the hash table and <name>.h with EVE_flash_dir_t <prefix>_dir and defines with the offset
+and size of each asset for code that does not need the lookup by name.
+
+*/
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "EVE_flash.h"
+
+#define ENTRY_MAX 4096U
+
+typedef struct
+{
+    char name[128];
+    uint32_t offset;
+    uint32_t size;
+    uint8_t type;
+} entry_t;
+
+static entry_t entries[ENTRY_MAX];
+static uint32_t entry_count;
+
+static void fail(const char *fmt, const char *arg)
+{
+    fprintf(stderr, "eve_flashmap: ");
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(EXIT_FAILURE);
+}
+
+static char *trim(char *str)
+{
+    char *end;
+
+    while (isspace((unsigned char) *str))
+    {
+        str++;
+    }
+    end = &str[strlen(str)];
+    while ((end > str) && isspace((unsigned char) end[-1]))
+    {
+        end--;
+    }
+    *end = '\0';
+    return str;
+}
+
+static bool has_suffix(const char *str, const char *suffix)
+{
+    size_t len = strlen(str);
+    size_t slen = strlen(suffix);
+
+    return (len >= slen) && (0 == strcasecmp(&str[len - slen], suffix));
+}
+
+/* ASTC bitmaps and the glyphs of fonts are used from the flash, everything else needs to be copied to RAM_G */
+static uint8_t asset_type(const char *name)
+{
+    char upper[128];
+    size_t index;
+
+    for (index = 0U; (name[index] != '\0') && (index < (sizeof(upper) - 1U)); index++)
+    {
+        upper[index] = (char) toupper((unsigned char) name[index]);
+    }
+    upper[index] = '\0';
+
+    if (has_suffix(name, ".xfont"))
+    {
+        return EVE_FLASH_ASSET_LOAD; /* the font metric block needs to be in RAM_G, even for ASTC fonts */
+    }
+    if ((strstr(upper, "ASTC") != NULL) || has_suffix(name, ".glyph"))
+    {
+        return EVE_FLASH_ASSET_DIRECT;
+    }
+    return EVE_FLASH_ASSET_LOAD;
+}
+
+static void read_map(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[512];
+
+    if (NULL == file)
+    {
+        fail("can not open %s", path);
+    }
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        char *name = line;
+        char *offset = strchr(line, ':');
+        char *size = (offset != NULL) ? strchr(&offset[1], ':') : NULL;
+        entry_t *entry = &entries[entry_count];
+
+        if (NULL == size)
+        {
+            continue; /* not an asset line */
+        }
+        *offset++ = '\0';
+        *size++ = '\0';
+        name = trim(name);
+        if ((0 == strlen(name)) || has_suffix(name, ".blob"))
+        {
+            continue; /* the blob is not an asset */
+        }
+        if (entry_count >= ENTRY_MAX)
+        {
+            fail("%s", "too many assets");
+        }
+        snprintf(entry->name, sizeof(entry->name), "%s", name);
+        entry->offset = (uint32_t) strtoul(trim(offset), NULL, 0);
+        entry->size = (uint32_t) strtoul(trim(size), NULL, 0);
+        entry->type = asset_type(entry->name);
+        if ((entry->offset & 63UL) != 0UL)
+        {
+            fprintf(stderr, "eve_flashmap: warning, %s is not 64 byte aligned and can not be read with CMD_FLASHREAD\n",
+                entry->name);
+        }
+        entry_count++;
+    }
+    fclose(file);
+}
+
+static void define_name(char *dst, size_t size, const char *prefix, const char *name)
+{
+    size_t index = 0U;
+
+    for (const char *src = prefix; (*src != '\0') && ((index + 1U) < size); src++)
+    {
+        dst[index++] = (char) toupper((unsigned char) *src);
+    }
+    if ((index + 1U) < size)
+    {
+        dst[index++] = '_';
+    }
+    for (const char *src = name; (*src != '\0') && ((index + 1U) < size); src++)
+    {
+        dst[index++] = isalnum((unsigned char) *src) ? (char) toupper((unsigned char) *src) : '_';
+    }
+    dst[index] = '\0';
+}
+
+static void usage(void)
+{
+    printf("usage: eve_flashmap [-o <name>] [--prefix <prefix>] flash.map\n"
+           "  -o <name>          output base name, default: flash_assets\n"
+           "  --prefix <prefix>  prefix for the variables and defines, default: flash\n");
+    exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *out = "flash_assets";
+    const char *prefix = "flash";
+    const char *map = NULL;
+    const entry_t **table;
+    uint32_t table_size = 1U;
+    char path[1024];
+    FILE *source;
+    FILE *header;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "-o")) && ((arg + 1) < argc))
+        {
+            out = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--prefix")) && ((arg + 1) < argc))
+        {
+            prefix = argv[++arg];
+        }
+        else if (argv[arg][0] == '-')
+        {
+            usage();
+        }
+        else
+        {
+            map = argv[arg];
+        }
+    }
+    if (NULL == map)
+    {
+        usage();
+    }
+
+    read_map(map);
+
+    /* at most half full so the probe sequences stay short */
+    while (table_size < (entry_count * 2U))
+    {
+        table_size *= 2U;
+    }
+    table = calloc(table_size, sizeof(table[0]));
+    if (NULL == table)
+    {
+        fail("%s", "out of memory");
+    }
+    for (uint32_t index = 0U; index < entry_count; index++)
+    {
+        uint32_t slot = EVE_flash_hash(entries[index].name) & (table_size - 1U);
+
+        while (table[slot] != NULL)
+        {
+            if (0 == strcmp(table[slot]->name, entries[index].name))
+            {
+                fail("%s is listed twice", entries[index].name);
+            }
+            slot = (slot + 1U) & (table_size - 1U);
+        }
+        table[slot] = &entries[index];
+    }
+
+    snprintf(path, sizeof(path), "%s.h", out);
+    header = fopen(path, "w");
+    snprintf(path, sizeof(path), "%s.c", out);
+    source = fopen(path, "w");
+    if ((NULL == header) || (NULL == source))
+    {
+        fail("can not write %s", path);
+    }
+
+    {
+        const char *base = strrchr(out, '/');
+        char guard[256];
+
+        base = (base != NULL) ? &base[1] : out;
+        define_name(guard, sizeof(guard), base, "H");
+
+        fprintf(header, "/* generated by eve_flashmap from %s, do not edit */\n\n", map);
+        fprintf(header, "#ifndef %s\n#define %s\n\n#include \"EVE_flash.h\"\n\n", guard, guard);
+        fprintf(header, "extern EVE_flash_dir_t %s_dir; /* call EVE_flash_dir_reset() before using it */\n\n", prefix);
+        for (uint32_t index = 0U; index < entry_count; index++)
+        {
+            char name[300];
+
+            define_name(name, sizeof(name), prefix, entries[index].name);
+            fprintf(header, "#define %s_OFFSET %uUL\n", name, entries[index].offset);
+            fprintf(header, "#define %s_SIZE %uUL\n", name, entries[index].size);
+        }
+        fprintf(header, "\n#endif /* %s */\n", guard);
+
+        fprintf(source, "/* generated by eve_flashmap from %s, do not edit */\n\n#include \"%s.h\"\n\n", map, base);
+    }
+
+    fprintf(source, "static const EVE_flash_asset_t %s_table[%u] =\n{\n", prefix, table_size);
+    for (uint32_t slot = 0U; slot < table_size; slot++)
+    {
+        const entry_t *entry = table[slot];
+
+        if (NULL == entry)
+        {
+            fprintf(source, "    {NULL, 0UL, 0UL, 0UL, 0U},\n");
+        }
+        else
+        {
+            fprintf(source, "    {\"%s\", 0x%08xUL, %uUL, %uUL, %s},\n", entry->name, EVE_flash_hash(entry->name),
+                entry->offset, entry->size, (EVE_FLASH_ASSET_DIRECT == entry->type) ? "EVE_FLASH_ASSET_DIRECT" : "EVE_FLASH_ASSET_LOAD");
+        }
+    }
+    fprintf(source, "};\n\n");
+    fprintf(source, "static uint32_t %s_loaded[%u];\n\n", prefix, table_size);
+    fprintf(source, "EVE_flash_dir_t %s_dir = {%s_table, %uUL, %s_loaded, 0UL, 0UL};\n", prefix, prefix, table_size, prefix);
+
+    fclose(header);
+    fclose(source);
+    free(table);
+    return EXIT_SUCCESS;
+}
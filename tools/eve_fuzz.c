@@ -0,0 +1,795 @@
+/*
+@file    eve_fuzz.c
+@brief   fuzzing harness for the command encoders of EVE_commands.c and the decoder in eve_decode.c, for libFuzzer and AFL
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+@section Usage
+
+eve_fuzz [--iterations <n>] [--seed <n>] [file ...]
+
+Every input is turned into a sequence of EVE_cmd_*() calls, either with single transactions or in a burst.
+The library is linked with a stand-in for EVE that collects what is written to REG_CMDB_WRITE, this is checked against:
+- every transaction to REG_CMDB_WRITE is a multiple of 4 bytes
+- the bytes are the same as those of a reference encoder in this file, strings are translated with the font map,
+  cut after 249 bytes, terminated and padded with zeros, the arguments for EVE_OPT_FORMAT follow the string
+- eve_decode_cmd() splits the stream into the same commands with the same lengths
+The input is also decoded as a raw co-processor stream to check that eve_decode_cmd() and eve_decode_dl() stay in bounds.
+A failed check prints the command and the stream and calls abort() so the fuzzer keeps the input.
+
+Without files eve_fuzz runs --iterations random inputs, the default is 10000.
+With files every file is one input and "-" is stdin, this is how AFL runs it: afl-fuzz -i in -o out -- ./eve_fuzz @@
+"make eve_fuzz_libfuzzer" builds it with clang and -fsanitize=fuzzer, then LLVMFuzzerTestOneInput() is the entry.
+
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+
+#include "EVE.h"
+#include "eve_decode.h"
+
+#define ITERATIONS_DEFAULT 10000U
+#define INPUT_MAX 8192U
+#define OPS_MAX 64U
+#define STREAM_MAX 262144U
+#define BLOCK_MAX 12000U   /* more than three blocks of 3840 bytes for block_transfer() */
+#define STRING_MAX 320U
+#define STRING_LIMIT 249U  /* private_string_write() stops after this many bytes of the string */
+#define ARGS_MAX 255U
+#define SPI_WRITE 0x800000U /* the bit of the address that makes a transaction a write */
+
+/*---- the stand-in for EVE -------------------------------------------------------------------------------------------*/
+
+static uint8_t stream[STREAM_MAX];   /* everything written to REG_CMDB_WRITE */
+static uint32_t stream_length;
+static bool spi_selected;
+static uint32_t spi_count;           /* bytes of the current transaction */
+static uint32_t spi_address;
+static const char *current_op = "";
+
+static void fail(const char *fmt, uint32_t value)
+{
+    fprintf(stderr, "eve_fuzz: %s: ", current_op);
+    fprintf(stderr, fmt, value);
+    fprintf(stderr, "\n");
+    abort();
+}
+
+void EVE_host_cs_set(void)
+{
+    if (spi_selected)
+    {
+        fail("chip-select is set twice", 0U);
+    }
+    spi_selected = true;
+    spi_count = 0U;
+    spi_address = 0U;
+}
+
+void EVE_host_cs_clear(void)
+{
+    if ((SPI_WRITE | REG_CMDB_WRITE) == spi_address)
+    {
+        if (((spi_count - 3U) & 3U) != 0U)
+        {
+            fail("a transaction to REG_CMDB_WRITE has %u bytes, that is not a multiple of 4", spi_count - 3U);
+        }
+    }
+    spi_selected = false;
+}
+
+void EVE_host_pdn_set(void)
+{
+}
+
+void EVE_host_pdn_clear(void)
+{
+}
+
+void EVE_host_delay_ms(uint16_t val)
+{
+    (void) val;
+}
+
+/* reads return 0 except for REG_CMDB_SPACE which always reports an empty FIFO so nothing waits */
+uint8_t EVE_host_spi_transfer(uint8_t data)
+{
+    uint8_t result = 0U;
+
+    if (!spi_selected)
+    {
+        fail("SPI transfer of 0x%02x without chip-select", data);
+    }
+    if (spi_count < 3U)
+    {
+        spi_address = (spi_address << 8U) | data;
+    }
+    else if ((SPI_WRITE | REG_CMDB_WRITE) == spi_address)
+    {
+        if (stream_length < STREAM_MAX)
+        {
+            stream[stream_length] = data;
+        }
+        stream_length++;
+    }
+    else if ((spi_count > 3U) && (0U == (spi_address & SPI_WRITE)))
+    {
+        uint32_t offset = spi_count - 4U;
+
+        if ((REG_CMDB_SPACE == spi_address) && (offset < 2U))
+        {
+            result = (uint8_t) (0xffcU >> (offset * 8U));
+        }
+    }
+    spi_count++;
+    return result;
+}
+
+/*---- the input ------------------------------------------------------------------------------------------------------*/
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+} input_t;
+
+static uint8_t take8(input_t *input)
+{
+    return (input->pos < input->size) ? input->data[input->pos++] : 0U;
+}
+
+static uint16_t take16(input_t *input)
+{
+    uint16_t value = take8(input);
+
+    return (uint16_t) (value | ((uint16_t) take8(input) << 8U));
+}
+
+static uint32_t take32(input_t *input)
+{
+    uint32_t value = take16(input);
+
+    return value | ((uint32_t) take16(input) << 16U);
+}
+
+/* pieces for strings built from the input, these hit the UTF-8 translation, the format specifiers and the cut at 249 */
+static const char *const pieces[] =
+{
+    "a", "Z", " ", "%d", "%%", "%", "\xc3\xa4", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xc3", "\xe2\x82",
+    "\x80", "\xbf", "\xf8", "\xff", "\xce\xa9", "\xc2\xa9", "\xef\xbf\xbd"
+};
+
+/* either the raw bytes of the input, which can contain a zero, or up to STRING_MAX bytes made of the pieces above */
+static void take_string(input_t *input, char *text)
+{
+    uint8_t kind = take8(input);
+    uint32_t length = take8(input);
+    uint32_t used = 0U;
+
+    if ((kind & 0x80U) != 0U)
+    {
+        length += take8(input); /* up to 510 so the cut at 249 is reached often */
+    }
+    if ((kind & 1U) != 0U)
+    {
+        while ((used < length) && (used < (STRING_MAX - 1U)) && (input->pos < input->size))
+        {
+            text[used++] = (char) take8(input);
+        }
+    }
+    else
+    {
+        while ((used < length) && (input->pos < input->size))
+        {
+            const char *piece = pieces[take8(input) % (sizeof(pieces) / sizeof(pieces[0]))];
+            size_t piece_len = strlen(piece);
+
+            if ((used + piece_len) >= STRING_MAX)
+            {
+                break;
+            }
+            memcpy(&text[used], piece, piece_len);
+            used += (uint32_t) piece_len;
+        }
+    }
+    text[used] = '\0';
+}
+
+/*---- the reference encoder ------------------------------------------------------------------------------------------*/
+
+static const uint32_t map_codepoints[] = {0xa9U, 0xe4U, 0xf6U, 0xfcU, 0x3a9U, 0x20acU, 0x1f600U};
+static const uint8_t map_glyphs[] = {0x80U, 0x81U, 0x82U, 0x83U, 0x84U, 0x85U, 0x86U};
+static const EVE_font_map_t font_map = {map_codepoints, map_glyphs, 7U, 20U, (uint8_t) '?'};
+static const int16_t fonts[] = {20, 28, 31, 20};
+static bool maps_enabled;
+
+static uint8_t expect[STREAM_MAX];
+static uint32_t expect_length;
+
+static void expect8(uint8_t data)
+{
+    if (expect_length < STREAM_MAX)
+    {
+        expect[expect_length] = data;
+    }
+    expect_length++;
+}
+
+static void expect32(uint32_t data)
+{
+    for (uint32_t shift = 0U; shift < 32U; shift += 8U)
+    {
+        expect8((uint8_t) (data >> shift));
+    }
+}
+
+static uint8_t map_lookup(uint32_t codepoint)
+{
+    for (uint32_t index = 0U; index < font_map.count; index++)
+    {
+        if (map_codepoints[index] == codepoint)
+        {
+            return map_glyphs[index];
+        }
+    }
+    return font_map.fallback;
+}
+
+/* the bytes EVE gets for a string, returns the number of arguments EVE reads for EVE_OPT_FORMAT */
+static uint32_t expect_string(const char *text, bool mapped)
+{
+    const uint8_t *bytes = (const uint8_t *) text;
+    uint8_t out[STRING_MAX];
+    uint32_t out_len = 0U;
+    uint32_t pos = 0U;
+    uint32_t args = 0U;
+
+    while ((pos < STRING_LIMIT) && (bytes[pos] != 0U))
+    {
+        uint8_t lead = bytes[pos++];
+        uint32_t follow = 0U;
+        uint32_t codepoint;
+        bool broken = false;
+
+        if ((!mapped) || (lead < 0x80U))
+        {
+            out[out_len++] = lead;
+            continue;
+        }
+        if ((lead >= 0xc0U) && (lead < 0xe0U))
+        {
+            follow = 1U;
+        }
+        else if ((lead >= 0xe0U) && (lead < 0xf0U))
+        {
+            follow = 2U;
+        }
+        else if ((lead >= 0xf0U) && (lead < 0xf8U))
+        {
+            follow = 3U;
+        }
+        else
+        {
+            out[out_len++] = font_map.fallback;
+            continue;
+        }
+        codepoint = lead & (0x7fU >> (follow + 1U));
+        for (uint32_t count = 0U; count < follow; count++)
+        {
+            if ((bytes[pos] & 0xc0U) != 0x80U)
+            {
+                broken = true;
+                break;
+            }
+            codepoint = (codepoint << 6U) | (bytes[pos++] & 0x3fU);
+        }
+        out[out_len++] = broken ? font_map.fallback : map_lookup(codepoint);
+    }
+
+    for (uint32_t index = 0U; index < out_len; index++)
+    {
+        expect8(out[index]);
+        if (('%' == out[index]) && ((index + 1U) < out_len))
+        {
+            if ('%' == out[index + 1U])
+            {
+                expect8(out[++index]);
+            }
+            else
+            {
+                args++;
+            }
+        }
+    }
+    do
+    {
+        expect8(0U);
+        out_len++;
+    }
+    while ((out_len & 3U) != 0U);
+    return args;
+}
+
+/*---- the commands ---------------------------------------------------------------------------------------------------*/
+
+typedef struct
+{
+    const char *name;    /* what eve_decode_cmd() reports, NULL for display-list words */
+    const char *function;
+    uint32_t start;      /* offset in the stream */
+    uint32_t length;
+} op_t;
+
+enum
+{
+    OP_TEXT,
+    OP_BUTTON,
+    OP_TOGGLE,
+    OP_KEYS,
+    OP_NUMBER,
+    OP_DL,
+    OP_TEXT_VAR,
+    OP_BUTTON_VAR,
+    OP_TOGGLE_VAR,
+    OP_INFLATE,
+    OP_INFLATE2,
+    OP_COUNT
+};
+
+static op_t ops[OPS_MAX];
+static uint32_t op_count;
+static char text[STRING_MAX];
+static uint32_t arguments[ARGS_MAX];
+static uint8_t block[BLOCK_MAX];
+static uint8_t packed[BLOCK_MAX + 1024U];
+
+/* the string, the arguments for EVE_OPT_FORMAT and the number of them that EVE reads */
+static uint8_t string_command(input_t *input, int16_t font, uint16_t options)
+{
+    uint32_t args;
+
+    take_string(input, text);
+    args = expect_string(text, maps_enabled && (font == (int16_t) font_map.font));
+#if EVE_GEN > 2
+    if ((options & EVE_OPT_FORMAT) != 0U)
+    {
+        args = (args > ARGS_MAX) ? ARGS_MAX : args;
+        for (uint32_t index = 0U; index < args; index++)
+        {
+            arguments[index] = take32(input);
+            expect32(arguments[index]);
+        }
+        return (uint8_t) args;
+    }
+#else
+    (void) options;
+#endif
+    return 0U;
+}
+
+/* compressed data for CMD_INFLATE and CMD_INFLATE2, up to BLOCK_MAX bytes that do not compress well */
+static uint32_t take_block(input_t *input)
+{
+    uint32_t length = take16(input) % BLOCK_MAX;
+    uint32_t seed = take32(input) | 1U;
+    uLongf packed_len = sizeof(packed);
+
+    for (uint32_t index = 0U; index < length; index++)
+    {
+        seed ^= seed << 13U;
+        seed ^= seed >> 17U;
+        seed ^= seed << 5U;
+        block[index] = (uint8_t) seed;
+    }
+    if (compress2(packed, &packed_len, block, length, (int) (seed % 10U)) != Z_OK)
+    {
+        fail("compress2() failed for %u bytes", length);
+    }
+    for (uint32_t index = 0U; index < packed_len; index++)
+    {
+        expect8(packed[index]);
+    }
+    while ((expect_length & 3U) != 0U)
+    {
+        expect8(0U);
+    }
+    return (uint32_t) packed_len;
+}
+
+/* calls one encoder and adds what it should send to the reference stream */
+static void run_op(input_t *input, bool burst)
+{
+    uint8_t selector = take8(input);
+    bool burst_call = burst && ((selector & 0x80U) != 0U);
+    int16_t x0 = (int16_t) take16(input);
+    int16_t y0 = (int16_t) take16(input);
+    int16_t w0 = (int16_t) take16(input);
+    int16_t h0 = (int16_t) take16(input);
+    int16_t font = fonts[take8(input) & 3U];
+    uint16_t options = take16(input);
+    uint16_t state = take16(input);
+    op_t *op = &ops[op_count];
+    uint8_t op_type = (uint8_t) ((selector & 0x7fU) % OP_COUNT);
+    uint8_t num_args;
+
+#if EVE_GEN > 2
+    if ((op_type < OP_TEXT_VAR) || (op_type > OP_TOGGLE_VAR) || (0U == (take8(input) & 3U)))
+    {
+        options &= (uint16_t) ~EVE_OPT_FORMAT; /* only the _var functions send the arguments */
+    }
+#else
+    if (op_type >= OP_TEXT_VAR)
+    {
+        op_type = OP_TEXT;
+    }
+#endif
+    if (burst && (op_type >= OP_INFLATE))
+    {
+        op_type = OP_NUMBER; /* the commands with data do not support cmd-burst */
+    }
+
+    op->start = expect_length;
+    switch (op_type)
+    {
+        case OP_TEXT:
+        case OP_TEXT_VAR:
+            op->name = "CMD_TEXT";
+            expect32(CMD_TEXT);
+            expect32((uint16_t) x0 | ((uint32_t) (uint16_t) y0 << 16U));
+            expect32((uint16_t) font | ((uint32_t) options << 16U));
+            num_args = string_command(input, font, options);
+#if EVE_GEN > 2
+            if (OP_TEXT_VAR == op_type)
+            {
+                current_op = burst_call ? "EVE_cmd_text_var_burst" : "EVE_cmd_text_var";
+                (burst_call ? EVE_cmd_text_var_burst : EVE_cmd_text_var)(x0, y0, font, options, text, num_args, arguments);
+                break;
+            }
+#endif
+            current_op = burst_call ? "EVE_cmd_text_burst" : "EVE_cmd_text";
+            (burst_call ? EVE_cmd_text_burst : EVE_cmd_text)(x0, y0, font, options, text);
+            break;
+        case OP_BUTTON:
+        case OP_BUTTON_VAR:
+            op->name = "CMD_BUTTON";
+            expect32(CMD_BUTTON);
+            expect32((uint16_t) x0 | ((uint32_t) (uint16_t) y0 << 16U));
+            expect32((uint16_t) w0 | ((uint32_t) (uint16_t) h0 << 16U));
+            expect32((uint16_t) font | ((uint32_t) options << 16U));
+            num_args = string_command(input, font, options);
+#if EVE_GEN > 2
+            if (OP_BUTTON_VAR == op_type)
+            {
+                current_op = burst_call ? "EVE_cmd_button_var_burst" : "EVE_cmd_button_var";
+                (burst_call ? EVE_cmd_button_var_burst : EVE_cmd_button_var)(x0, y0, w0, h0, font, options, text,
+                    num_args, arguments);
+                break;
+            }
+#endif
+            current_op = burst_call ? "EVE_cmd_button_burst" : "EVE_cmd_button";
+            (burst_call ? EVE_cmd_button_burst : EVE_cmd_button)(x0, y0, w0, h0, font, options, text);
+            break;
+        case OP_TOGGLE:
+        case OP_TOGGLE_VAR:
+            op->name = "CMD_TOGGLE";
+            expect32(CMD_TOGGLE);
+            expect32((uint16_t) x0 | ((uint32_t) (uint16_t) y0 << 16U));
+            expect32((uint16_t) w0 | ((uint32_t) (uint16_t) font << 16U));
+            expect32(options | ((uint32_t) state << 16U));
+            num_args = string_command(input, font, options);
+#if EVE_GEN > 2
+            if (OP_TOGGLE_VAR == op_type)
+            {
+                current_op = burst_call ? "EVE_cmd_toggle_var_burst" : "EVE_cmd_toggle_var";
+                (burst_call ? EVE_cmd_toggle_var_burst : EVE_cmd_toggle_var)(x0, y0, w0, font, options, state, text,
+                    num_args, arguments);
+                break;
+            }
+#endif
+            current_op = burst_call ? "EVE_cmd_toggle_burst" : "EVE_cmd_toggle";
+            (burst_call ? EVE_cmd_toggle_burst : EVE_cmd_toggle)(x0, y0, w0, font, options, state, text);
+            break;
+        case OP_KEYS:
+            op->name = "CMD_KEYS";
+            expect32(CMD_KEYS);
+            expect32((uint16_t) x0 | ((uint32_t) (uint16_t) y0 << 16U));
+            expect32((uint16_t) w0 | ((uint32_t) (uint16_t) h0 << 16U));
+            expect32((uint16_t) font | ((uint32_t) options << 16U));
+            (void) string_command(input, font, options);
+            current_op = burst_call ? "EVE_cmd_keys_burst" : "EVE_cmd_keys";
+            (burst_call ? EVE_cmd_keys_burst : EVE_cmd_keys)(x0, y0, w0, h0, font, options, text);
+            break;
+        case OP_NUMBER:
+        {
+            int32_t number = (int32_t) take32(input);
+
+            op->name = "CMD_NUMBER";
+            expect32(CMD_NUMBER);
+            expect32((uint16_t) x0 | ((uint32_t) (uint16_t) y0 << 16U));
+            expect32((uint16_t) font | ((uint32_t) options << 16U));
+            expect32((uint32_t) number);
+            current_op = burst_call ? "EVE_cmd_number_burst" : "EVE_cmd_number";
+            (burst_call ? EVE_cmd_number_burst : EVE_cmd_number)(x0, y0, font, options, number);
+            break;
+        }
+        case OP_DL:
+        {
+            uint32_t word = take32(input);
+
+            if ((word & 0xffffff00U) == 0xffffff00U)
+            {
+                word &= 0x7fffffffU; /* a display-list word, not a co-processor command */
+            }
+            op->name = NULL;
+            expect32(word);
+            current_op = burst_call ? "EVE_cmd_dl_burst" : "EVE_cmd_dl";
+            (burst_call ? EVE_cmd_dl_burst : EVE_cmd_dl)(word);
+            break;
+        }
+        case OP_INFLATE:
+        {
+            uint32_t ptr = take32(input);
+            uint32_t length;
+
+            op->name = "CMD_INFLATE";
+            expect32(CMD_INFLATE);
+            expect32(ptr);
+            length = take_block(input);
+            current_op = "EVE_cmd_inflate";
+            EVE_cmd_inflate(ptr, packed, length);
+            break;
+        }
+        default:
+        {
+#if EVE_GEN > 2
+            uint32_t ptr = take32(input);
+            uint32_t length;
+
+            op->name = "CMD_INFLATE2";
+            expect32(CMD_INFLATE2);
+            expect32(ptr);
+            expect32(0U); /* the data follows only without EVE_OPT_MEDIAFIFO and EVE_OPT_FLASH */
+            length = take_block(input);
+            current_op = "EVE_cmd_inflate2";
+            EVE_cmd_inflate2(ptr, 0U, packed, length);
+#endif
+            break;
+        }
+    }
+    op->function = current_op;
+    op->length = expect_length - op->start;
+    op_count++;
+}
+
+static void dump(const uint8_t *data, uint32_t start, uint32_t end)
+{
+    for (uint32_t pos = start; (pos < end) && (pos < STREAM_MAX); pos++)
+    {
+        fprintf(stderr, "%02x%s", data[pos], (((pos - start) & 15U) == 15U) ? "\n" : " ");
+    }
+    fprintf(stderr, "\n");
+}
+
+/* the stream of the encoders against the reference and the commands eve_decode_cmd() finds in it */
+static void check_stream(void)
+{
+    char decoded[1024];
+
+    for (uint32_t index = 0U; index < op_count; index++)
+    {
+        const op_t *op = &ops[index];
+        const char *name = NULL;
+        uint32_t used;
+
+        current_op = op->function;
+        if ((op->start + op->length) > stream_length)
+        {
+            fail("the stream ends at %u before the command is complete", stream_length);
+        }
+        if (memcmp(&stream[op->start], &expect[op->start], op->length) != 0)
+        {
+            fprintf(stderr, "eve_fuzz: encoded:\n");
+            dump(stream, op->start, op->start + op->length);
+            fprintf(stderr, "eve_fuzz: expected:\n");
+            dump(expect, op->start, op->start + op->length);
+            fail("the command at offset %u is not encoded as expected", op->start);
+        }
+        used = eve_decode_cmd(&stream[op->start], stream_length - op->start, decoded, sizeof(decoded), &name);
+        if (used != op->length)
+        {
+            fprintf(stderr, "eve_fuzz: %s\n", decoded);
+            fail("eve_decode_cmd() takes %u bytes for the command", used);
+        }
+        if ((op->name != NULL) && ((NULL == name) || (strcmp(name, op->name) != 0)))
+        {
+            fprintf(stderr, "eve_fuzz: %s\n", decoded);
+            fail("eve_decode_cmd() finds a different command at offset %u", op->start);
+        }
+    }
+    current_op = "stream";
+    if (stream_length != expect_length)
+    {
+        fail("the encoders sent %u bytes", stream_length);
+    }
+}
+
+/* the input as a co-processor stream, the decoder must neither crash nor run past the end or the text buffer */
+static void check_decoder(const uint8_t *data, size_t size)
+{
+    static char decoded[1024];
+    uint32_t text_size = (size > 0U) ? (1U + (data[0] % sizeof(decoded))) : sizeof(decoded);
+    uint32_t pos = 0U;
+
+    current_op = "eve_decode_cmd";
+    while ((pos + 4U) <= size)
+    {
+        uint32_t used = eve_decode_cmd(&data[pos], (uint32_t) (size - pos), decoded, text_size, NULL);
+
+        if (NULL == memchr(decoded, 0, text_size))
+        {
+            fail("the text is not terminated at offset %u", pos);
+        }
+        if (((used & 3U) != 0U) || (used > (size - pos)))
+        {
+            fail("eve_decode_cmd() returned %u", used);
+        }
+        eve_decode_dl((uint32_t) data[pos] | ((uint32_t) data[pos + 1U] << 8U) | ((uint32_t) data[pos + 2U] << 16U) |
+            ((uint32_t) data[pos + 3U] << 24U), decoded, text_size);
+        pos += (0U == used) ? 4U : used;
+    }
+}
+
+static void fuzz_one(const uint8_t *data, size_t size)
+{
+    input_t input = {data, size, 1U};
+    bool burst = (size > 0U) && ((data[0] & 2U) != 0U);
+
+    stream_length = 0U;
+    expect_length = 0U;
+    op_count = 0U;
+    maps_enabled = (size > 0U) && ((data[0] & 1U) != 0U);
+    EVE_set_font_maps(maps_enabled ? &font_map : NULL, 1U);
+
+    if (burst)
+    {
+        EVE_start_cmd_burst();
+    }
+    while ((input.pos < input.size) && (op_count < OPS_MAX) && (expect_length < (STREAM_MAX - 32768U)))
+    {
+        run_op(&input, burst);
+    }
+    if (burst)
+    {
+        current_op = "EVE_end_cmd_burst";
+        EVE_end_cmd_burst();
+    }
+    if (spi_selected)
+    {
+        fail("chip-select is still set", 0U);
+    }
+    check_stream();
+    check_decoder(data, size);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size); /* prototype to comply with MISRA */
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    fuzz_one(data, size);
+    return 0;
+}
+
+#if !defined (EVE_FUZZ_LIBFUZZER)
+
+static uint8_t input_buffer[INPUT_MAX];
+
+static void run_file(const char *path)
+{
+    FILE *file = (0 == strcmp(path, "-")) ? stdin : fopen(path, "rb");
+    size_t size;
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "eve_fuzz: can not open %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    size = fread(input_buffer, 1U, sizeof(input_buffer), file);
+    if (file != stdin)
+    {
+        fclose(file);
+    }
+    fuzz_one(input_buffer, size);
+}
+
+static void usage(void)
+{
+    printf("usage: eve_fuzz [--iterations <n>] [--seed <n>] [file ...]\n"
+           "  --iterations <n>  number of random inputs without files, default: %u\n"
+           "  --seed <n>        seed for the random inputs, default: 1\n"
+           "  file              runs the file as one input, \"-\" is stdin\n", ITERATIONS_DEFAULT);
+    exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t iterations = ITERATIONS_DEFAULT;
+    uint32_t seed = 1U;
+    uint32_t files = 0U;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "--iterations")) && ((arg + 1) < argc))
+        {
+            iterations = (uint32_t) strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[arg], "--seed")) && ((arg + 1) < argc))
+        {
+            seed = (uint32_t) strtoul(argv[++arg], NULL, 0) | 1U;
+        }
+        else if ((argv[arg][0] == '-') && (argv[arg][1] != '\0'))
+        {
+            usage();
+        }
+        else
+        {
+            run_file(argv[arg]);
+            files++;
+        }
+    }
+    if (files > 0U)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    for (uint32_t iteration = 0U; iteration < iterations; iteration++)
+    {
+        size_t size;
+
+        seed ^= seed << 13U;
+        seed ^= seed >> 17U;
+        seed ^= seed << 5U;
+        size = seed % INPUT_MAX;
+        for (size_t index = 0U; index < size; index++)
+        {
+            seed ^= seed << 13U;
+            seed ^= seed >> 17U;
+            seed ^= seed << 5U;
+            input_buffer[index] = (uint8_t) (seed >> 7U);
+        }
+        fuzz_one(input_buffer, size);
+    }
+    printf("eve_fuzz: %u inputs, no findings\n", iterations);
+    return EXIT_SUCCESS;
+}
+
+#endif /* EVE_FUZZ_LIBFUZZER */
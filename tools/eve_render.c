@@ -0,0 +1,1638 @@
+/*
+@file    eve_render.c
+@brief   software renderer for display-lists, renders RAM_DL to a PNG for golden-image tests of screens
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+@section Usage
+
+eve_render [--hex] [--size <w>x<h>] [--memory <file>] [-o <out.png>] [--tag <tag.png>] [--golden <golden.png>]
+           [--diff <diff.png>] [--tolerance <n>] [--max-pixels <n>] <dl>
+eve_render [--hex] [--size <w>x<h>] [--memory <file>] --out-dir <dir> [--golden-dir <dir>] [...] <dl> <dl> ...
+
+The display-list is a binary dump of RAM_DL with little-endian words, or text with hex words with --hex,
+the same as for eve_disasm. The image is EVE_HSIZE x EVE_VSIZE of the EVE_DISPLAY the tool was built for.
+--memory is a dump of the memory of EVE starting at address 0 with the bitmaps in RAM_G, when it is 3 MiB long it
+also has the ROM with the fonts 16 to 31 and these are rendered as well.
+--tag writes the tag buffer as a greyscale image.
+--golden compares the result with an earlier image, a pixel counts as different when one channel differs by more
+than --tolerance, more than --max-pixels different pixels make the tool exit with 1, --diff marks them in red.
+With --out-dir all display-lists on the command line are rendered in one run to <dir>/<name>.png and
+compared to <golden-dir>/<name>.png, this is the mode for the tests of a whole set of screens.
+
+This is a reference renderer, not an emulation of the hardware: the anti-aliasing of the edges and the sampling
+of bitmaps are close to what EVE does but not identical, so golden images are made with this tool and not
+screenshots. Bitmaps in flash, ASTC and the FT80x only formats are skipped with a warning.
+
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <png.h>
+
+#include "EVE.h"
+
+#define MEMORY_SIZE 0x300000U
+#define ROM_FONT_ROOT 0x2ffffcU
+#define DL_WORDS (EVE_RAM_DL_SIZE / 4U)
+#define STEPS_MAX (DL_WORDS * 16U)
+#define CONTEXT_DEPTH 4U
+#define CALL_DEPTH 4U
+#define WIDTH_MAX 2048
+
+typedef struct
+{
+    uint32_t source;
+    uint8_t format;
+    uint16_t ext_format;
+    uint32_t stride;
+    uint32_t layout_height;
+    uint8_t filter;
+    uint8_t wrap_x;
+    uint8_t wrap_y;
+    uint32_t width;
+    uint32_t height;
+} handle_t;
+
+/* the graphics context, SAVE_CONTEXT and RESTORE_CONTEXT copy all of this */
+typedef struct
+{
+    uint8_t color[4]; /* r, g, b, a */
+    uint8_t clear_color[4];
+    uint8_t clear_stencil;
+    uint8_t clear_tag;
+    uint8_t tag;
+    uint8_t tag_mask;
+    uint16_t point_size;
+    uint16_t line_width;
+    uint8_t handle;
+    uint8_t cell;
+    uint8_t alpha_func;
+    uint8_t alpha_ref;
+    uint8_t stencil_func;
+    uint8_t stencil_ref;
+    uint8_t stencil_mask;
+    uint8_t stencil_write;
+    uint8_t stencil_fail;
+    uint8_t stencil_pass;
+    uint8_t blend_src;
+    uint8_t blend_dst;
+    uint8_t color_mask[4];
+    uint8_t vertex_format;
+    int32_t translate_x;
+    int32_t translate_y;
+    int32_t scissor_x0;
+    int32_t scissor_y0;
+    int32_t scissor_x1;
+    int32_t scissor_y1;
+    float transform[6]; /* A to F, in pixels */
+    uint32_t palette_source;
+} context_t;
+
+/* a bitmap handle resolved for drawing */
+typedef struct
+{
+    uint32_t base;
+    uint32_t format;
+    uint32_t bpp;
+    uint32_t stride;
+    int32_t layout_width;
+    int32_t layout_height;
+    uint32_t palette;
+} bitmap_t;
+
+static int32_t width = (int32_t) EVE_HSIZE;
+static int32_t height = (int32_t) EVE_VSIZE;
+
+static uint8_t *memory;
+static uint32_t memory_size;
+static bool rom_fonts;
+
+static uint8_t *plane[4]; /* r, g, b, a */
+static uint8_t *stencil;
+static uint8_t *tags;
+static uint8_t *strip; /* coverage of a line strip or an edge strip until it is drawn */
+static int32_t strip_x0;
+static int32_t strip_y0;
+static int32_t strip_x1;
+static int32_t strip_y1;
+
+/* one row of the primitive that is drawn, indexed by the x of the screen */
+static uint8_t span_cov[WIDTH_MAX];
+static uint8_t span_src[4][WIDTH_MAX];
+static uint8_t span_alpha[WIDTH_MAX];
+static uint8_t span_mask[WIDTH_MAX];
+static uint8_t span_fs[WIDTH_MAX];
+static uint8_t span_fd[WIDTH_MAX];
+static uint8_t span_tmp[WIDTH_MAX];
+
+static handle_t handles[32];
+static context_t ctx;
+static context_t stack[CONTEXT_DEPTH];
+static uint32_t stack_depth;
+static uint8_t primitive;
+static uint32_t vertex_count;
+static float vertex_x;
+static float vertex_y;
+
+static uint32_t warnings_flash;
+static uint32_t warnings_format;
+static uint32_t warnings_rom;
+static uint32_t warnings_dl;
+
+static void fail(const char *fmt, const char *arg)
+{
+    fprintf(stderr, "eve_render: ");
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(EXIT_FAILURE);
+}
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *data = calloc(count, size);
+
+    if (NULL == data)
+    {
+        fail("%s", "out of memory");
+    }
+    return data;
+}
+
+static uint8_t *read_file(const char *path, bool hex, uint32_t *length)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *data;
+    long size;
+
+    if (NULL == file)
+    {
+        fail("can not open %s", path);
+    }
+    fseek(file, 0L, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0L, SEEK_SET);
+    data = xcalloc((size_t) size + 4U, 1U);
+    if (hex)
+    {
+        char token[64];
+        uint32_t count = 0U;
+
+        /* one word per token, separated by white space or commas, tokens that end with ':' are offsets */
+        while ((1 == fscanf(file, "%63s", token)) && ((count + 4U) <= ((uint32_t) size + 4U)))
+        {
+            char *end;
+            unsigned long word = strtoul(token, &end, 16);
+
+            if ((end == token) || (':' == *end))
+            {
+                continue;
+            }
+            data[count] = (uint8_t) word;
+            data[count + 1U] = (uint8_t) (word >> 8U);
+            data[count + 2U] = (uint8_t) (word >> 16U);
+            data[count + 3U] = (uint8_t) (word >> 24U);
+            count += 4U;
+        }
+        *length = count;
+    }
+    else
+    {
+        *length = (uint32_t) fread(data, 1U, (size_t) size, file);
+    }
+    fclose(file);
+    return data;
+}
+
+static uint32_t mem8(uint32_t address)
+{
+    return (address < memory_size) ? memory[address] : 0U;
+}
+
+static uint32_t mem16(uint32_t address)
+{
+    return mem8(address) | (mem8(address + 1U) << 8U);
+}
+
+static uint32_t mem32(uint32_t address)
+{
+    return mem16(address) | (mem16(address + 2U) << 16U);
+}
+
+static int32_t sign_extend(uint32_t value, uint8_t bits)
+{
+    uint32_t sign = 1U << (bits - 1U);
+
+    value &= (sign << 1U) - 1U;
+    return (int32_t) (value ^ sign) - (int32_t) sign;
+}
+
+static int32_t clamp(int32_t value, int32_t low, int32_t high)
+{
+    return (value < low) ? low : ((value > high) ? high : value);
+}
+
+/* a * b / 255 rounded, exact for all 8 bit values and free of a division so the loops vectorize */
+static inline uint32_t mul8(uint32_t a, uint32_t b)
+{
+    uint32_t product = (a * b) + 128U;
+
+    return (product + (product >> 8U)) >> 8U;
+}
+
+/* the comparisons instead of fminf() and fmaxf() vectorize without -ffinite-math-only */
+static inline float clamp01(float value)
+{
+    value = (value < 0.0f) ? 0.0f : value;
+    return (value > 1.0f) ? 1.0f : value;
+}
+
+static inline float positive(float value)
+{
+    return (value > 0.0f) ? value : 0.0f;
+}
+
+static inline uint8_t coverage(float value)
+{
+    value = clamp01(value);
+    return (uint8_t) ((value * 255.0f) + 0.5f);
+}
+
+/*---- the state after a reset ----------------------------------------------------------------------------------------*/
+
+static void reset_context(void)
+{
+    memset(&ctx, 0, sizeof(ctx));
+    memset(ctx.color, 255, sizeof(ctx.color));
+    memset(ctx.color_mask, 1, sizeof(ctx.color_mask));
+    ctx.tag = 255U;
+    ctx.tag_mask = 1U;
+    ctx.point_size = 16U;
+    ctx.line_width = 16U;
+    ctx.alpha_func = (uint8_t) EVE_ALWAYS;
+    ctx.stencil_func = (uint8_t) EVE_ALWAYS;
+    ctx.stencil_mask = 255U;
+    ctx.stencil_write = 255U;
+    ctx.stencil_fail = (uint8_t) EVE_KEEP;
+    ctx.stencil_pass = (uint8_t) EVE_KEEP;
+    ctx.blend_src = (uint8_t) EVE_SRC_ALPHA;
+    ctx.blend_dst = (uint8_t) EVE_ONE_MINUS_SRC_ALPHA;
+    ctx.vertex_format = 4U;
+    ctx.scissor_x1 = width;
+    ctx.scissor_y1 = height;
+    ctx.transform[0] = 1.0f;
+    ctx.transform[4] = 1.0f;
+}
+
+/* the handles 16 to 31 are set up for the ROM fonts, from the font table the ROM points to */
+static void reset_handles(void)
+{
+    memset(handles, 0, sizeof(handles));
+    rom_fonts = (memory_size >= MEMORY_SIZE) && (mem32(ROM_FONT_ROOT) < (MEMORY_SIZE - (16U * 148U)));
+    if (rom_fonts)
+    {
+        for (uint32_t font = 16U; font < 32U; font++)
+        {
+            uint32_t metric = mem32(ROM_FONT_ROOT) + ((font - 16U) * 148U);
+            handle_t *handle = &handles[font];
+
+            handle->format = (uint8_t) mem32(metric + 128U);
+            handle->stride = mem32(metric + 132U);
+            handle->width = mem32(metric + 136U);
+            handle->height = mem32(metric + 140U);
+            handle->layout_height = handle->height;
+            handle->source = mem32(metric + 144U);
+        }
+    }
+}
+
+/*---- the hot loops, these only use arrays and operations that gcc vectorizes -----------------------------------------*/
+
+static void span_fill_color(int32_t x0, int32_t x1)
+{
+    for (uint32_t channel = 0U; channel < 4U; channel++)
+    {
+        memset(&span_src[channel][x0], ctx.color[channel], (size_t) (x1 - x0));
+    }
+}
+
+static void span_test(uint8_t *restrict mask, const uint8_t *restrict value, uint8_t func, uint8_t ref, int32_t x0,
+    int32_t x1)
+{
+    switch (func)
+    {
+        case EVE_NEVER:
+            memset(&mask[x0], 0, (size_t) (x1 - x0));
+            break;
+        case EVE_LESS:
+            for (int32_t x = x0; x < x1; x++) { mask[x] &= (ref < value[x]) ? 255U : 0U; }
+            break;
+        case EVE_LEQUAL:
+            for (int32_t x = x0; x < x1; x++) { mask[x] &= (ref <= value[x]) ? 255U : 0U; }
+            break;
+        case EVE_GREATER:
+            for (int32_t x = x0; x < x1; x++) { mask[x] &= (ref > value[x]) ? 255U : 0U; }
+            break;
+        case EVE_GEQUAL:
+            for (int32_t x = x0; x < x1; x++) { mask[x] &= (ref >= value[x]) ? 255U : 0U; }
+            break;
+        case EVE_EQUAL:
+            for (int32_t x = x0; x < x1; x++) { mask[x] &= (ref == value[x]) ? 255U : 0U; }
+            break;
+        case EVE_NOTEQUAL:
+            for (int32_t x = x0; x < x1; x++) { mask[x] &= (ref != value[x]) ? 255U : 0U; }
+            break;
+        default: /* EVE_ALWAYS */
+            break;
+    }
+}
+
+/* the alpha test compares the alpha of the fragment with the reference, the stencil test the reference with the stencil */
+static void span_alpha_test(uint8_t *restrict mask, const uint8_t *restrict alpha, int32_t x0, int32_t x1)
+{
+    uint8_t func = ctx.alpha_func;
+
+    /* span_test() has the reference on the left, swap the comparisons */
+    switch (func)
+    {
+        case EVE_LESS: func = (uint8_t) EVE_GREATER; break;
+        case EVE_LEQUAL: func = (uint8_t) EVE_GEQUAL; break;
+        case EVE_GREATER: func = (uint8_t) EVE_LESS; break;
+        case EVE_GEQUAL: func = (uint8_t) EVE_LEQUAL; break;
+        default: break;
+    }
+    span_test(mask, alpha, func, ctx.alpha_ref, x0, x1);
+}
+
+static void span_stencil_op(uint8_t *restrict result, const uint8_t *restrict value, uint8_t op, int32_t x0, int32_t x1)
+{
+    switch (op)
+    {
+        case 0U: /* ZERO */
+            memset(&result[x0], 0, (size_t) (x1 - x0));
+            break;
+        case EVE_REPLACE:
+            memset(&result[x0], ctx.stencil_ref, (size_t) (x1 - x0));
+            break;
+        case EVE_INCR:
+            for (int32_t x = x0; x < x1; x++) { result[x] = (value[x] < 255U) ? (uint8_t) (value[x] + 1U) : 255U; }
+            break;
+        case EVE_DECR:
+            for (int32_t x = x0; x < x1; x++) { result[x] = (value[x] > 0U) ? (uint8_t) (value[x] - 1U) : 0U; }
+            break;
+        case EVE_INVERT:
+            for (int32_t x = x0; x < x1; x++) { result[x] = (uint8_t) ~value[x]; }
+            break;
+        default: /* EVE_KEEP */
+            memcpy(&result[x0], &value[x0], (size_t) (x1 - x0));
+            break;
+    }
+}
+
+static void span_factor(uint8_t *restrict factor, uint8_t func, const uint8_t *restrict src_alpha,
+    const uint8_t *restrict dst_alpha, int32_t x0, int32_t x1)
+{
+    switch (func)
+    {
+        case EVE_ZERO:
+            memset(&factor[x0], 0, (size_t) (x1 - x0));
+            break;
+        case EVE_ONE:
+            memset(&factor[x0], 255, (size_t) (x1 - x0));
+            break;
+        case EVE_SRC_ALPHA:
+            memcpy(&factor[x0], &src_alpha[x0], (size_t) (x1 - x0));
+            break;
+        case EVE_DST_ALPHA:
+            memcpy(&factor[x0], &dst_alpha[x0], (size_t) (x1 - x0));
+            break;
+        case EVE_ONE_MINUS_SRC_ALPHA:
+            for (int32_t x = x0; x < x1; x++) { factor[x] = (uint8_t) (255U - src_alpha[x]); }
+            break;
+        default: /* EVE_ONE_MINUS_DST_ALPHA */
+            for (int32_t x = x0; x < x1; x++) { factor[x] = (uint8_t) (255U - dst_alpha[x]); }
+            break;
+    }
+}
+
+static void span_blend(uint8_t *restrict dst, const uint8_t *restrict src, const uint8_t *restrict fs,
+    const uint8_t *restrict fd, const uint8_t *restrict mask, int32_t x0, int32_t x1)
+{
+    for (int32_t x = x0; x < x1; x++)
+    {
+        uint32_t value = mul8(src[x], fs[x]) + mul8(dst[x], fd[x]);
+
+        value = (value > 255U) ? 255U : value;
+        dst[x] = (uint8_t) ((value & mask[x]) | (dst[x] & (uint32_t) (uint8_t) ~mask[x]));
+    }
+}
+
+static void span_select(uint8_t *restrict dst, const uint8_t *restrict src, const uint8_t *restrict mask, int32_t x0,
+    int32_t x1)
+{
+    for (int32_t x = x0; x < x1; x++)
+    {
+        dst[x] = (uint8_t) ((src[x] & mask[x]) | (dst[x] & (uint8_t) ~mask[x]));
+    }
+}
+
+/* draws span_cov and span_src of row y from x0 to x1 with the tests, the blending and the masks of the context */
+static void span_commit(int32_t y, int32_t x0, int32_t x1)
+{
+    uint32_t row = (uint32_t) y * (uint32_t) width;
+    uint8_t *restrict cov = span_cov;
+    uint8_t *restrict alpha = span_alpha;
+    uint8_t *restrict mask = span_mask;
+    const uint8_t *restrict src_alpha = span_src[3];
+
+    if ((y < ctx.scissor_y0) || (y >= ctx.scissor_y1) || (y < 0) || (y >= height))
+    {
+        return;
+    }
+    x0 = clamp(x0, (ctx.scissor_x0 > 0) ? ctx.scissor_x0 : 0, width);
+    x1 = clamp(x1, x0, (ctx.scissor_x1 < width) ? ctx.scissor_x1 : width);
+    if (x0 >= x1)
+    {
+        return;
+    }
+
+    for (int32_t x = x0; x < x1; x++)
+    {
+        alpha[x] = (uint8_t) mul8(src_alpha[x], cov[x]);
+        mask[x] = (cov[x] != 0U) ? 255U : 0U;
+    }
+    span_alpha_test(mask, alpha, x0, x1);
+
+    if ((ctx.stencil_func != EVE_ALWAYS) || (ctx.stencil_fail != EVE_KEEP) || (ctx.stencil_pass != EVE_KEEP))
+    {
+        uint8_t *restrict st = &stencil[row];
+        uint8_t *restrict pass = span_fs;
+        uint8_t *restrict result = span_fd;
+        uint8_t *restrict masked = span_tmp;
+
+        for (int32_t x = x0; x < x1; x++)
+        {
+            masked[x] = st[x] & ctx.stencil_mask;
+        }
+        memcpy(&pass[x0], &mask[x0], (size_t) (x1 - x0));
+        span_test(pass, masked, ctx.stencil_func, ctx.stencil_ref & ctx.stencil_mask, x0, x1);
+
+        /* the new stencil of the pixels that fail, then of those that pass */
+        span_stencil_op(result, st, ctx.stencil_fail, x0, x1);
+        for (int32_t x = x0; x < x1; x++)
+        {
+            masked[x] = (uint8_t) (mask[x] & (uint8_t) ~pass[x] & ctx.stencil_write);
+        }
+        span_select(st, result, masked, x0, x1);
+        span_stencil_op(result, st, ctx.stencil_pass, x0, x1);
+        for (int32_t x = x0; x < x1; x++)
+        {
+            masked[x] = (uint8_t) (pass[x] & ctx.stencil_write);
+        }
+        span_select(st, result, masked, x0, x1);
+        memcpy(&mask[x0], &pass[x0], (size_t) (x1 - x0));
+    }
+
+    span_factor(span_fs, ctx.blend_src, alpha, &plane[3][row], x0, x1);
+    span_factor(span_fd, ctx.blend_dst, alpha, &plane[3][row], x0, x1);
+    for (uint32_t channel = 0U; channel < 3U; channel++)
+    {
+        if (ctx.color_mask[channel] != 0U)
+        {
+            span_blend(&plane[channel][row], span_src[channel], span_fs, span_fd, mask, x0, x1);
+        }
+    }
+    if (ctx.color_mask[3] != 0U)
+    {
+        span_blend(&plane[3][row], alpha, span_fs, span_fd, mask, x0, x1);
+    }
+
+    if (ctx.tag_mask != 0U)
+    {
+        memset(&span_tmp[x0], ctx.tag, (size_t) (x1 - x0));
+        span_select(&tags[row], span_tmp, mask, x0, x1);
+    }
+}
+
+/*---- primitives ------------------------------------------------------------------------------------------------------*/
+
+static void clear(uint32_t word)
+{
+    int32_t x0 = (ctx.scissor_x0 > 0) ? ctx.scissor_x0 : 0;
+    int32_t x1 = (ctx.scissor_x1 < width) ? ctx.scissor_x1 : width;
+    int32_t y0 = (ctx.scissor_y0 > 0) ? ctx.scissor_y0 : 0;
+    int32_t y1 = (ctx.scissor_y1 < height) ? ctx.scissor_y1 : height;
+
+    for (int32_t y = y0; (y < y1) && (x0 < x1); y++)
+    {
+        uint32_t row = ((uint32_t) y * (uint32_t) width) + (uint32_t) x0;
+
+        if ((word & 4U) != 0U)
+        {
+            for (uint32_t channel = 0U; channel < 4U; channel++)
+            {
+                memset(&plane[channel][row], ctx.clear_color[channel], (size_t) (x1 - x0));
+            }
+        }
+        if ((word & 2U) != 0U)
+        {
+            memset(&stencil[row], ctx.clear_stencil, (size_t) (x1 - x0));
+        }
+        if ((word & 1U) != 0U)
+        {
+            memset(&tags[row], ctx.clear_tag, (size_t) (x1 - x0));
+        }
+    }
+}
+
+static void draw_point(float cx, float cy)
+{
+    float radius = (float) ctx.point_size / 16.0f;
+    int32_t y0 = (int32_t) floorf(cy - radius - 1.0f);
+    int32_t y1 = (int32_t) ceilf(cy + radius + 1.0f);
+    int32_t x0 = clamp((int32_t) floorf(cx - radius - 1.0f), 0, width);
+    int32_t x1 = clamp((int32_t) ceilf(cx + radius + 1.0f), x0, width);
+
+    span_fill_color(x0, x1);
+    for (int32_t y = y0; y < y1; y++)
+    {
+        float dy = ((float) y + 0.5f) - cy;
+
+        for (int32_t x = x0; x < x1; x++)
+        {
+            float dx = ((float) x + 0.5f) - cx;
+
+            span_cov[x] = coverage(radius + 0.5f - sqrtf((dx * dx) + (dy * dy)));
+        }
+        span_commit(y, x0, x1);
+    }
+}
+
+/* the distance to the line from a to b, for LINES and LINE_STRIP, into cov of row y */
+static void capsule_row(uint8_t *restrict cov, int32_t y, int32_t x0, int32_t x1, float ax, float ay, float bx, float by,
+    float radius)
+{
+    float ex = bx - ax;
+    float ey = by - ay;
+    float length = (ex * ex) + (ey * ey);
+    float inverse = (length > 0.0f) ? (1.0f / length) : 0.0f;
+    float py = ((float) y + 0.5f) - ay;
+
+    for (int32_t x = x0; x < x1; x++)
+    {
+        float px = ((float) x + 0.5f) - ax;
+        float t = clamp01(((px * ex) + (py * ey)) * inverse);
+        float dx = px - (t * ex);
+        float dy = py - (t * ey);
+
+        cov[x] = coverage(radius + 0.5f - sqrtf((dx * dx) + (dy * dy)));
+    }
+}
+
+static void draw_line(float ax, float ay, float bx, float by)
+{
+    float radius = (float) ctx.line_width / 16.0f;
+    int32_t y0 = (int32_t) floorf(fminf(ay, by) - radius - 1.0f);
+    int32_t y1 = (int32_t) ceilf(fmaxf(ay, by) + radius + 1.0f);
+    int32_t x0 = clamp((int32_t) floorf(fminf(ax, bx) - radius - 1.0f), 0, width);
+    int32_t x1 = clamp((int32_t) ceilf(fmaxf(ax, bx) + radius + 1.0f), x0, width);
+
+    span_fill_color(x0, x1);
+    for (int32_t y = y0; y < y1; y++)
+    {
+        capsule_row(span_cov, y, x0, x1, ax, ay, bx, by, radius);
+        span_commit(y, x0, x1);
+    }
+}
+
+/* a rectangle from the pixel of the first to the pixel of the second vertex, the line width rounds the corners */
+static void draw_rect(float ax, float ay, float bx, float by)
+{
+    float radius = (float) ctx.line_width / 16.0f;
+    float left = fminf(ax, bx) + radius;
+    float right = (fmaxf(ax, bx) + 1.0f) - radius;
+    float top = fminf(ay, by) + radius;
+    float bottom = (fmaxf(ay, by) + 1.0f) - radius;
+    int32_t y0 = (int32_t) floorf(fminf(ay, by));
+    int32_t y1 = (int32_t) ceilf(fmaxf(ay, by) + 1.0f);
+    int32_t x0 = clamp((int32_t) floorf(fminf(ax, bx)), 0, width);
+    int32_t x1 = clamp((int32_t) ceilf(fmaxf(ax, bx) + 1.0f), x0, width);
+
+    if (left > right)
+    {
+        left = right = (left + right) * 0.5f;
+    }
+    if (top > bottom)
+    {
+        top = bottom = (top + bottom) * 0.5f;
+    }
+    span_fill_color(x0, x1);
+    for (int32_t y = y0; y < y1; y++)
+    {
+        float py = (float) y + 0.5f;
+        float dy = positive((top - py > py - bottom) ? (top - py) : (py - bottom));
+
+        for (int32_t x = x0; x < x1; x++)
+        {
+            float px = (float) x + 0.5f;
+            float dx = positive((left - px > px - right) ? (left - px) : (px - right));
+
+            span_cov[x] = coverage(radius + 0.5f - sqrtf((dx * dx) + (dy * dy)));
+        }
+        span_commit(y, x0, x1);
+    }
+}
+
+/*---- strips, the coverage of all segments is collected and drawn at once so the joints are not blended twice ---------*/
+
+static void strip_extend(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    strip_x0 = (x0 < strip_x0) ? x0 : strip_x0;
+    strip_y0 = (y0 < strip_y0) ? y0 : strip_y0;
+    strip_x1 = (x1 > strip_x1) ? x1 : strip_x1;
+    strip_y1 = (y1 > strip_y1) ? y1 : strip_y1;
+}
+
+static void strip_merge(int32_t y, int32_t x0, int32_t x1)
+{
+    uint8_t *restrict row = &strip[(uint32_t) y * (uint32_t) width];
+    const uint8_t *restrict cov = span_tmp;
+
+    for (int32_t x = x0; x < x1; x++)
+    {
+        row[x] = (cov[x] > row[x]) ? cov[x] : row[x];
+    }
+}
+
+static void strip_line(float ax, float ay, float bx, float by)
+{
+    float radius = (float) ctx.line_width / 16.0f;
+    int32_t y0 = clamp((int32_t) floorf(fminf(ay, by) - radius - 1.0f), 0, height);
+    int32_t y1 = clamp((int32_t) ceilf(fmaxf(ay, by) + radius + 1.0f), y0, height);
+    int32_t x0 = clamp((int32_t) floorf(fminf(ax, bx) - radius - 1.0f), 0, width);
+    int32_t x1 = clamp((int32_t) ceilf(fmaxf(ax, bx) + radius + 1.0f), x0, width);
+
+    for (int32_t y = y0; y < y1; y++)
+    {
+        capsule_row(span_tmp, y, x0, x1, ax, ay, bx, by, radius);
+        strip_merge(y, x0, x1);
+    }
+    strip_extend(x0, y0, x1, y1);
+}
+
+/* the area right or left of a segment for EDGE_STRIP_R and EDGE_STRIP_L, above or below for EDGE_STRIP_A and _B */
+static void strip_edge(float ax, float ay, float bx, float by)
+{
+    bool vertical = (EVE_EDGE_STRIP_R == primitive) || (EVE_EDGE_STRIP_L == primitive);
+    bool after = (EVE_EDGE_STRIP_R == primitive) || (EVE_EDGE_STRIP_B == primitive);
+    int32_t x0 = 0;
+    int32_t x1 = width;
+    int32_t y0 = 0;
+    int32_t y1 = height;
+
+    if (vertical)
+    {
+        float slope = (by != ay) ? ((bx - ax) / (by - ay)) : 0.0f;
+
+        y0 = clamp((int32_t) floorf(fminf(ay, by) + 0.5f), 0, height);
+        y1 = clamp((int32_t) floorf(fmaxf(ay, by) + 0.5f), y0, height);
+        for (int32_t y = y0; y < y1; y++)
+        {
+            float edge = ax + ((((float) y + 0.5f) - ay) * slope);
+
+            for (int32_t x = 0; x < width; x++)
+            {
+                span_tmp[x] = coverage(after ? (((float) x + 1.0f) - edge) : (edge - (float) x));
+            }
+            strip_merge(y, 0, width);
+        }
+    }
+    else
+    {
+        float slope = (bx != ax) ? ((by - ay) / (bx - ax)) : 0.0f;
+
+        x0 = clamp((int32_t) floorf(fminf(ax, bx) + 0.5f), 0, width);
+        x1 = clamp((int32_t) floorf(fmaxf(ax, bx) + 0.5f), x0, width);
+        for (int32_t y = 0; y < height; y++)
+        {
+            for (int32_t x = x0; x < x1; x++)
+            {
+                float edge = ay + ((((float) x + 0.5f) - ax) * slope);
+
+                span_tmp[x] = coverage(after ? (((float) y + 1.0f) - edge) : (edge - (float) y));
+            }
+            strip_merge(y, x0, x1);
+        }
+    }
+    strip_extend(x0, y0, x1, y1);
+}
+
+static void strip_flush(void)
+{
+    if ((strip_x0 >= strip_x1) || (strip_y0 >= strip_y1))
+    {
+        return;
+    }
+    span_fill_color(strip_x0, strip_x1);
+    for (int32_t y = strip_y0; y < strip_y1; y++)
+    {
+        uint8_t *row = &strip[(uint32_t) y * (uint32_t) width];
+
+        memcpy(&span_cov[strip_x0], &row[strip_x0], (size_t) (strip_x1 - strip_x0));
+        memset(&row[strip_x0], 0, (size_t) (strip_x1 - strip_x0));
+        span_commit(y, strip_x0, strip_x1);
+    }
+    strip_x0 = width;
+    strip_y0 = height;
+    strip_x1 = 0;
+    strip_y1 = 0;
+}
+
+/*---- bitmaps ---------------------------------------------------------------------------------------------------------*/
+
+static uint32_t bits_per_pixel(uint32_t format)
+{
+    switch (format)
+    {
+        case EVE_L1: return 1U;
+        case EVE_L2: return 2U;
+        case EVE_L4: return 4U;
+        case EVE_L8:
+        case EVE_RGB332:
+        case EVE_ARGB2:
+        case EVE_PALETTED565:
+        case EVE_PALETTED4444:
+        case EVE_PALETTED8: return 8U;
+        case EVE_ARGB1555:
+        case EVE_ARGB4:
+        case EVE_RGB565: return 16U;
+        default: return 0U; /* not supported */
+    }
+}
+
+static uint8_t expand5(uint32_t value)
+{
+    return (uint8_t) ((value << 3U) | (value >> 2U));
+}
+
+static uint8_t expand6(uint32_t value)
+{
+    return (uint8_t) ((value << 2U) | (value >> 4U));
+}
+
+static void rgb565(uint32_t value, uint8_t *texel)
+{
+    texel[0] = expand5((value >> 11U) & 31U);
+    texel[1] = expand6((value >> 5U) & 63U);
+    texel[2] = expand5(value & 31U);
+    texel[3] = 255U;
+}
+
+static void argb4(uint32_t value, uint8_t *texel)
+{
+    texel[0] = (uint8_t) (((value >> 8U) & 15U) * 17U);
+    texel[1] = (uint8_t) (((value >> 4U) & 15U) * 17U);
+    texel[2] = (uint8_t) ((value & 15U) * 17U);
+    texel[3] = (uint8_t) (((value >> 12U) & 15U) * 17U);
+}
+
+static void luminance(uint32_t value, uint8_t *texel)
+{
+    texel[0] = 255U;
+    texel[1] = 255U;
+    texel[2] = 255U;
+    texel[3] = (uint8_t) value;
+}
+
+/* the texel in r, g, b, a, the luminance formats are white with the luminance as alpha like on EVE */
+static void fetch_texel(const bitmap_t *bitmap, int32_t tx, int32_t ty, uint8_t *texel)
+{
+    uint32_t bit = (uint32_t) tx * bitmap->bpp;
+    uint32_t address = bitmap->base + ((uint32_t) ty * bitmap->stride) + (bit >> 3U);
+    uint32_t value = (bitmap->bpp > 8U) ? mem16(address) : mem8(address);
+
+    switch (bitmap->format)
+    {
+        case EVE_ARGB1555:
+            texel[0] = expand5((value >> 10U) & 31U);
+            texel[1] = expand5((value >> 5U) & 31U);
+            texel[2] = expand5(value & 31U);
+            texel[3] = ((value & 0x8000U) != 0U) ? 255U : 0U;
+            break;
+        case EVE_L1:
+            luminance((((value >> (7U - (bit & 7U))) & 1U) != 0U) ? 255U : 0U, texel);
+            break;
+        case EVE_L2:
+            luminance(((value >> (6U - (bit & 7U))) & 3U) * 85U, texel);
+            break;
+        case EVE_L4:
+            luminance(((value >> (4U - (bit & 7U))) & 15U) * 17U, texel);
+            break;
+        case EVE_L8:
+            luminance(value, texel);
+            break;
+        case EVE_RGB332:
+            texel[0] = (uint8_t) (((value >> 5U) * 255U) / 7U);
+            texel[1] = (uint8_t) ((((value >> 2U) & 7U) * 255U) / 7U);
+            texel[2] = (uint8_t) ((value & 3U) * 85U);
+            texel[3] = 255U;
+            break;
+        case EVE_ARGB2:
+            texel[0] = (uint8_t) (((value >> 4U) & 3U) * 85U);
+            texel[1] = (uint8_t) (((value >> 2U) & 3U) * 85U);
+            texel[2] = (uint8_t) ((value & 3U) * 85U);
+            texel[3] = (uint8_t) ((value >> 6U) * 85U);
+            break;
+        case EVE_ARGB4:
+            argb4(value, texel);
+            break;
+        case EVE_RGB565:
+            rgb565(value, texel);
+            break;
+        case EVE_PALETTED565:
+            rgb565(mem16(bitmap->palette + (value * 2U)), texel);
+            break;
+        case EVE_PALETTED4444:
+            argb4(mem16(bitmap->palette + (value * 2U)), texel);
+            break;
+        default: /* EVE_PALETTED8 */
+            value = mem32(bitmap->palette + (value * 4U));
+            texel[0] = (uint8_t) (value >> 16U);
+            texel[1] = (uint8_t) (value >> 8U);
+            texel[2] = (uint8_t) value;
+            texel[3] = (uint8_t) (value >> 24U);
+            break;
+    }
+}
+
+/* false for a texel outside of the bitmap with BORDER */
+static bool wrap(int32_t *coordinate, int32_t size, uint8_t mode)
+{
+    if (EVE_REPEAT == mode)
+    {
+        *coordinate %= size;
+        *coordinate += (*coordinate < 0) ? size : 0;
+        return true;
+    }
+    return (*coordinate >= 0) && (*coordinate < size);
+}
+
+static void sample_nearest(const bitmap_t *bitmap, const handle_t *handle, float u, float v, uint8_t *texel)
+{
+    int32_t tx = (int32_t) floorf(u);
+    int32_t ty = (int32_t) floorf(v);
+
+    if (wrap(&tx, bitmap->layout_width, handle->wrap_x) && wrap(&ty, bitmap->layout_height, handle->wrap_y))
+    {
+        fetch_texel(bitmap, tx, ty, texel);
+    }
+    else
+    {
+        memset(texel, 0, 4U);
+    }
+}
+
+static void sample_bilinear(const bitmap_t *bitmap, const handle_t *handle, float u, float v, uint8_t *texel)
+{
+    float fu = u - 0.5f;
+    float fv = v - 0.5f;
+    int32_t tx = (int32_t) floorf(fu);
+    int32_t ty = (int32_t) floorf(fv);
+    float wx = fu - (float) tx;
+    float wy = fv - (float) ty;
+    uint8_t corner[4][4];
+    float sum[4];
+
+    sample_nearest(bitmap, handle, (float) tx + 0.5f, (float) ty + 0.5f, corner[0]);
+    sample_nearest(bitmap, handle, (float) tx + 1.5f, (float) ty + 0.5f, corner[1]);
+    sample_nearest(bitmap, handle, (float) tx + 0.5f, (float) ty + 1.5f, corner[2]);
+    sample_nearest(bitmap, handle, (float) tx + 1.5f, (float) ty + 1.5f, corner[3]);
+    for (uint32_t channel = 0U; channel < 4U; channel++)
+    {
+        sum[channel] = ((((float) corner[0][channel] * (1.0f - wx)) + ((float) corner[1][channel] * wx)) * (1.0f - wy)) +
+            ((((float) corner[2][channel] * (1.0f - wx)) + ((float) corner[3][channel] * wx)) * wy);
+        texel[channel] = (uint8_t) (sum[channel] + 0.5f);
+    }
+}
+
+static void draw_bitmap(float px, float py, uint8_t index, uint8_t cell)
+{
+    const handle_t *handle = &handles[index];
+    uint32_t format = (EVE_GLFORMAT == handle->format) ? handle->ext_format : handle->format;
+    const float *matrix = ctx.transform;
+    int32_t draw_width = (0U == handle->width) ? 2048 : (int32_t) handle->width;
+    int32_t draw_height = (0U == handle->height) ? 2048 : (int32_t) handle->height;
+    int32_t x0 = clamp((int32_t) floorf(px), 0, width);
+    int32_t x1 = clamp((int32_t) floorf(px) + draw_width, x0, width);
+    int32_t y0 = clamp((int32_t) floorf(py), 0, height);
+    int32_t y1 = clamp((int32_t) floorf(py) + draw_height, y0, height);
+    bitmap_t bitmap;
+
+    if ((index >= 16U) && (!rom_fonts) && (0U == handle->source))
+    {
+        warnings_rom++;
+        return;
+    }
+    if ((handle->source & 0x800000U) != 0U)
+    {
+        warnings_flash++;
+        return;
+    }
+    bitmap.format = format;
+    bitmap.bpp = bits_per_pixel(format);
+    if (0U == bitmap.bpp)
+    {
+        warnings_format++;
+        return;
+    }
+    bitmap.stride = handle->stride;
+    bitmap.layout_width = (int32_t) ((bitmap.stride * 8U) / bitmap.bpp);
+    bitmap.layout_height = (int32_t) handle->layout_height;
+    bitmap.base = handle->source + ((uint32_t) cell * bitmap.stride * handle->layout_height);
+    bitmap.palette = ctx.palette_source;
+    if ((bitmap.layout_width <= 0) || (bitmap.layout_height <= 0))
+    {
+        return;
+    }
+
+    for (int32_t y = y0; y < y1; y++)
+    {
+        float dy = ((float) y + 0.5f) - py;
+
+        for (int32_t x = x0; x < x1; x++)
+        {
+            float dx = ((float) x + 0.5f) - px;
+            float u = (matrix[0] * dx) + (matrix[1] * dy) + matrix[2];
+            float v = (matrix[3] * dx) + (matrix[4] * dy) + matrix[5];
+            uint8_t texel[4];
+
+            if (EVE_BILINEAR == handle->filter)
+            {
+                sample_bilinear(&bitmap, handle, u, v, texel);
+            }
+            else
+            {
+                sample_nearest(&bitmap, handle, u, v, texel);
+            }
+            span_src[0][x] = texel[0];
+            span_src[1][x] = texel[1];
+            span_src[2][x] = texel[2];
+            span_src[3][x] = texel[3];
+        }
+
+        /* the colour of the context tints the bitmap */
+        for (uint32_t channel = 0U; channel < 4U; channel++)
+        {
+            uint8_t *restrict src = span_src[channel];
+            uint32_t tint = ctx.color[channel];
+
+            for (int32_t x = x0; x < x1; x++)
+            {
+                src[x] = (uint8_t) mul8(src[x], tint);
+            }
+        }
+        memset(&span_cov[x0], 255, (size_t) (x1 - x0));
+        span_commit(y, x0, x1);
+    }
+}
+
+/*---- the display-list ------------------------------------------------------------------------------------------------*/
+
+static void vertex(float x, float y, uint8_t handle, uint8_t cell)
+{
+    switch (primitive)
+    {
+        case EVE_BITMAPS:
+            draw_bitmap(x, y, handle, cell);
+            break;
+        case EVE_POINTS:
+            draw_point(x, y);
+            break;
+        case EVE_LINES:
+        case EVE_RECTS:
+            if ((vertex_count & 1U) != 0U)
+            {
+                if (EVE_LINES == primitive)
+                {
+                    draw_line(vertex_x, vertex_y, x, y);
+                }
+                else
+                {
+                    draw_rect(vertex_x, vertex_y, x, y);
+                }
+            }
+            break;
+        case EVE_LINE_STRIP:
+            if (vertex_count != 0U)
+            {
+                strip_line(vertex_x, vertex_y, x, y);
+            }
+            break;
+        case EVE_EDGE_STRIP_R:
+        case EVE_EDGE_STRIP_L:
+        case EVE_EDGE_STRIP_A:
+        case EVE_EDGE_STRIP_B:
+            if (vertex_count != 0U)
+            {
+                strip_edge(vertex_x, vertex_y, x, y);
+            }
+            break;
+        default: /* no BEGIN */
+            break;
+    }
+    vertex_x = x;
+    vertex_y = y;
+    vertex_count++;
+}
+
+static float transform_value(uint32_t word)
+{
+    return (float) sign_extend(word, 17U) / (((word & 0x20000U) != 0U) ? 32768.0f : 256.0f);
+}
+
+static void execute(const uint32_t *words, uint32_t count)
+{
+    uint32_t calls[CALL_DEPTH];
+    uint32_t call_depth = 0U;
+    uint32_t pc = 0U;
+
+    for (uint32_t step = 0U; (step < STEPS_MAX) && (pc < count); step++)
+    {
+        uint32_t word = words[pc++];
+        uint32_t opcode = word >> 24U;
+        handle_t *handle = &handles[ctx.handle];
+
+        if (1U == (word >> 30U)) /* VERTEX2F */
+        {
+            float scale = 1.0f / (float) (1U << ctx.vertex_format);
+
+            vertex(((float) sign_extend(word >> 15U, 15U) * scale) + ((float) ctx.translate_x / 16.0f),
+                ((float) sign_extend(word, 15U) * scale) + ((float) ctx.translate_y / 16.0f), ctx.handle, ctx.cell);
+            continue;
+        }
+        if (2U == (word >> 30U)) /* VERTEX2II */
+        {
+            vertex((float) ((word >> 21U) & 511U) + ((float) ctx.translate_x / 16.0f),
+                (float) ((word >> 12U) & 511U) + ((float) ctx.translate_y / 16.0f), (uint8_t) ((word >> 7U) & 31U),
+                (uint8_t) (word & 127U));
+            continue;
+        }
+
+        strip_flush(); /* a strip is drawn with the state it was started with */
+        switch (opcode)
+        {
+            case 0U: /* DISPLAY */
+                return;
+            case 1U: /* BITMAP_SOURCE */
+                handle->source = word & 0xffffffU;
+                break;
+            case 2U: /* CLEAR_COLOR_RGB */
+                ctx.clear_color[0] = (uint8_t) (word >> 16U);
+                ctx.clear_color[1] = (uint8_t) (word >> 8U);
+                ctx.clear_color[2] = (uint8_t) word;
+                break;
+            case 3U: /* TAG */
+                ctx.tag = (uint8_t) word;
+                break;
+            case 4U: /* COLOR_RGB */
+                ctx.color[0] = (uint8_t) (word >> 16U);
+                ctx.color[1] = (uint8_t) (word >> 8U);
+                ctx.color[2] = (uint8_t) word;
+                break;
+            case 5U: /* BITMAP_HANDLE */
+                ctx.handle = (uint8_t) (word & 31U);
+                break;
+            case 6U: /* CELL */
+                ctx.cell = (uint8_t) (word & 127U);
+                break;
+            case 7U: /* BITMAP_LAYOUT */
+                handle->format = (uint8_t) ((word >> 19U) & 31U);
+                handle->stride = (handle->stride & 0xc00U) | ((word >> 9U) & 1023U);
+                handle->layout_height = (handle->layout_height & 0x600U) | (word & 511U);
+                break;
+            case 8U: /* BITMAP_SIZE */
+                handle->filter = (uint8_t) ((word >> 20U) & 1U);
+                handle->wrap_x = (uint8_t) ((word >> 19U) & 1U);
+                handle->wrap_y = (uint8_t) ((word >> 18U) & 1U);
+                handle->width = (handle->width & 0x600U) | ((word >> 9U) & 511U);
+                handle->height = (handle->height & 0x600U) | (word & 511U);
+                break;
+            case 9U: /* ALPHA_FUNC */
+                ctx.alpha_func = (uint8_t) ((word >> 8U) & 7U);
+                ctx.alpha_ref = (uint8_t) word;
+                break;
+            case 10U: /* STENCIL_FUNC */
+                ctx.stencil_func = (uint8_t) ((word >> 16U) & 7U);
+                ctx.stencil_ref = (uint8_t) (word >> 8U);
+                ctx.stencil_mask = (uint8_t) word;
+                break;
+            case 11U: /* BLEND_FUNC */
+                ctx.blend_src = (uint8_t) ((word >> 3U) & 7U);
+                ctx.blend_dst = (uint8_t) (word & 7U);
+                break;
+            case 12U: /* STENCIL_OP */
+                ctx.stencil_fail = (uint8_t) ((word >> 3U) & 7U);
+                ctx.stencil_pass = (uint8_t) (word & 7U);
+                break;
+            case 13U: /* POINT_SIZE */
+                ctx.point_size = (uint16_t) (word & 8191U);
+                break;
+            case 14U: /* LINE_WIDTH */
+                ctx.line_width = (uint16_t) (word & 4095U);
+                break;
+            case 15U: /* CLEAR_COLOR_A */
+                ctx.clear_color[3] = (uint8_t) word;
+                break;
+            case 16U: /* COLOR_A */
+                ctx.color[3] = (uint8_t) word;
+                break;
+            case 17U: /* CLEAR_STENCIL */
+                ctx.clear_stencil = (uint8_t) word;
+                break;
+            case 18U: /* CLEAR_TAG */
+                ctx.clear_tag = (uint8_t) word;
+                break;
+            case 19U: /* STENCIL_MASK */
+                ctx.stencil_write = (uint8_t) word;
+                break;
+            case 20U: /* TAG_MASK */
+                ctx.tag_mask = (uint8_t) (word & 1U);
+                break;
+            case 21U: /* BITMAP_TRANSFORM_A */
+            case 22U: /* BITMAP_TRANSFORM_B */
+                ctx.transform[opcode - 21U] = transform_value(word);
+                break;
+            case 23U: /* BITMAP_TRANSFORM_C */
+                ctx.transform[2] = (float) sign_extend(word, 24U) / 256.0f;
+                break;
+            case 24U: /* BITMAP_TRANSFORM_D */
+            case 25U: /* BITMAP_TRANSFORM_E */
+                ctx.transform[opcode - 21U] = transform_value(word);
+                break;
+            case 26U: /* BITMAP_TRANSFORM_F */
+                ctx.transform[5] = (float) sign_extend(word, 24U) / 256.0f;
+                break;
+            case 27U: /* SCISSOR_XY */
+                ctx.scissor_x1 += (int32_t) ((word >> 11U) & 2047U) - ctx.scissor_x0;
+                ctx.scissor_y1 += (int32_t) (word & 2047U) - ctx.scissor_y0;
+                ctx.scissor_x0 = (int32_t) ((word >> 11U) & 2047U);
+                ctx.scissor_y0 = (int32_t) (word & 2047U);
+                break;
+            case 28U: /* SCISSOR_SIZE */
+                ctx.scissor_x1 = ctx.scissor_x0 + (int32_t) ((word >> 12U) & 4095U);
+                ctx.scissor_y1 = ctx.scissor_y0 + (int32_t) (word & 4095U);
+                break;
+            case 29U: /* CALL */
+                if (call_depth < CALL_DEPTH)
+                {
+                    calls[call_depth++] = pc;
+                    pc = word & 65535U;
+                }
+                else
+                {
+                    warnings_dl++;
+                }
+                break;
+            case 30U: /* JUMP */
+                pc = word & 65535U;
+                break;
+            case 31U: /* BEGIN */
+                primitive = (uint8_t) (word & 15U);
+                vertex_count = 0U;
+                break;
+            case 32U: /* COLOR_MASK */
+                ctx.color_mask[0] = (uint8_t) ((word >> 3U) & 1U);
+                ctx.color_mask[1] = (uint8_t) ((word >> 2U) & 1U);
+                ctx.color_mask[2] = (uint8_t) ((word >> 1U) & 1U);
+                ctx.color_mask[3] = (uint8_t) (word & 1U);
+                break;
+            case 33U: /* END */
+                primitive = 0U;
+                vertex_count = 0U;
+                break;
+            case 34U: /* SAVE_CONTEXT */
+                if (stack_depth < CONTEXT_DEPTH)
+                {
+                    stack[stack_depth++] = ctx;
+                }
+                else
+                {
+                    warnings_dl++;
+                }
+                break;
+            case 35U: /* RESTORE_CONTEXT */
+                if (stack_depth > 0U)
+                {
+                    ctx = stack[--stack_depth];
+                }
+                else
+                {
+                    warnings_dl++;
+                }
+                break;
+            case 36U: /* RETURN */
+                if (call_depth > 0U)
+                {
+                    pc = calls[--call_depth];
+                }
+                else
+                {
+                    warnings_dl++;
+                }
+                break;
+            case 38U: /* CLEAR */
+                clear(word);
+                break;
+            case 39U: /* VERTEX_FORMAT */
+                ctx.vertex_format = (uint8_t) (word & 7U);
+                ctx.vertex_format = (ctx.vertex_format > 4U) ? 4U : ctx.vertex_format;
+                break;
+            case 40U: /* BITMAP_LAYOUT_H */
+                handle->stride = (handle->stride & 1023U) | (((word >> 2U) & 3U) << 10U);
+                handle->layout_height = (handle->layout_height & 511U) | ((word & 3U) << 9U);
+                break;
+            case 41U: /* BITMAP_SIZE_H */
+                handle->width = (handle->width & 511U) | (((word >> 2U) & 3U) << 9U);
+                handle->height = (handle->height & 511U) | ((word & 3U) << 9U);
+                break;
+            case 42U: /* PALETTE_SOURCE */
+                ctx.palette_source = word & 0x3fffffU;
+                break;
+            case 43U: /* VERTEX_TRANSLATE_X */
+                ctx.translate_x = sign_extend(word, 17U);
+                break;
+            case 44U: /* VERTEX_TRANSLATE_Y */
+                ctx.translate_y = sign_extend(word, 17U);
+                break;
+            case 46U: /* BITMAP_EXT_FORMAT */
+                handle->ext_format = (uint16_t) word;
+                break;
+            default: /* MACRO, NOP, BITMAP_SWIZZLE, INT_FRR and unknown words do not change the image */
+                break;
+        }
+    }
+    strip_flush();
+}
+
+/*---- images ----------------------------------------------------------------------------------------------------------*/
+
+static uint8_t *rgb_image(void)
+{
+    uint32_t pixels = (uint32_t) width * (uint32_t) height;
+    uint8_t *rgb = xcalloc(pixels, 3U);
+
+    for (uint32_t index = 0U; index < pixels; index++)
+    {
+        rgb[index * 3U] = plane[0][index];
+        rgb[(index * 3U) + 1U] = plane[1][index];
+        rgb[(index * 3U) + 2U] = plane[2][index];
+    }
+    return rgb;
+}
+
+static void write_png(const char *path, const uint8_t *data, uint32_t format)
+{
+    png_image image;
+
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    image.width = (png_uint_32) width;
+    image.height = (png_uint_32) height;
+    image.format = format;
+#if defined (PNG_IMAGE_FLAG_FAST)
+    image.flags = PNG_IMAGE_FLAG_FAST;
+#endif
+    if (0 == png_image_write_to_file(&image, path, 0, data, 0, NULL))
+    {
+        fail("can not write %s", path);
+    }
+}
+
+/* the number of pixels that differ by more than tolerance in one channel, or -1 when the golden image does not fit */
+static int32_t compare(const char *golden, const uint8_t *rgb, uint32_t tolerance, const char *diff)
+{
+    png_image image;
+    uint8_t *expected;
+    uint8_t *marked = NULL;
+    int32_t count = 0;
+
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (0 == png_image_begin_read_from_file(&image, golden))
+    {
+        fprintf(stderr, "eve_render: can not read %s\n", golden);
+        return -1;
+    }
+    image.format = PNG_FORMAT_RGB;
+    expected = xcalloc(PNG_IMAGE_SIZE(image), 1U);
+    if ((0 == png_image_finish_read(&image, NULL, expected, 0, NULL)) || (image.width != (png_uint_32) width) ||
+        (image.height != (png_uint_32) height))
+    {
+        fprintf(stderr, "eve_render: %s is not a %dx%d image\n", golden, width, height);
+        free(expected);
+        return -1;
+    }
+    if (diff != NULL)
+    {
+        marked = xcalloc((size_t) width * (size_t) height, 3U);
+    }
+
+    for (uint32_t index = 0U; index < ((uint32_t) width * (uint32_t) height * 3U); index += 3U)
+    {
+        bool differs = false;
+
+        for (uint32_t channel = 0U; channel < 3U; channel++)
+        {
+            int32_t delta = (int32_t) rgb[index + channel] - (int32_t) expected[index + channel];
+
+            differs = differs || (abs(delta) > (int32_t) tolerance);
+        }
+        count += differs ? 1 : 0;
+        if (marked != NULL)
+        {
+            /* the differences in red on a dark copy of the golden image */
+            uint8_t grey = (uint8_t) (((uint32_t) expected[index] + expected[index + 1U] + expected[index + 2U]) / 12U);
+
+            marked[index] = differs ? 255U : grey;
+            marked[index + 1U] = differs ? 0U : grey;
+            marked[index + 2U] = differs ? 0U : grey;
+        }
+    }
+    if (marked != NULL)
+    {
+        write_png(diff, marked, PNG_FORMAT_RGB);
+        free(marked);
+    }
+    free(expected);
+    return count;
+}
+
+static void render(const char *path, bool hex)
+{
+    uint32_t length;
+    uint8_t *data = read_file(path, hex, &length);
+    uint32_t words[DL_WORDS];
+    uint32_t count = (length / 4U) < DL_WORDS ? (length / 4U) : DL_WORDS;
+
+    for (uint32_t index = 0U; index < count; index++)
+    {
+        words[index] = (uint32_t) data[index * 4U] | ((uint32_t) data[(index * 4U) + 1U] << 8U) |
+            ((uint32_t) data[(index * 4U) + 2U] << 16U) | ((uint32_t) data[(index * 4U) + 3U] << 24U);
+    }
+    free(data);
+
+    /* every display-list starts with the state after a reset, CLEAR decides what is left of the last frame */
+    for (uint32_t channel = 0U; channel < 4U; channel++)
+    {
+        memset(plane[channel], 0, (size_t) width * (size_t) height);
+    }
+    memset(stencil, 0, (size_t) width * (size_t) height);
+    memset(tags, 0, (size_t) width * (size_t) height);
+    reset_context();
+    reset_handles();
+    stack_depth = 0U;
+    primitive = 0U;
+    vertex_count = 0U;
+    strip_x0 = width;
+    strip_y0 = height;
+    strip_x1 = 0;
+    strip_y1 = 0;
+    execute(words, count);
+}
+
+static void report_warnings(const char *path)
+{
+    if (warnings_rom != 0U)
+    {
+        fprintf(stderr, "eve_render: %s: %u bitmaps of ROM fonts skipped, --memory has no ROM\n", path, warnings_rom);
+    }
+    if (warnings_flash != 0U)
+    {
+        fprintf(stderr, "eve_render: %s: %u bitmaps in flash skipped\n", path, warnings_flash);
+    }
+    if (warnings_format != 0U)
+    {
+        fprintf(stderr, "eve_render: %s: %u bitmaps in unsupported formats skipped\n", path, warnings_format);
+    }
+    if (warnings_dl != 0U)
+    {
+        fprintf(stderr, "eve_render: %s: %u stack over- or underflows of CALL or SAVE_CONTEXT\n", path, warnings_dl);
+    }
+    warnings_rom = 0U;
+    warnings_flash = 0U;
+    warnings_format = 0U;
+    warnings_dl = 0U;
+}
+
+static void usage(void)
+{
+    printf("usage: eve_render [options] [-o <out.png>] <dl>\n"
+           "       eve_render [options] --out-dir <dir> [--golden-dir <dir>] <dl> <dl> ...\n"
+           "  --hex               the display-list is text with hex words instead of binary\n"
+           "  --size <w>x<h>      size of the screen, default: %ux%u\n"
+           "  --memory <file>     memory of EVE from address 0 for the bitmaps, 3 MiB with the ROM fonts\n"
+           "  -o <out.png>        the image, default: <dl>.png\n"
+           "  --tag <tag.png>     the tag buffer as greyscale image\n"
+           "  --golden <png>      compare with a golden image, exits with 1 when it differs\n"
+           "  --diff <png>        marks the pixels that differ from the golden image in red\n"
+           "  --tolerance <n>     difference of a channel that is still the same, default: 0\n"
+           "  --max-pixels <n>    number of pixels that may differ, default: 0\n"
+           "  --out-dir <dir>     render every display-list to <dir>/<name>.png\n"
+           "  --golden-dir <dir>  compare every image with <dir>/<name>.png\n",
+        (unsigned int) EVE_HSIZE, (unsigned int) EVE_VSIZE);
+    exit(EXIT_SUCCESS);
+}
+
+static const char *base_name(const char *path, char *name, size_t size)
+{
+    const char *base = strrchr(path, '/');
+    char *dot;
+
+    snprintf(name, size, "%s", (base != NULL) ? &base[1] : path);
+    dot = strrchr(name, '.');
+    if (dot != NULL)
+    {
+        *dot = '\0';
+    }
+    return name;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *inputs[1024];
+    uint32_t input_count = 0U;
+    const char *out = NULL;
+    const char *tag_out = NULL;
+    const char *golden = NULL;
+    const char *diff = NULL;
+    const char *out_dir = NULL;
+    const char *golden_dir = NULL;
+    uint32_t tolerance = 0U;
+    int32_t max_pixels = 0;
+    uint32_t failed = 0U;
+    bool hex = false;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        bool value = ((arg + 1) < argc);
+
+        if (0 == strcmp(argv[arg], "--hex"))
+        {
+            hex = true;
+        }
+        else if ((0 == strcmp(argv[arg], "--size")) && value)
+        {
+            if ((2 != sscanf(argv[++arg], "%dx%d", &width, &height)) || (width <= 0) || (width > WIDTH_MAX) ||
+                (height <= 0) || (height > 2048))
+            {
+                fail("invalid size %s", argv[arg]);
+            }
+        }
+        else if ((0 == strcmp(argv[arg], "--memory")) && value)
+        {
+            uint8_t *data = read_file(argv[++arg], false, &memory_size);
+
+            memory = xcalloc(MEMORY_SIZE, 1U);
+            memory_size = (memory_size > MEMORY_SIZE) ? MEMORY_SIZE : memory_size;
+            memcpy(memory, data, memory_size);
+            free(data);
+        }
+        else if ((0 == strcmp(argv[arg], "-o")) && value)
+        {
+            out = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--tag")) && value)
+        {
+            tag_out = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--golden")) && value)
+        {
+            golden = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--diff")) && value)
+        {
+            diff = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--tolerance")) && value)
+        {
+            tolerance = (uint32_t) strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[arg], "--max-pixels")) && value)
+        {
+            max_pixels = (int32_t) strtol(argv[++arg], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[arg], "--out-dir")) && value)
+        {
+            out_dir = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--golden-dir")) && value)
+        {
+            golden_dir = argv[++arg];
+        }
+        else if ((argv[arg][0] == '-') || (input_count >= (sizeof(inputs) / sizeof(inputs[0]))))
+        {
+            usage();
+        }
+        else
+        {
+            inputs[input_count++] = argv[arg];
+        }
+    }
+    if ((0U == input_count) || ((input_count > 1U) && (NULL == out_dir)))
+    {
+        usage();
+    }
+
+    for (uint32_t channel = 0U; channel < 4U; channel++)
+    {
+        plane[channel] = xcalloc((size_t) width * (size_t) height, 1U);
+    }
+    stencil = xcalloc((size_t) width * (size_t) height, 1U);
+    tags = xcalloc((size_t) width * (size_t) height, 1U);
+    strip = xcalloc((size_t) width * (size_t) height, 1U);
+
+    for (uint32_t input = 0U; input < input_count; input++)
+    {
+        char name[256];
+        char image_path[1024];
+        char golden_path[1024];
+        const char *expected = golden;
+        uint8_t *rgb;
+
+        base_name(inputs[input], name, sizeof(name));
+        if (out_dir != NULL)
+        {
+            snprintf(image_path, sizeof(image_path), "%s/%s.png", out_dir, name);
+        }
+        else
+        {
+            snprintf(image_path, sizeof(image_path), "%s", (out != NULL) ? out : name);
+            if (NULL == out)
+            {
+                strncat(image_path, ".png", sizeof(image_path) - strlen(image_path) - 1U);
+            }
+        }
+        if (golden_dir != NULL)
+        {
+            snprintf(golden_path, sizeof(golden_path), "%s/%s.png", golden_dir, name);
+            expected = golden_path;
+        }
+
+        render(inputs[input], hex);
+        report_warnings(inputs[input]);
+        rgb = rgb_image();
+        write_png(image_path, rgb, PNG_FORMAT_RGB);
+        if (tag_out != NULL)
+        {
+            write_png(tag_out, tags, PNG_FORMAT_GRAY);
+        }
+        if (expected != NULL)
+        {
+            int32_t count = compare(expected, rgb, tolerance, (1U == input_count) ? diff : NULL);
+
+            if ((count < 0) || (count > max_pixels))
+            {
+                if (count > 0)
+                {
+                    fprintf(stderr, "eve_render: %s: %d pixels differ from %s\n", inputs[input], count, expected);
+                }
+                failed++;
+            }
+        }
+        free(rgb);
+    }
+
+    if ((golden != NULL) || (golden_dir != NULL))
+    {
+        printf("%u of %u screens differ\n", failed, input_count);
+    }
+    return (0U == failed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,603 @@
+/*
+@file    eve_replay.c
+@brief   decodes a trace of EVE_trace.c and replays it thru a Linux spidev device
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+@section Usage
+
+eve_replay [--spidev <device>] [--speed <hz>] [--chunk <bytes>] [--tick-us <us>] [--fast] [--partial] [--quiet] trace.bin
+
+Without --spidev the trace is only decoded, one line per transaction.
+With --spidev the transactions are sent again to an EVE connected to the device, for example /dev/spidev0.0 on a Raspberry Pi.
+The pauses between the transactions are restored from the timestamps, --tick-us is the time of one EVE_TRACE_TIME() tick.
+Reads are compared with the recorded data.
+The replay is exact when the trace was recorded with EVE_TRACE_FULL and the ring buffer did not overwrite the start,
+then every write is sent again byte for byte. Otherwise the trace is checked before anything is sent and the replay
+is refused with exit code 1. --partial replays only the complete transactions anyway, the exit code stays 1.
+Transactions longer than --chunk are sent in parts, each with its own address, as spidev limits the size of a transfer.
+
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <linux/spi/spidev.h>
+
+#include "EVE_trace.h"
+
+#define CHUNK_DEFAULT 4096U /* the default bufsiz of the spidev driver */
+
+typedef struct
+{
+    uint32_t time;
+    uint32_t length;  /* length of the transaction */
+    uint32_t count;   /* bytes recorded */
+    uint8_t *data;
+    uint8_t *raw;     /* the frame as read, data points into it */
+    uint32_t size;    /* bytes allocated for raw */
+} frame_t;
+
+typedef struct
+{
+    uint32_t address;
+    const char *name;
+} reg_name_t;
+
+static const reg_name_t reg_names[] =
+{
+    {REG_ID, "REG_ID"},
+    {REG_FRAMES, "REG_FRAMES"},
+    {REG_CLOCK, "REG_CLOCK"},
+    {REG_FREQUENCY, "REG_FREQUENCY"},
+    {REG_CPURESET, "REG_CPURESET"},
+    {REG_DLSWAP, "REG_DLSWAP"},
+    {REG_PCLK, "REG_PCLK"},
+    {REG_GPIO, "REG_GPIO"},
+    {REG_GPIOX, "REG_GPIOX"},
+    {REG_PWM_DUTY, "REG_PWM_DUTY"},
+    {REG_TOUCH_TAG, "REG_TOUCH_TAG"},
+    {REG_CMD_READ, "REG_CMD_READ"},
+    {REG_CMD_WRITE, "REG_CMD_WRITE"},
+    {REG_CMD_DL, "REG_CMD_DL"},
+    {REG_CMDB_SPACE, "REG_CMDB_SPACE"},
+    {REG_CMDB_WRITE, "REG_CMDB_WRITE"},
+    {REG_MEDIAFIFO_READ, "REG_MEDIAFIFO_READ"},
+    {REG_MEDIAFIFO_WRITE, "REG_MEDIAFIFO_WRITE"},
+#if EVE_GEN > 2
+    {REG_FLASH_STATUS, "REG_FLASH_STATUS"},
+    {REG_COPRO_PATCH_DTR, "REG_COPRO_PATCH_DTR"},
+#endif
+#if EVE_GEN > 3
+    {REG_ANIM_ACTIVE, "REG_ANIM_ACTIVE"},
+#endif
+};
+
+static const char *host_command_name(uint8_t command)
+{
+    switch (command)
+    {
+        case 0x00U:
+            return "ACTIVE";
+        case 0x41U:
+            return "STANDBY";
+        case 0x42U:
+            return "SLEEP";
+        case 0x44U:
+            return "CLKEXT";
+        case 0x48U:
+            return "CLKINT";
+        case 0x49U:
+            return "PD_ROMS";
+        case 0x50U:
+            return "PWRDOWN";
+        case 0x61U:
+            return "CLKSEL";
+        case 0x62U:
+            return "CLKSEL2";
+        case 0x68U:
+            return "RST_PULSE";
+        case 0x70U:
+            return "PINDRIVE";
+        case 0x71U:
+            return "PIN_PD_STATE";
+        default:
+            return "HOST_CMD";
+    }
+}
+
+static void address_name(char *dst, size_t size, uint32_t address)
+{
+    for (size_t index = 0U; index < (sizeof(reg_names) / sizeof(reg_names[0])); index++)
+    {
+        if (reg_names[index].address == address)
+        {
+            snprintf(dst, size, "%s", reg_names[index].name);
+            return;
+        }
+    }
+    if (address >= EVE_RAM_CMD)
+    {
+        snprintf(dst, size, "RAM_CMD+0x%x", (uint32_t) (address - EVE_RAM_CMD));
+    }
+    else if (address >= EVE_RAM_REG)
+    {
+        snprintf(dst, size, "RAM_REG+0x%x", (uint32_t) (address - EVE_RAM_REG));
+    }
+    else if (address >= EVE_RAM_DL)
+    {
+        snprintf(dst, size, "RAM_DL+0x%x", (uint32_t) (address - EVE_RAM_DL));
+    }
+    else
+    {
+        snprintf(dst, size, "RAM_G+0x%x", address);
+    }
+}
+
+/* reads the next frame, the bytes before the first flag are the rest of a frame that was overwritten in the ring buffer */
+/* and are counted in lost */
+static bool read_frame(FILE *file, frame_t *frame, uint32_t *lost)
+{
+    uint32_t count = 0U;
+    bool escape = false;
+    int data;
+
+    for ( ; ; )
+    {
+        data = fgetc(file);
+        if (EOF == data)
+        {
+            return false;
+        }
+        if (EVE_TRACE_FLAG == data)
+        {
+            break;
+        }
+        (*lost)++;
+    }
+
+    for ( ; ; )
+    {
+        data = fgetc(file);
+        if (EVE_TRACE_FLAG == data)
+        {
+            (void) ungetc(data, file);
+            break;
+        }
+        if (EOF == data)
+        {
+            break;
+        }
+        if (EVE_TRACE_ESCAPE == data)
+        {
+            escape = true;
+            continue;
+        }
+        if (escape)
+        {
+            data ^= EVE_TRACE_XOR;
+            escape = false;
+        }
+        if (count >= frame->size)
+        {
+            frame->size = (0U == frame->size) ? 4096U : (frame->size * 2U);
+            frame->raw = realloc(frame->raw, frame->size);
+            if (NULL == frame->raw)
+            {
+                fprintf(stderr, "eve_replay: out of memory\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        frame->raw[count] = (uint8_t) data;
+        count++;
+    }
+
+    if (count < 8U)
+    {
+        frame->count = 0U; /* broken frame */
+        frame->length = 0U;
+        return true;
+    }
+    const uint8_t *raw = frame->raw;
+
+    frame->time = raw[0] | ((uint32_t) raw[1] << 8U) | ((uint32_t) raw[2] << 16U) | ((uint32_t) raw[3] << 24U);
+    frame->length = raw[count - 4U] | ((uint32_t) raw[count - 3U] << 8U) | ((uint32_t) raw[count - 2U] << 16U) |
+        ((uint32_t) raw[count - 1U] << 24U);
+    frame->count = count - 8U;
+    frame->data = &frame->raw[4];
+    if ((frame->count > frame->length) || ((frame->count < frame->length) && (frame->count < 3U)))
+    {
+        frame->count = 0U; /* the length does not fit, e.g. the transfer was not finished when the trace was dumped */
+        frame->length = 0U;
+    }
+    return true;
+}
+
+static void print_frame(const frame_t *frame)
+{
+    const uint8_t *data = frame->data;
+    uint32_t start = 3U;
+    char name[64];
+
+    printf("%10u ", frame->time);
+    if (0U == (data[0] & 0xc0U))
+    {
+        address_name(name, sizeof(name), ((uint32_t) data[0] << 16U) | ((uint32_t) data[1] << 8U) | data[2]);
+        if (frame->length < 4U)
+        {
+            printf("host    ACTIVE");
+        }
+        else
+        {
+            printf("read    %-24s %5u:", name, frame->length - 4U);
+            start = 4U; /* skip the dummy byte */
+        }
+    }
+    else if (0U == (data[0] & 0x80U))
+    {
+        printf("host    %s 0x%02x", host_command_name(data[0]), data[1]);
+        start = frame->count;
+    }
+    else
+    {
+        address_name(name, sizeof(name), ((uint32_t) (data[0] & 0x3fU) << 16U) | ((uint32_t) data[1] << 8U) | data[2]);
+        printf("write   %-24s %5u:", name, frame->length - 3U);
+    }
+    for (uint32_t index = start; index < frame->count; index++)
+    {
+        printf(" %02x", data[index]);
+    }
+    if (frame->count < frame->length)
+    {
+        printf(" ...");
+    }
+    printf("\n");
+}
+
+static uint64_t now_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec * 1000000U) + ((uint64_t) now.tv_nsec / 1000U);
+}
+
+static bool is_write(const frame_t *frame)
+{
+    return ((frame->data[0] & 0xc0U) != 0U);
+}
+
+static void transfer(int spi, uint32_t speed, const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+    struct spi_ioc_transfer message;
+
+    memset(&message, 0, sizeof(message));
+    message.tx_buf = (uintptr_t) tx;
+    message.rx_buf = (uintptr_t) rx;
+    message.len = len;
+    message.speed_hz = speed;
+    message.bits_per_word = 8U;
+    if (ioctl(spi, SPI_IOC_MESSAGE(1), &message) < 0)
+    {
+        fprintf(stderr, "eve_replay: SPI transfer failed: %s\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* the address for a part of a transaction, REG_CMDB_WRITE is a FIFO and keeps its address, RAM_CMD wraps around */
+static uint32_t chunk_address(uint32_t address, uint32_t offset)
+{
+    if (REG_CMDB_WRITE == address)
+    {
+        return address;
+    }
+    if ((address >= EVE_RAM_CMD) && (address < (EVE_RAM_CMD + 4096UL)))
+    {
+        return EVE_RAM_CMD + (((address - EVE_RAM_CMD) + offset) & 4095UL);
+    }
+    return address + offset;
+}
+
+/* sends a complete transaction again, returns the number of bytes read that differ from the recorded ones */
+/* transactions that do not fit into one transfer of spidev are split, every part gets the address it continues at, */
+/* the parts of writes are a multiple of 4 bytes so that no command for REG_CMDB_WRITE is split */
+static uint32_t replay_frame(int spi, uint32_t speed, uint32_t chunk, const frame_t *frame)
+{
+    static uint8_t *tx;
+    static uint8_t *rx;
+    static uint32_t size;
+    uint32_t errors = 0U;
+    bool read = (!is_write(frame)) && (frame->length > 3U);
+    uint32_t header = read ? 4U : 3U; /* reads have a dummy byte after the address */
+    uint32_t address = ((uint32_t) (frame->data[0] & 0x3fU) << 16U) | ((uint32_t) frame->data[1] << 8U) | frame->data[2];
+    uint32_t part = (chunk - header) & ~3UL;
+    uint32_t offset = 0U;
+
+    if (size < chunk)
+    {
+        size = chunk;
+        tx = realloc(tx, size);
+        rx = realloc(rx, size);
+        if ((NULL == tx) || (NULL == rx))
+        {
+            fprintf(stderr, "eve_replay: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if ((frame->length <= chunk) || (frame->length <= 3U) || ((frame->data[0] & 0xc0U) == 0x40U))
+    {
+        memcpy(tx, frame->data, frame->length);
+        if (read)
+        {
+            memset(&tx[3], 0, frame->length - 3U); /* reads send zero after the address */
+        }
+        transfer(spi, speed, tx, rx, frame->length);
+        for (uint32_t index = 4U; read && (index < frame->length); index++)
+        {
+            errors += (rx[index] != frame->data[index]) ? 1U : 0U;
+        }
+        return errors;
+    }
+
+    while (offset < (frame->length - header))
+    {
+        uint32_t start = chunk_address(address, offset);
+        uint32_t len = frame->length - header - offset;
+
+        len = (len > part) ? part : len;
+        tx[0] = (uint8_t) ((start >> 16U) | (frame->data[0] & 0xc0U));
+        tx[1] = (uint8_t) (start >> 8U);
+        tx[2] = (uint8_t) start;
+        tx[3] = 0U;
+        if (read)
+        {
+            memset(&tx[4], 0, len);
+        }
+        else
+        {
+            memcpy(&tx[3], &frame->data[3U + offset], len);
+        }
+        transfer(spi, speed, tx, rx, header + len);
+        for (uint32_t index = 0U; read && (index < len); index++)
+        {
+            errors += (rx[4U + index] != frame->data[4U + offset + index]) ? 1U : 0U;
+        }
+        offset += len;
+    }
+    return errors;
+}
+
+static void usage(void)
+{
+    printf("usage: eve_replay [--spidev <device>] [--speed <hz>] [--chunk <bytes>] [--tick-us <us>] [--fast] [--partial]\n"
+           "                  [--quiet] trace.bin\n"
+           "  --spidev <device>  replay the trace thru the device, e.g. /dev/spidev0.0, default: only decode\n"
+           "  --speed <hz>       SPI clock for the replay, default: 8000000\n"
+           "  --chunk <bytes>    longest transfer of spidev, see /sys/module/spidev/parameters/bufsiz, default: %u\n"
+           "  --tick-us <us>     time of one timestamp tick, default: 1000 for a millisecond counter\n"
+           "  --fast             replay without the pauses between the transactions\n"
+           "  --partial          replay a trace that is not complete anyway, only the complete transactions are sent\n"
+           "  --quiet            do not print the transactions\n", CHUNK_DEFAULT);
+    exit(EXIT_SUCCESS);
+}
+
+/* checks the whole trace before anything is sent, returns true when every transaction can be sent again as recorded */
+static bool check_trace(FILE *file, frame_t *frame)
+{
+    uint32_t lost = 0U;
+    uint32_t broken = 0U;
+    uint32_t cut = 0U;
+
+    while (read_frame(file, frame, &lost))
+    {
+        if (0U == frame->count)
+        {
+            broken++;
+        }
+        else if (frame->count < frame->length)
+        {
+            cut++;
+        }
+        else
+        {
+            /* complete */
+        }
+    }
+    rewind(file);
+
+    if (lost != 0U)
+    {
+        fprintf(stderr, "eve_replay: error, the ring buffer overwrote the start of the trace, %u bytes of a transaction "
+            "are left, a larger EVE_TRACE_SIZE keeps everything from EVE_init() on\n", lost);
+    }
+    if (broken != 0U)
+    {
+        fprintf(stderr, "eve_replay: error, %u transactions are broken\n", broken);
+    }
+    if (cut != 0U)
+    {
+        fprintf(stderr, "eve_replay: error, %u transactions were cut off by EVE_TRACE_PAYLOAD_MAX, "
+            "record with EVE_TRACE_FULL to replay them\n", cut);
+    }
+    return (0U == lost) && (0U == broken) && (0U == cut);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *device = NULL;
+    const char *path = NULL;
+    uint32_t speed = 8000000U;
+    uint32_t chunk = CHUNK_DEFAULT;
+    uint32_t tick_us = 1000U;
+    bool fast = false;
+    bool partial = false;
+    bool quiet = false;
+    bool complete;
+    static frame_t frame;
+    uint32_t frames = 0U;
+    uint32_t lost = 0U;
+    uint32_t broken = 0U;
+    uint32_t skipped = 0U;
+    uint32_t mismatches = 0U;
+    bool first = true;
+    uint32_t first_time = 0U;
+    uint64_t start_us = 0U;
+    int spi = -1;
+    FILE *file;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "--spidev")) && ((arg + 1) < argc))
+        {
+            device = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--speed")) && ((arg + 1) < argc))
+        {
+            speed = (uint32_t) strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[arg], "--chunk")) && ((arg + 1) < argc))
+        {
+            chunk = (uint32_t) strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[arg], "--tick-us")) && ((arg + 1) < argc))
+        {
+            tick_us = (uint32_t) strtoul(argv[++arg], NULL, 0);
+        }
+        else if (0 == strcmp(argv[arg], "--fast"))
+        {
+            fast = true;
+        }
+        else if (0 == strcmp(argv[arg], "--partial"))
+        {
+            partial = true;
+        }
+        else if (0 == strcmp(argv[arg], "--quiet"))
+        {
+            quiet = true;
+        }
+        else if (argv[arg][0] == '-')
+        {
+            usage();
+        }
+        else
+        {
+            path = argv[arg];
+        }
+    }
+    if ((NULL == path) || (chunk < 64U))
+    {
+        usage();
+    }
+
+    file = fopen(path, "rb");
+    if (NULL == file)
+    {
+        fprintf(stderr, "eve_replay: can not open %s\n", path);
+        return EXIT_FAILURE;
+    }
+    complete = check_trace(file, &frame);
+    if ((device != NULL) && (!complete) && (!partial))
+    {
+        fprintf(stderr, "eve_replay: the trace can not be replayed exactly, nothing was sent, --partial sends the "
+            "complete transactions anyway\n");
+        fclose(file);
+        return EXIT_FAILURE;
+    }
+    if (device != NULL)
+    {
+        uint8_t mode = SPI_MODE_0;
+
+        spi = open(device, O_RDWR);
+        if ((spi < 0) || (ioctl(spi, SPI_IOC_WR_MODE, &mode) < 0))
+        {
+            fprintf(stderr, "eve_replay: can not use %s\n", device);
+            return EXIT_FAILURE;
+        }
+    }
+
+    while (read_frame(file, &frame, &lost))
+    {
+        if (0U == frame.count)
+        {
+            broken++;
+            continue;
+        }
+        frames++;
+        if (!quiet)
+        {
+            print_frame(&frame);
+        }
+        if (spi < 0)
+        {
+            continue;
+        }
+        if (frame.count < frame.length)
+        {
+            skipped++; /* only with --partial, writes need all the data and reads need it to compare */
+            continue;
+        }
+        if (first)
+        {
+            first = false;
+            first_time = frame.time;
+            start_us = now_us();
+        }
+        else if (!fast)
+        {
+            uint64_t target = start_us + ((uint64_t) (frame.time - first_time) * tick_us);
+            uint64_t current = now_us();
+
+            if (target > current)
+            {
+                usleep((useconds_t) (target - current));
+            }
+        }
+        mismatches += replay_frame(spi, speed, chunk, &frame);
+    }
+
+    fclose(file);
+    free(frame.raw);
+    if (spi >= 0)
+    {
+        close(spi);
+    }
+    fprintf(stderr, "eve_replay: %u transactions, %u broken, %u skipped", frames, broken, skipped);
+    if (spi >= 0)
+    {
+        fprintf(stderr, ", %u bytes read differ from the trace", mismatches);
+    }
+    fprintf(stderr, "\n");
+    return ((spi >= 0) && (!complete)) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,493 @@
+/*
+@file    eve_timeline.c
+@brief   converts a dump of EVE_events.c into the Chrome trace format for chrome://tracing and ui.perfetto.dev
+@version 5.0
+@date    2022-11-10
+@author  Rudolph Riedel
+
+@section LICENSE
+
+MIT License
+
+Copyright (c) 2016-2022 Rudolph Riedel
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+@section History
+
+5.0
+- initial version
+
+@section Usage
+
+eve_timeline [-o <file>] [--clock-hz <hz>] [--name <id>=<name>] events.bin
+
+The input is what EVE_events_dump() wrote, the output is JSON in the Chrome trace format, to stdout without -o.
+The events become slices on four tracks:
+- application: the sections of EVE_EVENT_USER_BEGIN / EVE_EVENT_USER_END, --name gives a section id a name
+- EVE_commands: building a burst and the waits of EVE_execute_cmd()
+- SPI: the DMA transfers and the chunks of block_transfer()
+- co-processor: from the data reaching the cmd-FIFO to EVE_busy() finding it empty, CMD_SWAP and faults as markers
+--clock-hz replaces the EVE_EVENTS_CLOCK_HZ from the dump, e.g. when EVE_EVENTS_TIME() counts something else.
+A summary with the number, the total and the longest time of each kind of slice goes to stderr.
+
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "EVE_events.h"
+
+#define NAME_MAX_COUNT 64U
+#define OPEN_MAX 64U
+
+typedef struct
+{
+    int64_t time;   /* ticks relative to the first event */
+    uint32_t order; /* position in the dump, keeps the order of events with the same time */
+    uint8_t type;
+    uint32_t argument;
+} event_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t count;
+    double total;
+    double max;
+} summary_t;
+
+enum
+{
+    TRACK_APPLICATION = 1,
+    TRACK_COMMANDS,
+    TRACK_SPI,
+    TRACK_COPRO
+};
+
+static const char *const track_names[] = {"", "application", "EVE_commands", "SPI", "co-processor"};
+
+static struct
+{
+    uint32_t id;
+    const char *name;
+} names[NAME_MAX_COUNT];
+static uint32_t name_count;
+
+static summary_t summaries[NAME_MAX_COUNT + 8U];
+static uint32_t summary_count;
+
+static FILE *out;
+static double tick_us;
+static bool first_record = true;
+
+static void fail(const char *fmt, const char *arg)
+{
+    fprintf(stderr, "eve_timeline: ");
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(EXIT_FAILURE);
+}
+
+static uint32_t get32(const uint8_t *data)
+{
+    return (uint32_t) data[0] | ((uint32_t) data[1] << 8U) | ((uint32_t) data[2] << 16U) | ((uint32_t) data[3] << 24U);
+}
+
+static int compare_events(const void *left, const void *right)
+{
+    const event_t *first = (const event_t *) left;
+    const event_t *second = (const event_t *) right;
+
+    if (first->time != second->time)
+    {
+        return (first->time < second->time) ? -1 : 1;
+    }
+    return (first->order < second->order) ? -1 : 1;
+}
+
+static void add_summary(const char *name, double duration)
+{
+    summary_t *summary = NULL;
+
+    for (uint32_t index = 0U; index < summary_count; index++)
+    {
+        if (0 == strcmp(summaries[index].name, name))
+        {
+            summary = &summaries[index];
+            break;
+        }
+    }
+    if (NULL == summary)
+    {
+        if (summary_count >= (sizeof(summaries) / sizeof(summaries[0])))
+        {
+            return;
+        }
+        summary = &summaries[summary_count++];
+        summary->name = name;
+    }
+    summary->count++;
+    summary->total += duration;
+    summary->max = (duration > summary->max) ? duration : summary->max;
+}
+
+static void record_begin(void)
+{
+    fprintf(out, "%s\n    ", first_record ? "" : ",");
+    first_record = false;
+}
+
+/* a slice from start to end on a track, args is the JSON of the arguments without braces or NULL */
+static void slice(const char *name, int track, int64_t start, int64_t end, const char *args)
+{
+    double duration = (double) (end - start) * tick_us;
+
+    record_begin();
+    fprintf(out, "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f", name, track,
+        (double) start * tick_us, duration);
+    if (args != NULL)
+    {
+        fprintf(out, ", \"args\": {%s}", args);
+    }
+    fprintf(out, "}");
+    add_summary(name, duration);
+}
+
+static void instant(const char *name, int track, int64_t time, const char *args)
+{
+    record_begin();
+    fprintf(out, "{\"name\": \"%s\", \"ph\": \"i\", \"s\": \"t\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f", name, track,
+        (double) time * tick_us);
+    if (args != NULL)
+    {
+        fprintf(out, ", \"args\": {%s}", args);
+    }
+    fprintf(out, "}");
+}
+
+static const char *section_name(uint32_t id)
+{
+    static char generated[NAME_MAX_COUNT][24];
+
+    for (uint32_t index = 0U; index < name_count; index++)
+    {
+        if (names[index].id == id)
+        {
+            return names[index].name;
+        }
+    }
+    /* the summary keeps the pointer, so every id gets its own buffer as long as there are buffers */
+    snprintf(generated[id % NAME_MAX_COUNT], sizeof(generated[0]), "section %u", id);
+    return generated[id % NAME_MAX_COUNT];
+}
+
+/* reads the dump, unwraps the timestamps of both rings and sorts the events by time */
+static event_t *read_events(const char *path, uint32_t *count, uint32_t *clock_hz)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t header[8];
+    uint8_t record[8];
+    event_t *events = NULL;
+    uint32_t capacity = 0U;
+    uint32_t used = 0U;
+    bool have_ref = false;
+    uint32_t ref = 0U;
+    bool ring_started[2] = {false, false};
+    uint32_t last_time[2] = {0U, 0U};
+    int64_t last_unwrapped[2] = {0, 0};
+
+    if (NULL == file)
+    {
+        fail("can not open %s", path);
+    }
+    if ((fread(header, 1U, sizeof(header), file) != sizeof(header)) || (memcmp(header, "EVEV", 4U) != 0))
+    {
+        fail("%s is not a dump of EVE_events_dump()", path);
+    }
+    *clock_hz = get32(&header[4]);
+
+    while (fread(record, 1U, sizeof(record), file) == sizeof(record))
+    {
+        uint32_t time = get32(record);
+        uint32_t word = get32(&record[4]);
+        uint32_t ring = (((word >> 24U) & EVE_EVENTS_IRQ) != 0U) ? 1U : 0U;
+        event_t *event;
+
+        if (used == capacity)
+        {
+            capacity = (0U == capacity) ? 1024U : (capacity * 2U);
+            events = realloc(events, capacity * sizeof(event_t));
+            if (NULL == events)
+            {
+                fail("%s", "out of memory");
+            }
+        }
+        if (!have_ref)
+        {
+            ref = time;
+            have_ref = true;
+        }
+        event = &events[used];
+        if (!ring_started[ring])
+        {
+            event->time = (int32_t) (time - ref); /* the first event of the other ring can be older */
+            ring_started[ring] = true;
+        }
+        else
+        {
+            event->time = last_unwrapped[ring] + (time - last_time[ring]); /* the counter wraps around */
+        }
+        last_time[ring] = time;
+        last_unwrapped[ring] = event->time;
+        event->order = used;
+        event->type = (uint8_t) ((word >> 24U) & (uint32_t) ~EVE_EVENTS_IRQ);
+        event->argument = word & 0x00ffffffU;
+        used++;
+    }
+    fclose(file);
+
+    qsort(events, used, sizeof(event_t), compare_events);
+    for (uint32_t index = 1U; index < used; index++)
+    {
+        events[index].time -= events[0].time;
+    }
+    if (used != 0U)
+    {
+        events[0].time = 0;
+    }
+    *count = used;
+    return events;
+}
+
+static void usage(void)
+{
+    printf("usage: eve_timeline [-o <file>] [--clock-hz <hz>] [--name <id>=<name>] events.bin\n"
+           "  -o <file>            output file, default: stdout\n"
+           "  --clock-hz <hz>      frequency of EVE_EVENTS_TIME(), default: the value from the dump\n"
+           "  --name <id>=<name>   name for the application section with the id, can be given more than once\n");
+    exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *input = NULL;
+    const char *output = NULL;
+    uint32_t clock_hz = 0U;
+    uint32_t clock_override = 0U;
+    uint32_t count = 0U;
+    uint32_t unknown = 0U;
+    event_t *events;
+    int64_t burst_start = -1;
+    int64_t wait_start = -1;
+    int64_t dma_start = -1;
+    int64_t block_start = -1;
+    int64_t copro_start = -1;
+    uint32_t dma_bytes = 0U;
+    uint32_t block_bytes = 0U;
+    struct
+    {
+        uint32_t id;
+        int64_t start;
+    } open_sections[OPEN_MAX];
+    uint32_t open_count = 0U;
+    char args[64];
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "-o")) && ((arg + 1) < argc))
+        {
+            output = argv[++arg];
+        }
+        else if ((0 == strcmp(argv[arg], "--clock-hz")) && ((arg + 1) < argc))
+        {
+            clock_override = (uint32_t) strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[arg], "--name")) && ((arg + 1) < argc))
+        {
+            char *separator = strchr(argv[++arg], '=');
+
+            if ((NULL == separator) || (name_count >= NAME_MAX_COUNT))
+            {
+                usage();
+            }
+            *separator = '\0';
+            names[name_count].id = (uint32_t) strtoul(argv[arg], NULL, 0);
+            names[name_count].name = &separator[1];
+            name_count++;
+        }
+        else if (argv[arg][0] == '-')
+        {
+            usage();
+        }
+        else
+        {
+            input = argv[arg];
+        }
+    }
+    if (NULL == input)
+    {
+        usage();
+    }
+
+    events = read_events(input, &count, &clock_hz);
+    if (clock_override != 0U)
+    {
+        clock_hz = clock_override;
+    }
+    if (0U == clock_hz)
+    {
+        fail("%s", "the clock is 0 Hz, use --clock-hz");
+    }
+    tick_us = 1000000.0 / (double) clock_hz;
+
+    out = (NULL == output) ? stdout : fopen(output, "w");
+    if (NULL == out)
+    {
+        fail("can not write %s", output);
+    }
+
+    fprintf(out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+    record_begin();
+    fprintf(out, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"EVE\"}}");
+    for (int track = TRACK_APPLICATION; track <= TRACK_COPRO; track++)
+    {
+        record_begin();
+        fprintf(out, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+            track, track_names[track]);
+        record_begin();
+        fprintf(out, "{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"sort_index\": %d}}",
+            track, track);
+    }
+
+    /* a slice is written when it ends, ends without a beginning are from before the oldest event in the dump */
+    for (uint32_t index = 0U; index < count; index++)
+    {
+        const event_t *event = &events[index];
+
+        switch (event->type)
+        {
+            case EVE_EVENT_BURST_BEGIN:
+                burst_start = event->time;
+                break;
+            case EVE_EVENT_BURST_END:
+                if (burst_start >= 0)
+                {
+                    slice("burst", TRACK_COMMANDS, burst_start, event->time, NULL);
+                    burst_start = -1;
+                }
+                copro_start = event->time; /* without DMA the burst is in the cmd-FIFO now */
+                break;
+            case EVE_EVENT_DMA_START:
+                dma_start = event->time;
+                dma_bytes = event->argument;
+                copro_start = -1; /* the co-processor gets the data with the end of the DMA */
+                break;
+            case EVE_EVENT_DMA_DONE:
+                if (dma_start >= 0)
+                {
+                    snprintf(args, sizeof(args), "\"bytes\": %u", dma_bytes);
+                    slice("DMA", TRACK_SPI, dma_start, event->time, args);
+                    dma_start = -1;
+                }
+                copro_start = event->time;
+                break;
+            case EVE_EVENT_WAIT_BEGIN:
+                wait_start = event->time;
+                break;
+            case EVE_EVENT_WAIT_END:
+                if (wait_start >= 0)
+                {
+                    snprintf(args, sizeof(args), "\"polls\": %u", event->argument);
+                    slice("wait", TRACK_COMMANDS, wait_start, event->time, args);
+                    wait_start = -1;
+                }
+                break;
+            case EVE_EVENT_BLOCK_BEGIN:
+                block_start = event->time;
+                block_bytes = event->argument;
+                break;
+            case EVE_EVENT_BLOCK_END:
+                if (block_start >= 0)
+                {
+                    snprintf(args, sizeof(args), "\"bytes\": %u", block_bytes);
+                    slice("block_transfer", TRACK_SPI, block_start, event->time, args);
+                    block_start = -1;
+                }
+                if (copro_start < 0)
+                {
+                    copro_start = event->time;
+                }
+                break;
+            case EVE_EVENT_IDLE:
+                if (copro_start >= 0)
+                {
+                    slice("execute", TRACK_COPRO, copro_start, event->time, NULL);
+                    copro_start = -1;
+                }
+                break;
+            case EVE_EVENT_SWAP:
+                instant("CMD_SWAP", TRACK_COPRO, event->time, NULL);
+                break;
+            case EVE_EVENT_FAULT:
+                snprintf(args, sizeof(args), "\"REG_CMDB_SPACE\": \"0x%03x\"", event->argument);
+                instant("fault", TRACK_COPRO, event->time, args);
+                copro_start = -1;
+                break;
+            case EVE_EVENT_USER_BEGIN:
+                if (open_count < OPEN_MAX)
+                {
+                    open_sections[open_count].id = event->argument;
+                    open_sections[open_count].start = event->time;
+                    open_count++;
+                }
+                break;
+            case EVE_EVENT_USER_END:
+                for (uint32_t open = open_count; open > 0U; open--)
+                {
+                    if (open_sections[open - 1U].id == event->argument)
+                    {
+                        slice(section_name(event->argument), TRACK_APPLICATION, open_sections[open - 1U].start,
+                            event->time, NULL);
+                        for (uint32_t next = open; next < open_count; next++)
+                        {
+                            open_sections[next - 1U] = open_sections[next];
+                        }
+                        open_count--;
+                        break;
+                    }
+                }
+                break;
+            default:
+                unknown++;
+                break;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+
+    fprintf(stderr, "%u events over %.3f ms, %u of an unknown type\n", count,
+        (count != 0U) ? ((double) events[count - 1U].time * tick_us / 1000.0) : 0.0, unknown);
+    for (uint32_t index = 0U; index < summary_count; index++)
+    {
+        fprintf(stderr, "%-16s %6u x, total %10.1f us, max %8.1f us\n", summaries[index].name, summaries[index].count,
+            summaries[index].total, summaries[index].max);
+    }
+    free(events);
+    return EXIT_SUCCESS;
+}